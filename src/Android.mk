@@ -11,6 +11,7 @@ LOCAL_SRC_FILES :=      am_map.c \
                         d_clisrv.c \
                         d_main.c \
                         d_net.c \
+                        d_netbench.c \
                         d_netcmd.c \
                         d_netfil.c \
                         dehacked.c \
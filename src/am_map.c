@@ -1089,6 +1089,7 @@ static inline void AM_drawThings(UINT8 colors)
 {
 	size_t i;
 	mobj_t *t;
+	collectible_t *rec;
 
 	for (i = 0; i < numsectors; i++)
 	{
@@ -1098,6 +1099,9 @@ static inline void AM_drawThings(UINT8 colors)
 			AM_drawLineCharacter(thintriangle_guy, NUMTHINTRIANGLEGUYLINES, 16<<FRACBITS, t->angle, colors, t->x, t->y);
 			t = t->snext;
 		}
+
+		for (rec = sectors[i].collectiblelist; rec; rec = rec->snext)
+			AM_drawLineCharacter(thintriangle_guy, NUMTHINTRIANGLEGUYLINES, 16<<FRACBITS, rec->angle, colors, rec->x, rec->y);
 	}
 }
 
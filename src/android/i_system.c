@@ -19,6 +19,7 @@
 UINT8 graphics_started = 0;
 
 UINT8 keyboard_started = 0;
+boolean quieterror = false;
 
 static INT64 start_time; // as microseconds since the epoch
 
@@ -14,6 +14,14 @@
 #ifdef __GNUC__
 #include <unistd.h> //for unlink
 #endif
+#if defined (__linux__) && !defined (NONET)
+#define SAVEFORK // see SV_ForkSaveGame
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <dirent.h>
+#include <sys/wait.h>
+#endif
 
 #include "i_net.h"
 #include "i_system.h"
@@ -28,6 +36,7 @@
 #include "m_menu.h"
 #include "console.h"
 #include "d_netfil.h"
+#include "d_netbench.h"
 #include "byteptr.h"
 #include "p_saveg.h"
 #include "z_zone.h"
@@ -41,6 +50,9 @@
 #include "m_argv.h"
 #include "p_setup.h"
 #include "lzf.h"
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 #include "lua_script.h"
 #include "lua_hook.h"
 #include "md5.h"
@@ -162,30 +174,145 @@ consvar_t cv_showjoinaddress = {"showjoinaddress", "Off", CV_SAVE, CV_OnOff, NUL
 static CV_PossibleValue_t playbackspeed_cons_t[] = {{1, "MIN"}, {10, "MAX"}, {0, NULL}};
 consvar_t cv_playbackspeed = {"playbackspeed", "1", 0, playbackspeed_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-static inline void *G_DcpyTiccmd(void* dest, const ticcmd_t* src, const size_t n)
+// Delta-encoded ticcmds
+// A ticcmd is written against a base ticcmd: one byte flagging
+// the fields that differ, followed by those fields only.
+// Angles are sent as zigzagged differences and the buttons as they are,
+// all of them as varints, 7 bits per byte.
+
+#define TD_FORWARDMOVE 0x01
+#define TD_SIDEMOVE    0x02
+#define TD_ANGLETURN   0x04
+#define TD_AIMING      0x08
+#define TD_BUTTONS     0x10
+
+#define MAXTICCMDDELTASIZE (1 + 1 + 1 + 3 + 3 + 3)
+
+static const ticcmd_t emptyticcmd;
+
+static UINT8 *WriteVarUINT16(UINT8 *p, UINT16 v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = (UINT8)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (UINT8)v;
+	return p;
+}
+
+static UINT8 *ReadVarUINT16(UINT8 *p, const UINT8 *end, UINT16 *v)
 {
-	const size_t d = n / sizeof(ticcmd_t);
-	const size_t r = n % sizeof(ticcmd_t);
-	UINT8 *ret = dest;
+	UINT32 r = 0;
+	INT32 shift;
 
-	if (r)
-		M_Memcpy(dest, src, n);
-	else if (d)
-		G_MoveTiccmd(dest, src, d);
-	return ret+n;
+	for (shift = 0; shift < 21; shift += 7)
+	{
+		if (p >= end)
+			return NULL;
+		r |= (UINT32)(*p & 0x7F) << shift;
+		if (!(*p++ & 0x80))
+		{
+			*v = (UINT16)r;
+			return p;
+		}
+	}
+	return NULL;
 }
 
-static inline void *G_ScpyTiccmd(ticcmd_t* dest, void* src, const size_t n)
+static inline UINT16 ZigZagINT16(INT16 d)
 {
-	const size_t d = n / sizeof(ticcmd_t);
-	const size_t r = n % sizeof(ticcmd_t);
-	UINT8 *ret = src;
+	return (UINT16)(((UINT16)d << 1) ^ (UINT16)(d < 0 ? 0xFFFF : 0));
+}
 
-	if (r)
-		M_Memcpy(dest, src, n);
-	else if (d)
-		G_MoveTiccmd(dest, src, d);
-	return ret+n;
+static inline INT16 UnZigZagINT16(UINT16 z)
+{
+	return (INT16)((z >> 1) ^ (UINT16)(z & 1 ? 0xFFFF : 0));
+}
+
+UINT8 *WriteTiccmdDelta(UINT8 *p, const ticcmd_t *cmd, const ticcmd_t *base)
+{
+	UINT8 *mask = p++;
+
+	*mask = 0;
+	if (cmd->forwardmove != base->forwardmove)
+	{
+		*mask |= TD_FORWARDMOVE;
+		WRITESINT8(p, cmd->forwardmove);
+	}
+	if (cmd->sidemove != base->sidemove)
+	{
+		*mask |= TD_SIDEMOVE;
+		WRITESINT8(p, cmd->sidemove);
+	}
+	if (cmd->angleturn != base->angleturn)
+	{
+		*mask |= TD_ANGLETURN;
+		p = WriteVarUINT16(p, ZigZagINT16((INT16)(cmd->angleturn - base->angleturn)));
+	}
+	if (cmd->aiming != base->aiming)
+	{
+		*mask |= TD_AIMING;
+		p = WriteVarUINT16(p, ZigZagINT16((INT16)(cmd->aiming - base->aiming)));
+	}
+	if (cmd->buttons != base->buttons)
+	{
+		*mask |= TD_BUTTONS;
+		p = WriteVarUINT16(p, cmd->buttons);
+	}
+	return p;
+}
+
+// Returns NULL if the ticcmd runs past the end of the packet
+static UINT8 *ReadTiccmdDelta(UINT8 *p, const UINT8 *end, ticcmd_t *cmd, const ticcmd_t *base)
+{
+	UINT8 mask;
+	UINT16 v;
+
+	if (p >= end)
+		return NULL;
+	mask = *p++;
+	if (mask & ~(TD_FORWARDMOVE|TD_SIDEMOVE|TD_ANGLETURN|TD_AIMING|TD_BUTTONS))
+		return NULL;
+
+	*cmd = *base;
+	if (mask & TD_FORWARDMOVE)
+	{
+		if (p >= end)
+			return NULL;
+		cmd->forwardmove = READSINT8(p);
+	}
+	if (mask & TD_SIDEMOVE)
+	{
+		if (p >= end)
+			return NULL;
+		cmd->sidemove = READSINT8(p);
+	}
+	if (mask & TD_ANGLETURN)
+	{
+		if (!(p = ReadVarUINT16(p, end, &v)))
+			return NULL;
+		cmd->angleturn = (INT16)(base->angleturn + UnZigZagINT16(v));
+	}
+	if (mask & TD_AIMING)
+	{
+		if (!(p = ReadVarUINT16(p, end, &v)))
+			return NULL;
+		cmd->aiming = (INT16)(base->aiming + UnZigZagINT16(v));
+	}
+	if (mask & TD_BUTTONS)
+	{
+		if (!(p = ReadVarUINT16(p, end, &v)))
+			return NULL;
+		cmd->buttons = v;
+	}
+	return p;
+}
+
+static size_t TiccmdDeltaSize(const ticcmd_t *cmd, const ticcmd_t *base)
+{
+	UINT8 buf[MAXTICCMDDELTASIZE];
+	return WriteTiccmdDelta(buf, cmd, base) - buf;
 }
 
 
@@ -216,6 +343,17 @@ tic_t ExpandTics(INT32 low, INT32 node)
 		return (nettics[node] & ~UINT8_MAX) + 256 + low;
 }
 
+/** Gets the consistancy value this machine computed for a tic
+  *
+  * \param tic The tic, must be one of the last BACKUPTICS ones
+  * \return The value a client in synch would send for that tic
+  *
+  */
+INT16 SV_GetConsistancy(tic_t tic)
+{
+	return consistancy[tic%BACKUPTICS];
+}
+
 // -----------------------------------------------------------------
 // Some extra data function for handle textcmd buffer
 // -----------------------------------------------------------------
@@ -1110,6 +1248,7 @@ static INT16 Consistancy(void);
 typedef enum
 {
 	CL_SEARCHING,
+	CL_DOWNLOADHTTPFILES,
 	CL_DOWNLOADFILES,
 	CL_ASKJOIN,
 	CL_WAITJOINRESPONSE,
@@ -1122,6 +1261,11 @@ static void GetPackets(void);
 
 static cl_mode_t cl_mode = CL_SEARCHING;
 
+#if defined (HAVE_CURL) && !defined (NONET)
+// The files the HTTP source couldn't give us are downloaded from the server
+static boolean httpdownloadfailed = false;
+#endif
+
 // Player name send/load
 
 static void CV_SavePlayerNames(UINT8 **p)
@@ -1671,7 +1815,7 @@ static inline void CL_DrawConnectionStatus(void)
 	M_DrawTextBox(BASEVIDWIDTH/2-128-8, BASEVIDHEIGHT-16-8, 32, 1);
 	V_DrawCenteredString(BASEVIDWIDTH/2, BASEVIDHEIGHT-16-16, V_YELLOWMAP, "Press ESC to abort");
 
-	if (cl_mode != CL_DOWNLOADFILES)
+	if (cl_mode != CL_DOWNLOADFILES && cl_mode != CL_DOWNLOADHTTPFILES)
 	{
 		INT32 i, animtime = ((ccstime / 4) & 15) + 16;
 		UINT8 palstart = (cl_mode == CL_SEARCHING) ? 32 : 96;
@@ -1727,10 +1871,16 @@ static inline void CL_DrawConnectionStatus(void)
 			static char tempname[28];
 			fileneeded_t *file = &fileneeded[lastfilenum];
 			char *filename = file->filename;
+			INT32 bps;
 
 			Snake_Draw();
 
 			Net_GetNetStat();
+			bps = getbps;
+#if defined (HAVE_CURL) && !defined (NONET)
+			if (cl_mode == CL_DOWNLOADHTTPFILES)
+				bps = (INT32)CL_HTTPDownloadSpeed();
+#endif
 			dldlength = (INT32)((file->currentsize/(double)file->totalsize) * 256);
 			if (dldlength > 256)
 				dldlength = 256;
@@ -1758,7 +1908,7 @@ static inline void CL_DrawConnectionStatus(void)
 			V_DrawString(BASEVIDWIDTH/2-128, BASEVIDHEIGHT-16, V_20TRANS|V_MONOSPACE,
 				va(" %4uK/%4uK",fileneeded[lastfilenum].currentsize>>10,file->totalsize>>10));
 			V_DrawRightAlignedString(BASEVIDWIDTH/2+128, BASEVIDHEIGHT-16, V_20TRANS|V_MONOSPACE,
-				va("%3.1fK/s ", ((double)getbps)/1024));
+				va("%3.1fK/s ", ((double)bps)/1024));
 		}
 		else
 			V_DrawCenteredString(BASEVIDWIDTH/2, BASEVIDHEIGHT-16-24, V_YELLOWMAP,
@@ -1903,6 +2053,11 @@ static void SV_SendServerInfo(INT32 node, tic_t servertime)
 
 	p = PutFileNeeded();
 
+	// The HTTP source goes after the whole file list, where older clients don't look
+	memset(p, 0, netbuffer->u.serverinfo.fileneeded + MAXFILENEEDED - p);
+	p = (UINT8 *)netbuffer->u.serverinfo.httpsource;
+	WRITESTRINGN(p, cv_httpsource.string, MAX_MIRROR_LENGTH - 1);
+
 	HSendPacket(node, false, 0, p - ((UINT8 *)&netbuffer->u));
 }
 
@@ -2047,74 +2202,367 @@ static boolean SV_SendServerConfig(INT32 node)
 }
 
 #ifndef NONET
-#define SAVEGAMESIZE (768*1024)
+#define SAVEGAMESIZE (768*1024) // starting size, it grows as needed
+#define SAVECHUNKSIZE (128*1024) // deflated a chunk at a time while saving
+#define SAVEHEADERSIZE (sizeof(UINT8) + sizeof(UINT32)) // compression, uncompressed length
 
-static void SV_SendSaveGame(INT32 node)
+#ifdef HAVE_ZLIB
+static z_stream savestream;
+static UINT8 *zsavebuffer;
+static size_t zsavesize;
+
+// Deflate whatever savestream has been given onto the end of zsavebuffer
+static void SV_DeflateSaveGame(int flush)
+{
+	int err;
+
+	do
+	{
+		if (!savestream.avail_out)
+		{
+			zsavesize <<= 1;
+			zsavebuffer = realloc(zsavebuffer, zsavesize);
+			if (!zsavebuffer)
+				I_Error("No more free memory for savegame\n");
+			savestream.next_out = zsavebuffer + SAVEHEADERSIZE + savestream.total_out;
+			savestream.avail_out = (uInt)(zsavesize - SAVEHEADERSIZE - savestream.total_out);
+		}
+
+		err = deflate(&savestream, flush);
+		if (err != Z_OK && err != Z_BUF_ERROR && err != Z_STREAM_END)
+			I_Error("Savegame compression failed (%d)\n", err);
+	} while (savestream.avail_in || (flush == Z_FINISH && err != Z_STREAM_END));
+}
+
+// Called by P_SaveBufferReserve each time the save buffer fills up
+static void SV_FlushSaveGame(UINT8 *data, size_t length)
+{
+	savestream.next_in = data;
+	savestream.avail_in = (uInt)length;
+	SV_DeflateSaveGame(Z_NO_FLUSH);
+}
+
+static UINT8 *SV_DeflateNetGame(size_t *length)
+{
+	UINT8 *savebuffer;
+
+	memset(&savestream, 0, sizeof (savestream));
+	if (deflateInit(&savestream, Z_DEFAULT_COMPRESSION) != Z_OK)
+		return NULL;
+
+	zsavesize = SAVECHUNKSIZE;
+	zsavebuffer = malloc(zsavesize);
+	if (!zsavebuffer || !P_SaveBufferAlloc(SAVECHUNKSIZE, SV_FlushSaveGame))
+	{
+		free(zsavebuffer);
+		deflateEnd(&savestream);
+		return NULL;
+	}
+	savestream.next_out = zsavebuffer + SAVEHEADERSIZE;
+	savestream.avail_out = (uInt)(zsavesize - SAVEHEADERSIZE);
+
+	P_SaveNetGame();
+
+	// deflate whatever didn't fill a whole chunk
+	savebuffer = P_SaveBufferRelease(length);
+	savestream.next_in = savebuffer;
+	savestream.avail_in = (uInt)*length;
+	SV_DeflateSaveGame(Z_FINISH);
+	free(savebuffer);
+
+	savebuffer = zsavebuffer;
+	WRITEUINT8(savebuffer, SAVECOMPRESSION_ZLIB);
+	WRITEUINT32(savebuffer, savestream.total_in);
+	*length = SAVEHEADERSIZE + savestream.total_out;
+
+	deflateEnd(&savestream);
+	return zsavebuffer;
+}
+#endif
+
+// Returns the gamestate to send to a joining player, ready to go
+static UINT8 *SV_BuildSaveGame(size_t *length)
 {
-	size_t length, compressedlen;
+	size_t compressedlen;
 	UINT8 *savebuffer;
 	UINT8 *compressedsave;
 	UINT8 *buffertosend;
 
-	// first save it in a malloced buffer
-	savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-	if (!savebuffer)
+#ifdef HAVE_ZLIB
+	if (cv_netsavecompression.value == SAVECOMPRESSION_ZLIB)
 	{
-		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
-		return;
+		buffertosend = SV_DeflateNetGame(length);
+		if (!buffertosend)
+		{
+			CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+			return NULL;
+		}
 	}
+	else
+#endif
+	{
+		// first save it in a malloced buffer
+		if (!P_SaveBufferAlloc(SAVEGAMESIZE, NULL))
+		{
+			CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+			return NULL;
+		}
 
-	// Leave room for the uncompressed length.
-	save_p = savebuffer + sizeof(UINT32);
+		// Leave room for the header.
+		save_p += SAVEHEADERSIZE;
 
-	P_SaveNetGame();
+		P_SaveNetGame();
 
-	length = save_p - savebuffer;
-	if (length > SAVEGAMESIZE)
-	{
-		free(savebuffer);
-		save_p = NULL;
-		I_Error("Savegame buffer overrun");
+		savebuffer = P_SaveBufferRelease(length);
+
+		// Allocate space for compressed save: one byte fewer than for the
+		// uncompressed data to ensure that the compression is worthwhile.
+		compressedsave = NULL;
+		compressedlen = 0;
+		if (cv_netsavecompression.value == SAVECOMPRESSION_LZF)
+		{
+			compressedsave = malloc(*length - 1);
+			if (!compressedsave)
+			{
+				free(savebuffer);
+				CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+				return NULL;
+			}
+
+			// Attempt to compress it.
+			compressedlen = lzf_compress(savebuffer + SAVEHEADERSIZE, *length - SAVEHEADERSIZE, compressedsave + SAVEHEADERSIZE, *length - SAVEHEADERSIZE - 1);
+		}
+
+		if (compressedlen)
+		{
+			// Compressing succeeded; send compressed data
+
+			free(savebuffer);
+
+			// State that we're compressed.
+			buffertosend = compressedsave;
+			WRITEUINT8(compressedsave, SAVECOMPRESSION_LZF);
+			WRITEUINT32(compressedsave, *length - SAVEHEADERSIZE);
+			*length = compressedlen + SAVEHEADERSIZE;
+		}
+		else
+		{
+			// Compression failed to make it smaller, or is off; send original
+
+			free(compressedsave);
+
+			// State that we're not compressed
+			buffertosend = savebuffer;
+			WRITEUINT8(savebuffer, SAVECOMPRESSION_NONE);
+			WRITEUINT32(savebuffer, *length - SAVEHEADERSIZE);
+		}
 	}
 
-	// Allocate space for compressed save: one byte fewer than for the
-	// uncompressed data to ensure that the compression is worthwhile.
-	compressedsave = malloc(length - 1);
-	if (!compressedsave)
+	return buffertosend;
+}
+
+static void SV_QueueSaveGame(INT32 node, UINT8 *buffer, size_t length)
+{
+	AddRamToSendQueue(node, buffer, length, SF_RAM, 0);
+
+	// Remember when we started sending the savegame so we can handle timeouts
+	sendingsavegame[node] = true;
+	freezetimeout[node] = I_GetTime() + jointimeout + length / 1024; // 1 extra tic for each kilobyte
+}
+
+#ifdef SAVEFORK
+// Dedicated servers write the gamestate from a fork()ed copy of themselves,
+// which hands it back through a pipe, so the game keeps running meanwhile.
+// The copy sees the world exactly as it was when the player joined.
+typedef struct
+{
+	pid_t pid; // 0 if there's nothing being written for this node
+	int fd;
+	UINT8 *buffer;
+	size_t length, size;
+} forkedsave_t;
+
+static forkedsave_t forkedsaves[MAXNETNODES];
+
+// Makes the forked copy harmless to the original: errors and crashes
+// just end it, and it lets go of every file and socket it inherited
+// except the pipe, so it can't talk to the players or write over the
+// config, ban list or game data.
+static void SV_DisownForkedSaveGame(int keepfd)
+{
+	const int signals[] = {SIGINT, SIGTERM, SIGILL, SIGSEGV, SIGABRT, SIGFPE};
+	DIR *dir;
+	struct dirent *entry;
+	int fd;
+	size_t i;
+
+	quieterror = true;
+	for (i = 0; i < sizeof signals / sizeof *signals; i++)
+		signal(signals[i], SIG_DFL);
+
+	dir = opendir("/proc/self/fd");
+	if (!dir)
 	{
-		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+		for (fd = 3; fd < 1024; fd++)
+			if (fd != keepfd)
+				close(fd);
 		return;
 	}
 
-	// Attempt to compress it.
-	if((compressedlen = lzf_compress(savebuffer + sizeof(UINT32), length - sizeof(UINT32), compressedsave + sizeof(UINT32), length - sizeof(UINT32) - 1)))
+	while ((entry = readdir(dir)) != NULL)
 	{
-		// Compressing succeeded; send compressed data
+		fd = atoi(entry->d_name);
+		if (fd > 2 && fd != keepfd && fd != dirfd(dir))
+			close(fd);
+	}
+	closedir(dir);
+}
+
+static boolean SV_ForkSaveGame(INT32 node)
+{
+	forkedsave_t *fs = &forkedsaves[node];
+	int fds[2];
+	pid_t pid;
 
-		free(savebuffer);
+	if (fs->pid)
+		return false;
+
+	fs->size = SAVECHUNKSIZE;
+	fs->buffer = malloc(fs->size);
+	if (!fs->buffer)
+		return false;
 
-		// State that we're compressed.
-		buffertosend = compressedsave;
-		WRITEUINT32(compressedsave, length - sizeof(UINT32));
-		length = compressedlen + sizeof(UINT32);
+	if (pipe(fds) == -1)
+	{
+		free(fs->buffer);
+		return false;
 	}
-	else
+
+	pid = fork();
+	if (pid == -1)
 	{
-		// Compression failed to make it smaller; send original
+		close(fds[0]);
+		close(fds[1]);
+		free(fs->buffer);
+		return false;
+	}
 
-		free(compressedsave);
+	if (pid == 0)
+	{
+		// This is the copy: write the gamestate down the pipe and leave
+		// without running any of the server's exit handlers.
+		size_t length, written = 0;
+		UINT8 *buffer;
+		ssize_t n;
 
-		// State that we're not compressed
-		buffertosend = savebuffer;
-		WRITEUINT32(savebuffer, 0);
+		SV_DisownForkedSaveGame(fds[1]);
+		buffer = SV_BuildSaveGame(&length);
+		while (buffer && written < length)
+		{
+			n = write(fds[1], buffer + written, length - written);
+			if (n == -1 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				break;
+			written += n;
+		}
+		_exit((buffer && written == length) ? 0 : 1);
 	}
 
-	AddRamToSendQueue(node, buffertosend, length, SF_RAM, 0);
-	save_p = NULL;
+	close(fds[1]);
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+	fs->pid = pid;
+	fs->fd = fds[0];
+	fs->length = 0;
 
-	// Remember when we started sending the savegame so we can handle timeouts
+	// Keep the node from being kicked for freezing while this is going on
 	sendingsavegame[node] = true;
-	freezetimeout[node] = I_GetTime() + jointimeout + length / 1024; // 1 extra tic for each kilobyte
+	freezetimeout[node] = I_GetTime() + jointimeout;
+	return true;
+}
+
+static void SV_CancelForkedSaveGame(INT32 node)
+{
+	forkedsave_t *fs = &forkedsaves[node];
+
+	if (!fs->pid)
+		return;
+
+	kill(fs->pid, SIGKILL);
+	waitpid(fs->pid, NULL, 0);
+	close(fs->fd);
+	free(fs->buffer);
+	fs->pid = 0;
+}
+
+// Collect whatever the forked copies have written so far
+static void SV_PollForkedSaveGames(void)
+{
+	forkedsave_t *fs;
+	ssize_t n;
+	int status;
+	INT32 node;
+
+	for (node = 0; node < MAXNETNODES; node++)
+	{
+		fs = &forkedsaves[node];
+		if (!fs->pid)
+			continue;
+
+		for (;;)
+		{
+			if (fs->length == fs->size)
+			{
+				UINT8 *newbuffer = realloc(fs->buffer, fs->size << 1);
+				if (!newbuffer)
+				{
+					errno = ENOMEM;
+					n = -1;
+					break;
+				}
+				fs->buffer = newbuffer;
+				fs->size <<= 1;
+			}
+
+			n = read(fs->fd, fs->buffer + fs->length, fs->size - fs->length);
+			if (n <= 0)
+				break;
+			fs->length += n;
+		}
+
+		if (n == -1 && (errno == EAGAIN || errno == EINTR))
+			continue; // not done yet
+
+		if (n == 0 && waitpid(fs->pid, &status, 0) == fs->pid
+			&& WIFEXITED(status) && WEXITSTATUS(status) == 0 && fs->length)
+		{
+			close(fs->fd);
+			fs->pid = 0;
+			SV_QueueSaveGame(node, fs->buffer, fs->length); // the send queue frees it
+			continue;
+		}
+
+		// The snapshot was of this exact moment, so it can't just be taken again now
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write the gamestate for node %d\n"), node);
+		SV_CancelForkedSaveGame(node);
+		Net_ConnectionTimeout(node);
+	}
+}
+#endif
+
+static void SV_SendSaveGame(INT32 node)
+{
+	UINT8 *buffer;
+	size_t length;
+
+#ifdef SAVEFORK
+	if (dedicated && SV_ForkSaveGame(node))
+		return;
+#endif
+
+	buffer = SV_BuildSaveGame(&length);
+	if (buffer)
+		SV_QueueSaveGame(node, buffer, length);
 }
 
 #ifdef DUMPCONSISTENCY
@@ -2133,8 +2581,7 @@ static void SV_SavedGame(void)
 	sprintf(tmpsave, "%s" PATHSEP TMPSAVENAME, srb2home);
 
 	// first save it in a malloced buffer
-	save_p = savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-	if (!save_p)
+	if (!P_SaveBufferAlloc(SAVEGAMESIZE, NULL))
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
 		return;
@@ -2142,20 +2589,13 @@ static void SV_SavedGame(void)
 
 	P_SaveNetGame();
 
-	length = save_p - savebuffer;
-	if (length > SAVEGAMESIZE)
-	{
-		free(savebuffer);
-		save_p = NULL;
-		I_Error("Savegame buffer overrun");
-	}
+	savebuffer = P_SaveBufferRelease(&length);
 
 	// then save it!
 	if (!FIL_WriteFile(tmpsave, savebuffer, length))
 		CONS_Printf(M_GetText("Didn't save %s for netgame"), tmpsave);
 
 	free(savebuffer);
-	save_p = NULL;
 }
 
 #undef  TMPSAVENAME
@@ -2167,6 +2607,7 @@ static void CL_LoadReceivedSavegame(void)
 {
 	UINT8 *savebuffer = NULL;
 	size_t length, decompressedlen;
+	UINT8 compression;
 	char tmpsave[256];
 
 	sprintf(tmpsave, "%s" PATHSEP TMPSAVENAME, srb2home);
@@ -2183,11 +2624,28 @@ static void CL_LoadReceivedSavegame(void)
 	save_p = savebuffer;
 
 	// Decompress saved game if necessary.
+	compression = READUINT8(save_p);
 	decompressedlen = READUINT32(save_p);
-	if(decompressedlen > 0)
+	if (compression != SAVECOMPRESSION_NONE)
 	{
 		UINT8 *decompressedbuffer = Z_Malloc(decompressedlen, PU_STATIC, NULL);
-		lzf_decompress(save_p, length - sizeof(UINT32), decompressedbuffer, decompressedlen);
+		switch (compression)
+		{
+			case SAVECOMPRESSION_LZF:
+				lzf_decompress(save_p, length - SAVEHEADERSIZE, decompressedbuffer, decompressedlen);
+				break;
+#ifdef HAVE_ZLIB
+			case SAVECOMPRESSION_ZLIB:
+			{
+				uLongf zlength = decompressedlen;
+				if (uncompress(decompressedbuffer, &zlength, save_p, length - SAVEHEADERSIZE) != Z_OK || zlength != decompressedlen)
+					I_Error("Can't decompress savegame sent");
+				break;
+			}
+#endif
+			default:
+				I_Error("Savegame sent uses an unknown compression (%d)", compression);
+		}
 		Z_Free(savebuffer);
 		save_p = savebuffer = decompressedbuffer;
 	}
@@ -2234,12 +2692,17 @@ static void CL_LoadReceivedSavegame(void)
 #endif
 
 #ifndef NONET
-static void SendAskInfo(INT32 node)
+static void FillAskInfo(void)
 {
 	const tic_t asktime = I_GetTime();
 	netbuffer->packettype = PT_ASKINFO;
 	netbuffer->u.askinfo.version = VERSION;
 	netbuffer->u.askinfo.time = (tic_t)LONG(asktime);
+}
+
+static void SendAskInfo(INT32 node)
+{
+	FillAskInfo();
 
 	// Even if this never arrives due to the host being firewalled, we've
 	// now allowed traffic from the host to us in, so once the MS relays
@@ -2247,20 +2710,32 @@ static void SendAskInfo(INT32 node)
 	HSendPacket(node, false, 0, sizeof (askinfo_pak));
 }
 
-serverelem_t serverlist[MAXSERVERLIST];
-UINT32 serverlistcount = 0;
+/** Asks a server for its info without giving it a node
+  *
+  * \param address Numeric address of the server, NULL to ask the whole LAN
+  * \param port    Port of the server, NULL for the default one
+  * \sa HandleServerInfo
+  *
+  */
+static void SendAskInfoToAddress(const char *address, const char *port)
+{
+	FillAskInfo();
+	HSendPacketToAddress(address, port, sizeof (askinfo_pak));
+}
 
-#define FORCECLOSE 0x8000
+serverelem_t *serverlist = NULL;
+UINT32 serverlistcount = 0;
+static UINT32 serverlistcapacity = 0;
 
 static void SL_ClearServerList(INT32 connectedserver)
 {
 	UINT32 i;
 
 	for (i = 0; i < serverlistcount; i++)
-		if (connectedserver != serverlist[i].node)
+		if (serverlist[i].node > 0 && connectedserver != serverlist[i].node)
 		{
 			Net_CloseConnection(serverlist[i].node|FORCECLOSE);
-			serverlist[i].node = 0;
+			serverlist[i].node = -1;
 		}
 	serverlistcount = 0;
 }
@@ -2268,6 +2743,10 @@ static void SL_ClearServerList(INT32 connectedserver)
 static UINT32 SL_SearchServer(INT32 node)
 {
 	UINT32 i;
+
+	if (node < 0)
+		return UINT32_MAX;
+
 	for (i = 0; i < serverlistcount; i++)
 		if (serverlist[i].node == node)
 			return i;
@@ -2275,18 +2754,38 @@ static UINT32 SL_SearchServer(INT32 node)
 	return UINT32_MAX;
 }
 
-static void SL_InsertServer(serverinfo_pak* info, SINT8 node)
+static UINT32 SL_SearchServerAddress(const char *address, const char *port)
 {
 	UINT32 i;
+	for (i = 0; i < serverlistcount; i++)
+		if (!strcmp(serverlist[i].address, address) && !strcmp(serverlist[i].port, port))
+			return i;
+
+	return UINT32_MAX;
+}
+
+/** Adds or updates a server in the list, keeping it sorted
+  *
+  * \param info    The server's info
+  * \param node    The node it replied from, -1 if it replied to the browser
+  * \param address Numeric address it replied from, NULL if it has a node
+  * \param port    Port it replied from, NULL if it has a node
+  *
+  */
+static void SL_InsertServer(serverinfo_pak* info, SINT8 node, const char *address, const char *port)
+{
+	UINT32 i, lo, hi;
+	serverelem_t *entry;
 
 	// search if not already on it
-	i = SL_SearchServer(node);
+	if (address)
+		i = SL_SearchServerAddress(address, port);
+	else
+		i = SL_SearchServer(node);
+
 	if (i == UINT32_MAX)
 	{
 		// not found add it
-		if (serverlistcount >= MAXSERVERLIST)
-			return; // list full
-
 		if (info->_255 != 255)
 			return;/* old packet format */
 
@@ -2302,14 +2801,69 @@ static void SL_InsertServer(serverinfo_pak* info, SINT8 node)
 		if (strcmp(info->application, SRB2APPLICATION))
 			return;/* that's a different mod */
 
-		i = serverlistcount++;
+		if (serverlistcount == serverlistcapacity)
+		{
+			serverlistcapacity = serverlistcapacity ? serverlistcapacity*2 : 32;
+			serverlist = Z_Realloc(serverlist, serverlistcapacity * sizeof *serverlist, PU_STATIC, NULL);
+		}
+
+		// the spare slot at the end holds it while we find its place
+		entry = &serverlist[serverlistcount];
+		entry->node = node;
+		strlcpy(entry->address, address ? address : "", sizeof entry->address);
+		strlcpy(entry->port, port ? port : "", sizeof entry->port);
+	}
+	else
+	{
+		// pull it out, its new info may move it
+		serverelem_t old = serverlist[i];
+
+		memmove(&serverlist[i], &serverlist[i+1], (serverlistcount - i - 1) * sizeof *serverlist);
+		serverlistcount--;
+
+		entry = &serverlist[serverlistcount];
+		*entry = old;
+	}
+
+	entry->info = *info;
+
+	// binary search for the first entry that sorts after it
+	lo = 0;
+	hi = serverlistcount;
+	while (lo < hi)
+	{
+		const UINT32 mid = (lo + hi)/2;
+		if (M_ServerListCompare(&serverlist[mid], entry) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
 
-	serverlist[i].info = *info;
-	serverlist[i].node = node;
+	if (lo < serverlistcount)
+	{
+		serverelem_t moved = *entry;
+		memmove(&serverlist[lo+1], &serverlist[lo], (serverlistcount - lo) * sizeof *serverlist);
+		serverlist[lo] = moved;
+	}
+	serverlistcount++;
+}
 
-	// resort server list
-	M_SortServerList();
+/** Gives a node to a server of the list so it can be connected to
+  *
+  * \param i Index in the server list
+  * \return The server's node, -1 if none could be made
+  *
+  */
+SINT8 SL_MakeServerNode(UINT32 i)
+{
+	if (i >= serverlistcount)
+		return -1;
+
+	// the address is numeric, so this won't block on a lookup
+	if (serverlist[i].node < 0 && I_NetMakeNodewPort)
+		serverlist[i].node = I_NetMakeNodewPort(serverlist[i].address, serverlist[i].port);
+
+	return serverlist[i].node;
 }
 
 #if defined (MASTERSERVER) && defined (HAVE_THREADS)
@@ -2371,23 +2925,10 @@ void CL_QueryServerList (msg_server_t *server_list)
 		/* lol bruh, that version COMES from the servers */
 		//if (strcmp(version, server_list[i].version) == 0)
 		{
-			INT32 node = I_NetMakeNodewPort(server_list[i].ip, server_list[i].port);
-			if (node == -1)
-				break; // no more node free
-			SendAskInfo(node);
-			// Force close the connection so that servers can't eat
-			// up nodes forever if we never get a reply back from them
-			// (usually when they've not forwarded their ports).
-			//
-			// Don't worry, we'll get in contact with the working
-			// servers again when they send SERVERINFO to us later!
-			//
-			// (Note: as a side effect this probably means every
-			// server in the list will probably be using the same node (e.g. node 1),
-			// not that it matters which nodes they use when
-			// the connections are closed afterwards anyway)
-			// -- Monster Iestyn 12/11/18
-			Net_CloseConnection(node|FORCECLOSE);
+			// No node for them, the reply is matched by its address.
+			// Servers that never answer (usually when they've not
+			// forwarded their ports) cost us nothing.
+			SendAskInfoToAddress(server_list[i].ip, server_list[i].port);
 		}
 	}
 }
@@ -2410,7 +2951,7 @@ void CL_UpdateServerList(boolean internetsearch, INT32 room)
 
 	// search for local servers
 	if (netgame)
-		SendAskInfo(BROADCASTADDR);
+		SendAskInfoToAddress(NULL, NULL);
 
 #ifdef MASTERSERVER
 	if (internetsearch)
@@ -2530,6 +3071,15 @@ static boolean CL_ServerConnectionSearchTicker(tic_t *asksent)
 			}
 			else if (i == 1)
 				cl_mode = CL_ASKJOIN;
+#if defined (HAVE_CURL) && !defined (NONET)
+			else if (!httpdownloadfailed && *serverlist[i].info.httpsource
+				&& !M_CheckParm("-nodownload")
+				&& CL_StartHTTPDownloads(serverlist[i].info.httpsource))
+			{
+				cl_mode = CL_DOWNLOADHTTPFILES;
+				Snake_Initialise();
+			}
+#endif
 			else
 			{
 				// must download something
@@ -2606,6 +3156,25 @@ static boolean CL_ServerConnectionTicker(const char *tmpsave, tic_t *oldtic, tic
 				return false;
 			break;
 
+#if defined (HAVE_CURL) && !defined (NONET)
+		case CL_DOWNLOADHTTPFILES:
+			if (CL_HTTPDownloadTicker())
+				break; // exit the case
+
+			for (i = 0; i < fileneedednum; i++)
+				if (fileneeded[i].status != FS_FOUND && fileneeded[i].status != FS_OPEN)
+					break;
+			if (i < fileneedednum)
+			{
+				// Look for the files again, and get the rest from the server
+				CONS_Printf(M_GetText("Downloading the remaining files from the server...\n"));
+				httpdownloadfailed = true;
+				cl_mode = CL_SEARCHING;
+				break;
+			}
+			/* FALLTHRU */
+#endif
+
 		case CL_DOWNLOADFILES:
 			waitmore = false;
 			for (i = 0; i < fileneedednum; i++)
@@ -2696,7 +3265,7 @@ static boolean CL_ServerConnectionTicker(const char *tmpsave, tic_t *oldtic, tic
 			return false;
 		}
 #ifndef NONET
-		else if (cl_mode == CL_DOWNLOADFILES && snake)
+		else if ((cl_mode == CL_DOWNLOADFILES || cl_mode == CL_DOWNLOADHTTPFILES) && snake)
 			Snake_Handle();
 #endif
 
@@ -2712,7 +3281,7 @@ static boolean CL_ServerConnectionTicker(const char *tmpsave, tic_t *oldtic, tic
 #ifndef NONET
 		if (client && cl_mode != CL_CONNECTED && cl_mode != CL_ABORTED)
 		{
-			if (cl_mode != CL_DOWNLOADFILES && cl_mode != CL_DOWNLOADSAVEGAME)
+			if (cl_mode != CL_DOWNLOADFILES && cl_mode != CL_DOWNLOADHTTPFILES && cl_mode != CL_DOWNLOADSAVEGAME)
 			{
 				F_MenuPresTicker(true); // title sky
 				F_TitleScreenTicker(true);
@@ -2755,6 +3324,9 @@ static void CL_ConnectToServer(void)
 #endif
 
 	cl_mode = CL_SEARCHING;
+#if defined (HAVE_CURL) && !defined (NONET)
+	httpdownloadfailed = false;
+#endif
 
 #ifndef NONET
 	// Don't get a corrupt savegame error because tmpsave already exists
@@ -3695,10 +4267,25 @@ static CV_PossibleValue_t maxsend_cons_t[] = {{0, "MIN"}, {51200, "MAX"}, {0, NU
 consvar_t cv_maxsend = {"maxsend", "4096", CV_SAVE, maxsend_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 consvar_t cv_noticedownload = {"noticedownload", "Off", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-// Speed of file downloading (in packets per tic)
-static CV_PossibleValue_t downloadspeed_cons_t[] = {{0, "MIN"}, {32, "MAX"}, {0, NULL}};
+// Upload budget for file transfers, shared by all nodes (in packets per tic)
+static CV_PossibleValue_t downloadspeed_cons_t[] = {{0, "MIN"}, {256, "MAX"}, {0, NULL}};
 consvar_t cv_downloadspeed = {"downloadspeed", "16", CV_SAVE, downloadspeed_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+// Base URL clients can download the server's files from, instead of through the game
+consvar_t cv_httpsource = {"http_source", "", CV_SAVE, NULL, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+// Compression of the gamestate sent to joining players
+static CV_PossibleValue_t netsavecompression_cons_t[] = {{SAVECOMPRESSION_NONE, "None"}, {SAVECOMPRESSION_LZF, "LZF"},
+#ifdef HAVE_ZLIB
+	{SAVECOMPRESSION_ZLIB, "Zlib"},
+#endif
+	{0, NULL}};
+#ifdef HAVE_ZLIB
+consvar_t cv_netsavecompression = {"netsavecompression", "Zlib", CV_SAVE, netsavecompression_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#else
+consvar_t cv_netsavecompression = {"netsavecompression", "LZF", CV_SAVE, netsavecompression_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
 static void Got_AddPlayer(UINT8 **p, INT32 playernum);
 
 // called one time at init
@@ -3717,6 +4304,7 @@ void D_ClientServerInit(void)
 	COM_AddCommand("reloadbans", Command_ReloadBan);
 	COM_AddCommand("connect", Command_connect);
 	COM_AddCommand("nodes", Command_Nodes);
+	COM_AddCommand("netbench", Command_Netbench_f);
 #ifdef PACKETDROP
 	COM_AddCommand("drop", Command_Drop);
 	COM_AddCommand("droprate", Command_Droprate);
@@ -3755,6 +4343,9 @@ static void ResetNode(INT32 node)
 	nodewaiting[node] = 0;
 	playerpernode[node] = 0;
 	sendingsavegame[node] = false;
+#ifdef SAVEFORK
+	SV_CancelForkedSaveGame(node);
+#endif
 	SV_InitResynchVars(node);
 }
 
@@ -4119,6 +4710,7 @@ boolean SV_SpawnServer(void)
 		if (netgame && I_NetOpenSocket)
 		{
 			I_NetOpenSocket();
+			SV_PrepareNetCache();
 #ifdef MASTERSERVER
 			if (ms_RoomId > 0)
 				RegisterServer();
@@ -4331,24 +4923,32 @@ static void HandleTimeout(SINT8 node)
 #ifndef NONET
 /** Called when a PT_SERVERINFO packet is received
   *
-  * \param node The packet sender
+  * \param node    The packet sender, -1 if it replied to the server browser
+  * \param address The sender's numeric address if it has no node
+  * \param port    The sender's port if it has no node
   * \note What happens if the packet comes from a client or something like that?
   *
   */
-static void HandleServerInfo(SINT8 node)
+static void HandleServerInfo(SINT8 node, const char *address, const char *port)
 {
 	// compute ping in ms
 	const tic_t ticnow = I_GetTime();
 	const tic_t ticthen = (tic_t)LONG(netbuffer->u.serverinfo.time);
 	const tic_t ticdiff = (ticnow - ticthen)*1000/NEWTICRATE;
 	netbuffer->u.serverinfo.time = (tic_t)LONG(ticdiff);
+
+	// Older servers send less, don't keep what was left in the buffer
+	if ((size_t)doomcom->datalength < BASEPACKETSIZE + sizeof (serverinfo_pak))
+		memset((UINT8 *)netbuffer + doomcom->datalength, 0, BASEPACKETSIZE + sizeof (serverinfo_pak) - doomcom->datalength);
+	netbuffer->u.serverinfo.httpsource[MAX_MIRROR_LENGTH-1] = '\0';
+
 	netbuffer->u.serverinfo.servername[MAXSERVERNAME-1] = 0;
 	netbuffer->u.serverinfo.application
 		[sizeof netbuffer->u.serverinfo.application - 1] = '\0';
 	netbuffer->u.serverinfo.gametypename
 		[sizeof netbuffer->u.serverinfo.gametypename - 1] = '\0';
 
-	SL_InsertServer(&netbuffer->u.serverinfo, node);
+	SL_InsertServer(&netbuffer->u.serverinfo, node, address, port);
 }
 #endif
 
@@ -4565,6 +5165,24 @@ static void HandlePacketFromAwayNode(SINT8 node)
 #undef SERVERONLY
 }
 
+/** Reads the delta-encoded ticcmds of a PT_CLIENTCMD-type packet
+  *
+  * \param cmd  Where to put the first ticcmd
+  * \param cmd2 Where to put the splitscreen ticcmd, if any
+  * \return False if the packet is malformed
+  *
+  */
+static boolean SV_ReadClientTiccmds(ticcmd_t *cmd, ticcmd_t *cmd2)
+{
+	const boolean twocmds = (netbuffer->packettype == PT_CLIENT2CMD || netbuffer->packettype == PT_CLIENT2MIS);
+	const UINT8 *end = (UINT8 *)netbuffer + doomcom->datalength;
+	UINT8 *p = ReadTiccmdDelta((UINT8 *)&netbuffer->u.clientpak.cmd, end, cmd, &emptyticcmd);
+
+	if (p && twocmds)
+		p = ReadTiccmdDelta(p, end, cmd2, &emptyticcmd);
+	return (p != NULL);
+}
+
 /** Handles a packet received from a node that is in game
   *
   * \param node The packet sender
@@ -4578,6 +5196,7 @@ static void HandlePacketFromPlayer(SINT8 node)
 	INT32 netconsole;
 	tic_t realend, realstart;
 	UINT8 *pak, *txtpak, numtxtpak;
+	ticcmd_t cmd2;
 #ifndef NOMD5
 	UINT8 finalmd5[16];/* Well, it's the cool thing to do? */
 #endif
@@ -4648,7 +5267,12 @@ static void HandlePacketFromPlayer(SINT8 node)
 			freezetimeout[node] = I_GetTime() + connectiontimeout;
 
 			// Copy ticcmd
-			G_MoveTiccmd(&netcmds[maketic%BACKUPTICS][netconsole], &netbuffer->u.clientpak.cmd, 1);
+			if (!SV_ReadClientTiccmds(&netcmds[maketic%BACKUPTICS][netconsole], &cmd2))
+			{
+				CONS_Alert(CONS_WARNING, M_GetText("Malformed ticcmd received from node %d\n"), netconsole);
+				SendKick(netconsole, KICK_MSG_CON_FAIL);
+				break;
+			}
 
 			// Check ticcmd for "speed hacks"
 			if (netcmds[maketic%BACKUPTICS][netconsole].forwardmove > MAXPLMOVE || netcmds[maketic%BACKUPTICS][netconsole].forwardmove < -MAXPLMOVE
@@ -4664,8 +5288,7 @@ static void HandlePacketFromPlayer(SINT8 node)
 			// Splitscreen cmd
 			if ((netbuffer->packettype == PT_CLIENT2CMD || netbuffer->packettype == PT_CLIENT2MIS)
 				&& nodetoplayer2[node] >= 0)
-				G_MoveTiccmd(&netcmds[maketic%BACKUPTICS][(UINT8)nodetoplayer2[node]],
-					&netbuffer->u.client2pak.cmd2, 1);
+				netcmds[maketic%BACKUPTICS][(UINT8)nodetoplayer2[node]] = cmd2;
 
 			// A delay before we check resynching
 			// Used on join or just after a synch fail
@@ -4868,9 +5491,11 @@ static void HandlePacketFromPlayer(SINT8 node)
 			realstart = netbuffer->u.serverpak.starttic;
 			realend = realstart + netbuffer->u.serverpak.numtics;
 
-			if (!txtpak)
-				txtpak = (UINT8 *)&netbuffer->u.serverpak.cmds[netbuffer->u.serverpak.numslots
-					* netbuffer->u.serverpak.numtics];
+			if (netbuffer->u.serverpak.numslots > MAXPLAYERS)
+			{
+				DEBFILE(va("bad numslots %d in PT_SERVERTICS\n", netbuffer->u.serverpak.numslots));
+				break;
+			}
 
 			if (realend > gametic + CLIENTBACKUPTICS)
 				realend = gametic + CLIENTBACKUPTICS;
@@ -4878,18 +5503,37 @@ static void HandlePacketFromPlayer(SINT8 node)
 
 			if (realstart <= neededtic && realend > neededtic)
 			{
+				const UINT8 *end = (UINT8 *)netbuffer + doomcom->datalength;
+				ticcmd_t cmds[2][MAXPLAYERS];
 				tic_t i, j;
+				INT32 slot;
 				pak = (UINT8 *)&netbuffer->u.serverpak.cmds;
 
-				for (i = realstart; i < realend; i++)
+				// Decode every tic, as each one is based on the previous
+				// and the textcmds only start after the last of them
+				for (i = 0; i < netbuffer->u.serverpak.numtics && pak; i++)
 				{
-					// clear first
-					D_Clearticcmd(i);
+					for (slot = 0; slot < netbuffer->u.serverpak.numslots && pak; slot++)
+						pak = ReadTiccmdDelta(pak, end, &cmds[i & 1][slot],
+							i ? &cmds[(i - 1) & 1][slot] : &emptyticcmd);
+
+					if (pak && realstart + i < realend)
+					{
+						D_Clearticcmd(realstart + i);
+						M_Memcpy(netcmds[(realstart + i)%BACKUPTICS], cmds[i & 1],
+							netbuffer->u.serverpak.numslots * sizeof (ticcmd_t));
+					}
+				}
 
-					// copy the tics
-					pak = G_ScpyTiccmd(netcmds[i%BACKUPTICS], pak,
-						netbuffer->u.serverpak.numslots*sizeof (ticcmd_t));
+				if (!pak)
+				{
+					DEBFILE("malformed PT_SERVERTICS\n");
+					break;
+				}
+				txtpak = pak;
 
+				for (i = realstart; i < realend; i++)
+				{
 					// copy the textcmds
 					numtxtpak = *txtpak++;
 					for (j = 0; j < numtxtpak; j++)
@@ -4989,6 +5633,9 @@ static void HandlePacketFromPlayer(SINT8 node)
 static void GetPackets(void)
 {
 	SINT8 node; // The packet sender
+#ifndef NONET
+	char address[MAXNETADDRESSLENGTH], port[MAXNETPORTLENGTH];
+#endif
 
 	player_joining = false;
 
@@ -5018,7 +5665,7 @@ static void GetPackets(void)
 #ifndef NONET
 		if (netbuffer->packettype == PT_SERVERINFO)
 		{
-			HandleServerInfo(node);
+			HandleServerInfo(node, NULL, NULL);
 			continue;
 		}
 #endif
@@ -5033,6 +5680,15 @@ static void GetPackets(void)
 		else
 			HandlePacketFromAwayNode(node);
 	}
+
+#ifndef NONET
+	// Replies to the server browser, from servers we have no node for
+	while (HGetPacketFromAddress(address, port))
+	{
+		if (netbuffer->packettype == PT_SERVERINFO)
+			HandleServerInfo(-1, address, port);
+	}
+#endif
 }
 
 //
@@ -5167,18 +5823,20 @@ static void CL_SendClientCmd(void)
 	}
 	else if (gamestate != GS_NULL && (addedtogame || dedicated))
 	{
-		G_MoveTiccmd(&netbuffer->u.clientpak.cmd, &localcmds, 1);
+		UINT8 *p;
+
 		netbuffer->u.clientpak.consistancy = SHORT(consistancy[gametic%BACKUPTICS]);
 
+		// Only the fields that are set get sent
+		p = WriteTiccmdDelta((UINT8 *)&netbuffer->u.clientpak.cmd, &localcmds, &emptyticcmd);
+
 		// Send a special packet with 2 cmd for splitscreen
 		if (splitscreen || botingame)
 		{
 			netbuffer->packettype += 2;
-			G_MoveTiccmd(&netbuffer->u.client2pak.cmd2, &localcmds2, 1);
-			packetsize = sizeof (client2cmd_pak);
+			p = WriteTiccmdDelta(p, &localcmds2, &emptyticcmd);
 		}
-		else
-			packetsize = sizeof (clientcmd_pak);
+		packetsize = p - (UINT8 *)&netbuffer->u;
 
 		HSendPacket(servernode, false, 0, packetsize);
 	}
@@ -5249,7 +5907,9 @@ static void SV_SendTics(void)
 			packsize = BASESERVERTICSSIZE;
 			for (i = realfirsttic; i < lasttictosend; i++)
 			{
-				packsize += sizeof (ticcmd_t) * doomcom->numslots;
+				for (j = 0; j < doomcom->numslots; j++)
+					packsize += TiccmdDeltaSize(&netcmds[i%BACKUPTICS][j],
+						i == realfirsttic ? &emptyticcmd : &netcmds[(i-1)%BACKUPTICS][j]);
 				packsize += TotalTextCmdPerTic(i);
 
 				if (packsize > software_MAXPACKETLENGTH)
@@ -5285,10 +5945,11 @@ static void SV_SendTics(void)
 			netbuffer->u.serverpak.numslots = (UINT8)SHORT(doomcom->numslots);
 			bufpos = (UINT8 *)&netbuffer->u.serverpak.cmds;
 
+			// Each slot is delta-encoded against the same slot in the previous tic
 			for (i = realfirsttic; i < lasttictosend; i++)
-			{
-				bufpos = G_DcpyTiccmd(bufpos, netcmds[i%BACKUPTICS], doomcom->numslots * sizeof (ticcmd_t));
-			}
+				for (j = 0; j < doomcom->numslots; j++)
+					bufpos = WriteTiccmdDelta(bufpos, &netcmds[i%BACKUPTICS][j],
+						i == realfirsttic ? &emptyticcmd : &netcmds[(i-1)%BACKUPTICS][j]);
 
 			// add textcmds
 			for (i = realfirsttic; i < lasttictosend; i++)
@@ -5451,6 +6112,9 @@ void TryRunTics(tic_t realtics)
 				consistancy[gametic%BACKUPTICS] = Consistancy();
 
 				rs_tictime = I_GetTimeMicros() - rs_tictime;
+#ifndef NONET
+				NetBench_TicTime(rs_tictime);
+#endif
 
 				// Leave a certain amount of tics present in the net buffer as long as we've ran at least one tic this frame.
 				if (client && gamestate == GS_LEVEL && leveltime > 3 && neededtic <= gametic + cv_netticbuffer.value)
@@ -5583,6 +6247,10 @@ void NetUpdate(void)
 	if (server)
 		CL_SendClientCmd(); // send it
 
+#ifndef NONET
+	NetBench_Ticker(); // fake clients get their packets in before the real ones
+#endif
+
 	GetPackets(); // get packet from client or from server
 
 	// client send the command after a receive of the server
@@ -5652,6 +6320,9 @@ void NetUpdate(void)
 	// Handle timeouts to prevent definitive freezes from happenning
 	if (server)
 	{
+#ifdef SAVEFORK
+		SV_PollForkedSaveGames();
+#endif
 		for (i = 1; i < MAXNETNODES; i++)
 			if (nodeingame[i] && freezetimeout[i] < I_GetTime())
 				Net_ConnectionTimeout(i);
@@ -5676,6 +6347,10 @@ void NetUpdate(void)
 	}
 
 	FileSendTicker();
+
+	// Everything for this tic has been sent, let it go out
+	if (I_NetFlush)
+		I_NetFlush();
 }
 
 /** Returns the number of players playing.
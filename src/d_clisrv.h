@@ -16,6 +16,7 @@
 #include "d_ticcmd.h"
 #include "d_net.h"
 #include "d_netcmd.h"
+#include "i_net.h"
 #include "d_net.h"
 #include "tables.h"
 #include "d_player.h"
@@ -25,8 +26,13 @@
 The 'packet version' is used to distinguish packet formats.
 This version is independent of VERSION and SUBVERSION. Different
 applications may follow different packet versions.
+
+Version 4 puts a compression byte before the length of join snapshots.
+Version 5 delta-encodes the ticcmds in PT_SERVERTICS and PT_CLIENTCMD.
+Version 6 adds the HTTP source of the server's files to PT_SERVERINFO.
+Only peers of the same packet version can play together.
 */
-#define PACKETVERSION 3
+#define PACKETVERSION 6
 
 // Network play related stuff.
 // There is a data struct that stores network
@@ -338,6 +344,10 @@ typedef struct
 	UINT8 data[0]; // Size is variable using hardware_MAXPACKETLENGTH
 } ATTRPACK filetx_pak;
 
+// Set in filesize when the data is a zlib stream of the file
+// rather than the file itself; the rest of filesize is the stream size
+#define FILETX_ZLIB 0x80000000
+
 typedef struct
 {
 	UINT32 start;
@@ -372,6 +382,7 @@ typedef struct
 
 #define MAXSERVERNAME 32
 #define MAXFILENEEDED 915
+#define MAX_MIRROR_LENGTH 256
 // This packet is too large
 typedef struct
 {
@@ -402,6 +413,7 @@ typedef struct
 	UINT8 actnum;
 	UINT8 iszone;
 	UINT8 fileneeded[MAXFILENEEDED]; // is filled with writexxx (byteptr.h)
+	char httpsource[MAX_MIRROR_LENGTH]; // URL the needed files can be downloaded from (PACKETVERSION 6)
 } ATTRPACK serverinfo_pak;
 
 typedef struct
@@ -471,7 +483,7 @@ typedef struct
 		UINT8 filereceived;
 		clientconfig_pak clientcfg;         //         136 bytes
 		UINT8 md5sum[16];
-		serverinfo_pak serverinfo;          //        1024 bytes
+		serverinfo_pak serverinfo;          //        1321 bytes
 		serverrefuse_pak serverrefuse;      //       65025 bytes (somehow I feel like those values are garbage...)
 		askinfo_pak askinfo;                //          61 bytes
 		msaskinfo_pak msaskinfo;            //          22 bytes
@@ -485,14 +497,16 @@ typedef struct
 #pragma pack()
 #endif
 
-#define MAXSERVERLIST (MAXNETNODES-1)
 typedef struct
 {
-	SINT8 node;
+	SINT8 node; // -1 until we connect to it
+	char address[MAXNETADDRESSLENGTH]; // numeric, empty if found through its node
+	char port[MAXNETPORTLENGTH];
 	serverinfo_pak info;
 } serverelem_t;
 
-extern serverelem_t serverlist[MAXSERVERLIST];
+// Sorted by M_ServerListCompare, grows as servers reply
+extern serverelem_t *serverlist;
 extern UINT32 serverlistcount;
 extern INT32 mapchangepending;
 
@@ -549,10 +563,21 @@ extern tic_t servermaxping;
 
 extern consvar_t cv_netticbuffer, cv_allownewplayer, cv_joinnextround, cv_maxplayers, cv_joindelay, cv_rejointimeout;
 extern consvar_t cv_resynchattempts, cv_blamecfail;
-extern consvar_t cv_maxsend, cv_noticedownload, cv_downloadspeed;
+extern consvar_t cv_maxsend, cv_noticedownload, cv_downloadspeed, cv_httpsource;
+
+// Compression of the gamestate sent to joining players
+typedef enum
+{
+	SAVECOMPRESSION_NONE,
+	SAVECOMPRESSION_LZF,
+	SAVECOMPRESSION_ZLIB
+} savecompression_t;
+extern consvar_t cv_netsavecompression;
 
 // Used in d_net, the only dependence
 tic_t ExpandTics(INT32 low, INT32 node);
+UINT8 *WriteTiccmdDelta(UINT8 *p, const ticcmd_t *cmd, const ticcmd_t *base);
+INT16 SV_GetConsistancy(tic_t tic);
 void D_ClientServerInit(void);
 
 // Initialise the other field
@@ -573,6 +598,7 @@ void CL_RemoveSplitscreenPlayer(void);
 void CL_Reset(void);
 void CL_ClearPlayer(INT32 playernum);
 void CL_QueryServerList(msg_server_t *list);
+SINT8 SL_MakeServerNode(UINT32 i);
 void CL_UpdateServerList(boolean internetsearch, INT32 room);
 // Is there a game running
 boolean Playing(void);
@@ -42,7 +42,6 @@
 //   firstticstosend is used to optimize a condition
 // Normally maketic >= gametic > 0
 
-#define FORCECLOSE 0x8000
 tic_t connectiontimeout = (10*TICRATE);
 
 /// \brief network packet
@@ -69,9 +68,13 @@ boolean (*I_NetGet)(void) = NULL;
 void (*I_NetSend)(void) = NULL;
 boolean (*I_NetCanSend)(void) = NULL;
 boolean (*I_NetCanGet)(void) = NULL;
+void (*I_NetFlush)(void) = NULL;
 void (*I_NetCloseSocket)(void) = NULL;
 void (*I_NetFreeNodenum)(INT32 nodenum) = NULL;
 SINT8 (*I_NetMakeNodewPort)(const char *address, const char* port) = NULL;
+boolean (*I_NetSendToAddress)(const char *address, const char *port) = NULL;
+boolean (*I_NetGetFromAddress)(char *address, char *port) = NULL;
+SINT8 (*I_NetMakeLocalNode)(void) = NULL;
 boolean (*I_NetOpenSocket)(void) = NULL;
 boolean (*I_Ban) (INT32 node) = NULL;
 void (*I_ClearBans)(void) = NULL;
@@ -133,7 +136,6 @@ boolean Net_GetNetStat(void)
 // Some structs and functions for acknowledgement of packets
 // -----------------------------------------------------------------
 #define MAXACKPACKETS 96 // Minimum number of nodes (wat)
-#define MAXACKTOSEND 96
 #define URGENTFREESLOTNUM 10
 #define ACKTOSENDTIMEOUT (TICRATE/11)
 
@@ -725,7 +727,7 @@ void Net_CloseConnection(INT32 node)
 //
 // Checksum
 //
-static UINT32 NetbufferChecksum(void)
+UINT32 NetbufferChecksum(void)
 {
 	UINT32 c = 0x1234567;
 	const INT32 l = doomcom->datalength - 4;
@@ -838,7 +840,9 @@ static void DebugPrintpacket(const char *header)
 		{
 			servertics_pak *serverpak = &netbuffer->u.serverpak;
 			UINT8 *cmd = (UINT8 *)(&serverpak->cmds[serverpak->numslots * serverpak->numtics]);
-			size_t ntxtcmd = &((UINT8 *)netbuffer)[doomcom->datalength] - cmd;
+			UINT8 *end = &((UINT8 *)netbuffer)[doomcom->datalength];
+			// With delta-encoded ticcmds the textcmds start earlier than this
+			size_t ntxtcmd = cmd < end ? (size_t)(end - cmd) : 0;
 
 			fprintf(debugfile, "    firsttic %u ply %d tics %d ntxtcmd %s\n    ",
 				(UINT32)serverpak->starttic, serverpak->numslots, serverpak->numtics, sizeu1(ntxtcmd));
@@ -1184,6 +1188,62 @@ boolean HGetPacket(void)
 	return true;
 }
 
+//
+// HSendPacketToAddress
+// Sends a connectionless packet, no node, no ack
+//
+boolean HSendPacketToAddress(const char *address, const char *port, size_t packetlength)
+{
+#ifdef NONET
+	(void)address;
+	(void)port;
+	(void)packetlength;
+	return false;
+#else
+	if (!I_NetSendToAddress)
+		return false;
+
+	doomcom->datalength = (INT16)(packetlength + BASEPACKETSIZE);
+	doomcom->remotenode = -1;
+	netbuffer->ack = netbuffer->ackreturn = 0;
+	netbuffer->checksum = NetbufferChecksum();
+	sendbytes += packetheaderlength + doomcom->datalength; // For stat
+
+	return I_NetSendToAddress(address, port);
+#endif
+}
+
+//
+// HGetPacketFromAddress
+// Returns false if no connectionless reply is waiting
+// Check Datalength and checksum
+//
+boolean HGetPacketFromAddress(char *address, char *port)
+{
+#ifdef NONET
+	(void)address;
+	(void)port;
+#else
+	if (!I_NetGetFromAddress)
+		return false;
+
+	while (I_NetGetFromAddress(address, port))
+	{
+		getbytes += packetheaderlength + doomcom->datalength; // For stat
+
+		if ((size_t)doomcom->datalength < BASEPACKETSIZE
+			|| netbuffer->checksum != NetbufferChecksum())
+		{
+			DEBFILE(va("Bad packet checksum from %s\n", address));
+			continue;
+		}
+
+		return true;
+	}
+#endif
+	return false;
+}
+
 static boolean Internal_Get(void)
 {
 	doomcom->remotenode = -1;
@@ -1252,9 +1312,13 @@ boolean D_CheckNetGame(void)
 	I_NetGet = Internal_Get;
 	I_NetSend = Internal_Send;
 	I_NetCanSend = NULL;
+	I_NetFlush = NULL;
 	I_NetCloseSocket = NULL;
 	I_NetFreeNodenum = Internal_FreeNodenum;
 	I_NetMakeNodewPort = NULL;
+	I_NetSendToAddress = NULL;
+	I_NetGetFromAddress = NULL;
+	I_NetMakeLocalNode = NULL;
 
 	hardware_MAXPACKETLENGTH = MAXPACKETLENGTH;
 	net_bandwidth = 30000;
@@ -1444,9 +1508,13 @@ void D_CloseConnection(void)
 		I_NetGet = Internal_Get;
 		I_NetSend = Internal_Send;
 		I_NetCanSend = NULL;
+		I_NetFlush = NULL;
 		I_NetCloseSocket = NULL;
 		I_NetFreeNodenum = Internal_FreeNodenum;
 		I_NetMakeNodewPort = NULL;
+		I_NetSendToAddress = NULL;
+		I_NetGetFromAddress = NULL;
+		I_NetMakeLocalNode = NULL;
 		netgame = false;
 		addedtogame = false;
 	}
@@ -28,6 +28,9 @@
 
 #define STATLENGTH (TICRATE*2)
 
+// Size of the ack list sent in a PT_NOTHING packet
+#define MAXACKTOSEND 96
+
 // stat of net
 extern INT32 ticruned, ticmiss;
 extern INT32 getbps, sendbps;
@@ -51,6 +54,12 @@ void Net_AckTicker(void);
 boolean HSendPacket(INT32 node, boolean reliable, UINT8 acknum,
 	size_t packetlength);
 boolean HGetPacket(void);
+// Connectionless packets, for querying servers we have no node for
+boolean HSendPacketToAddress(const char *address, const char *port, size_t packetlength);
+boolean HGetPacketFromAddress(char *address, char *port);
+#ifndef NONET
+UINT32 NetbufferChecksum(void);
+#endif
 void D_SetDoomcom(void);
 #ifndef NONET
 void D_SaveBan(void);
@@ -58,6 +67,7 @@ void D_SaveBan(void);
 boolean D_CheckNetGame(void);
 void D_CloseConnection(void);
 void Net_UnAcknowledgePacket(INT32 node);
+#define FORCECLOSE 0x8000 // Or'ed with the node, closes it without waiting for acks
 void Net_CloseConnection(INT32 node);
 void Net_ConnectionTimeout(INT32 node);
 void Net_AbortPacketType(UINT8 packettype);
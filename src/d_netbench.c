@@ -0,0 +1,1067 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  d_netbench.c
+/// \brief Synthetic clients for load testing a server from its own process
+///
+///        Every client gets a node with no address from the network driver,
+///        and I_NetSend/I_NetGet are wrapped so the packets the server sends
+///        to those nodes go to the clients, and the packets the clients make
+///        are handed to the server as if they came from the network.
+///        The clients go through the same steps as a real one: asking for
+///        the server info, downloading the files, joining, receiving the
+///        savegame, then sending ticcmds and answering resynchs.
+
+#include "doomdef.h"
+#include "d_netbench.h"
+#include "d_clisrv.h"
+#include "d_net.h"
+#include "d_netfil.h"
+#include "d_main.h"
+#include "doomstat.h"
+#include "g_game.h"
+#include "i_net.h"
+#include "i_system.h"
+#include "byteptr.h"
+#include "command.h"
+#include "console.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#ifndef NONET
+
+// Every client needs a node of its own
+#define MAXBENCHCLIENTS (MAXNETNODES - 1)
+
+// Packets made by the clients and not read by the server yet
+#define BENCHQUEUESIZE 256
+
+// How long a client waits for the server info before asking again
+#define BENCHRETRYTICS (3*TICRATE)
+
+// How long the clients get to leave before their nodes are closed
+#define BENCHQUITTICS (5*TICRATE)
+
+typedef enum
+{
+	NB_ASKINFO, // Waiting for the server info
+	NB_DOWNLOAD, // Requesting and receiving the files the server will send
+	NB_JOIN, // Ready to ask for joining
+	NB_WAITJOIN, // Join request sent
+	NB_LOADING, // Joined, receiving the savegame
+	NB_PLAYING,
+	NB_GONE, // Lost its node while in game
+	NB_QUIT // Asked to leave
+} benchstate_t;
+
+static const char *const benchstatenames[] =
+{
+	"askinfo",
+	"download",
+	"join",
+	"join",
+	"loading",
+	"playing",
+	"gone",
+	"quit"
+};
+
+typedef struct
+{
+	char name[MAX_WADPATH+1];
+	UINT8 fileid;
+} benchfile_t;
+
+typedef struct
+{
+	INT32 tics;
+	ticcmd_t cmd; // angleturn is added to the angle every tic
+} benchscriptline_t;
+
+typedef struct
+{
+	UINT8 state;
+	SINT8 node; // -1 when it has none
+	UINT8 lastack; // Highest reliable packet received
+	UINT8 ackreturned; // lastack when the last packet was made
+	tic_t statetime; // When the server info was asked for, or when to ask for joining
+
+	// Download in progress
+	INT32 file; // In benchfiles, -1 if none is requested
+	INT32 nextfile;
+	INT32 transfer; // File id expected in fragments, -1 for none
+	boolean *fragments;
+	UINT32 fragmentsize;
+	UINT32 receivedsize;
+	UINT32 totalsize;
+	UINT8 iteration;
+	fileack_pak *ackpacket;
+
+	// In game
+	tic_t neededtic;
+	ticcmd_t movecmd;
+	INT32 cmdtics; // Tics left before picking the next movecmd
+	INT16 angle;
+	INT32 scriptline;
+	UINT32 seed;
+
+	// Stats
+	precise_t joinstart;
+	UINT32 joinmicros; // 0 until joined
+	UINT64 bytesin, bytesout;
+	UINT32 refusals, resynchs, failedfiles;
+} benchclient_t;
+
+typedef struct
+{
+	SINT8 node; // -1 if it was closed before the packet was read
+	INT16 length;
+	UINT8 data[MAXPACKETLENGTH];
+} benchpacket_t;
+
+static INT32 benchwanted; // Clients asked for, 0 if there is no benchmark
+static tic_t benchduration; // 0 to run until stopped
+static boolean benchrunning;
+static boolean benchstopping;
+static tic_t benchstart, benchstop;
+
+static benchclient_t *benchclients;
+static SINT8 nodeclient[MAXNETNODES]; // Client using each node, or -1
+
+static benchpacket_t *benchqueue;
+static INT32 queuehead, queuecount;
+static UINT8 benchscratch[MAXPACKETLENGTH]; // Where packets go when the queue is full
+static UINT32 droppedpackets;
+
+static benchfile_t *benchfiles;
+static INT32 numbenchfiles;
+static boolean benchgotfiles;
+
+static benchscriptline_t *benchscript;
+static INT32 numbenchscriptlines;
+
+static UINT32 *tictimes;
+static size_t numtictimes, tictimescapacity;
+
+static void (*oldsend)(void);
+static boolean (*oldget)(void);
+static void (*oldfreenodenum)(INT32 nodenum);
+
+static const ticcmd_t emptycmd;
+
+static UINT32 NetBench_Random(benchclient_t *bot)
+{
+	bot->seed = bot->seed * 1103515245 + 12345;
+	return bot->seed >> 16;
+}
+
+static UINT32 NetBench_Micros(precise_t time)
+{
+	return (UINT32)(time * 1000000 / I_GetPrecisePrecision());
+}
+
+// ------------------------------------------------------------------
+// Packets from the clients
+// ------------------------------------------------------------------
+
+/** Starts a packet from a client
+  *
+  * \param bot        The client
+  * \param packettype The type of the packet
+  * \return The packet to fill, finished by NetBench_SendPacket
+  *
+  */
+static doomdata_t *NetBench_NewPacket(benchclient_t *bot, UINT8 packettype)
+{
+	doomdata_t *pak = (doomdata_t *)benchscratch;
+
+	if (queuecount < BENCHQUEUESIZE)
+		pak = (doomdata_t *)benchqueue[(queuehead + queuecount) % BENCHQUEUESIZE].data;
+
+	// Never reliable, nothing gets lost on the way
+	pak->ack = 0;
+	pak->ackreturn = bot->lastack;
+	pak->packettype = packettype;
+	pak->reserved = 0;
+	bot->ackreturned = bot->lastack;
+	return pak;
+}
+
+/** Queues the packet started by NetBench_NewPacket for the server to read
+  *
+  * \param bot    The client
+  * \param length The length of the packet, not counting the header
+  *
+  */
+static void NetBench_SendPacket(benchclient_t *bot, size_t length)
+{
+	benchpacket_t *pak;
+
+	if (queuecount == BENCHQUEUESIZE)
+	{
+		droppedpackets++;
+		return;
+	}
+
+	pak = &benchqueue[(queuehead + queuecount) % BENCHQUEUESIZE];
+	pak->node = bot->node;
+	pak->length = (INT16)(BASEPACKETSIZE + length);
+	queuecount++;
+}
+
+static void NetBench_FlushAcks(benchclient_t *bot)
+{
+	fileack_pak *ack = bot->ackpacket;
+	fileack_pak *pak;
+	INT32 i;
+
+	if (!ack || !ack->numsegments || bot->node == -1)
+		return;
+
+	pak = &NetBench_NewPacket(bot, PT_FILEACK)->u.fileack;
+	pak->fileid = (UINT8)bot->transfer;
+	pak->iteration = bot->iteration;
+	pak->numsegments = ack->numsegments;
+	for (i = 0; i < ack->numsegments; i++)
+	{
+		pak->segments[i].start = LONG(ack->segments[i].start);
+		pak->segments[i].acks = LONG(ack->segments[i].acks);
+	}
+	NetBench_SendPacket(bot, sizeof (*pak) + ack->numsegments * sizeof (*pak->segments));
+
+	memset(ack, 0, sizeof (*ack) + 512);
+}
+
+static void NetBench_AckFragment(benchclient_t *bot, UINT32 fragment)
+{
+	fileack_pak *ack = bot->ackpacket;
+	fileacksegment_t *segment = &ack->segments[ack->numsegments - 1];
+
+	if (ack->numsegments == 0
+		|| fragment < segment->start
+		|| fragment - segment->start >= 32)
+	{
+		if ((ack->numsegments + 1) * sizeof (*segment) > 512)
+			NetBench_FlushAcks(bot);
+
+		ack->numsegments++;
+		segment = &ack->segments[ack->numsegments - 1];
+		segment->start = fragment;
+	}
+	segment->acks |= 1 << (fragment - segment->start);
+}
+
+static void NetBench_EndTransfer(benchclient_t *bot)
+{
+	free(bot->fragments);
+	free(bot->ackpacket);
+	bot->fragments = NULL;
+	bot->ackpacket = NULL;
+	bot->transfer = -1;
+}
+
+static void NetBench_SendFileRequest(benchclient_t *bot)
+{
+	doomdata_t *pak = NetBench_NewPacket(bot, PT_REQUESTFILE);
+	UINT8 *p = pak->u.textcmd;
+
+	WRITEUINT8(p, benchfiles[bot->file].fileid);
+	WRITESTRINGN(p, benchfiles[bot->file].name, MAX_WADPATH);
+	WRITEUINT8(p, 0xFF);
+#ifdef HAVE_ZLIB
+	WRITEUINT8(p, FILEREQUEST_ZLIB);
+#endif
+	NetBench_SendPacket(bot, p - pak->u.textcmd);
+
+	bot->transfer = benchfiles[bot->file].fileid;
+}
+
+static void NetBench_SendJoin(benchclient_t *bot)
+{
+	doomdata_t *pak = NetBench_NewPacket(bot, PT_CLIENTJOIN);
+	clientconfig_pak *cfg = &pak->u.clientcfg;
+
+	memset(cfg, 0, sizeof (*cfg));
+	cfg->_255 = 255;
+	cfg->packetversion = PACKETVERSION;
+	strncpy(cfg->application, SRB2APPLICATION, sizeof cfg->application);
+	cfg->version = VERSION;
+	cfg->subversion = SUBVERSION;
+	cfg->localplayers = 1;
+	snprintf(cfg->names[0], MAXPLAYERNAME, "Bench%d", (INT32)(bot - benchclients) + 1);
+	NetBench_SendPacket(bot, sizeof (*cfg));
+
+	bot->joinstart = I_GetPreciseTime();
+}
+
+static void NetBench_NextCmd(benchclient_t *bot)
+{
+	if (numbenchscriptlines)
+	{
+		const benchscriptline_t *line = &benchscript[bot->scriptline];
+
+		bot->movecmd = line->cmd;
+		bot->cmdtics = line->tics;
+		bot->scriptline = (bot->scriptline + 1) % numbenchscriptlines;
+		return;
+	}
+
+	bot->movecmd.forwardmove = (SINT8)((INT32)(NetBench_Random(bot) % (2*MAXPLMOVE + 1)) - MAXPLMOVE);
+	bot->movecmd.sidemove = (SINT8)((INT32)(NetBench_Random(bot) % (2*MAXPLMOVE + 1)) - MAXPLMOVE);
+	bot->movecmd.angleturn = (INT16)((INT32)(NetBench_Random(bot) % 1025) - 512);
+	bot->movecmd.aiming = 0;
+	bot->movecmd.buttons = 0;
+	if (NetBench_Random(bot) & 1)
+		bot->movecmd.buttons |= BT_JUMP;
+	if (NetBench_Random(bot) & 1)
+		bot->movecmd.buttons |= BT_SPIN;
+	bot->cmdtics = TICRATE/4 + NetBench_Random(bot) % (TICRATE/2);
+}
+
+static void NetBench_SendCmd(benchclient_t *bot)
+{
+	// Like a real client, never claim to be ahead of the server
+	const tic_t clienttic = min(bot->neededtic, gametic);
+	doomdata_t *pak;
+	ticcmd_t cmd;
+	UINT8 *p;
+
+	if (bot->cmdtics <= 0)
+		NetBench_NextCmd(bot);
+	bot->cmdtics--;
+
+	bot->angle = (INT16)(bot->angle + bot->movecmd.angleturn);
+	cmd = bot->movecmd;
+	cmd.angleturn = (INT16)(bot->angle | TICCMD_RECEIVED);
+
+	pak = NetBench_NewPacket(bot, PT_CLIENTCMD);
+	pak->u.clientpak.client_tic = (UINT8)(clienttic & UINT8_MAX);
+	pak->u.clientpak.resendfrom = (UINT8)(bot->neededtic & UINT8_MAX);
+	// We are the server, so the clients are always in synch
+	pak->u.clientpak.consistancy = SHORT(SV_GetConsistancy(clienttic));
+	p = WriteTiccmdDelta((UINT8 *)&pak->u.clientpak.cmd, &cmd, &emptycmd);
+	NetBench_SendPacket(bot, p - (UINT8 *)&pak->u);
+}
+
+static void NetBench_SendKeepAlive(benchclient_t *bot)
+{
+	doomdata_t *pak = NetBench_NewPacket(bot, PT_NODEKEEPALIVE);
+
+	pak->u.clientpak.client_tic = (UINT8)(min(bot->neededtic, gametic) & UINT8_MAX);
+	pak->u.clientpak.resendfrom = (UINT8)(bot->neededtic & UINT8_MAX);
+	NetBench_SendPacket(bot, sizeof (clientcmd_pak) - sizeof (ticcmd_t) - sizeof (INT16));
+}
+
+static boolean NetBench_GetNode(benchclient_t *bot)
+{
+	if (bot->node != -1)
+		return true;
+
+	bot->node = I_NetMakeLocalNode();
+	if (bot->node == -1)
+		return false;
+
+	nodeclient[bot->node] = (SINT8)(bot - benchclients);
+	bot->lastack = bot->ackreturned = 0;
+	return true;
+}
+
+// ------------------------------------------------------------------
+// Packets to the clients
+// ------------------------------------------------------------------
+
+static void NetBench_Joined(benchclient_t *bot)
+{
+	bot->state = NB_PLAYING;
+	bot->joinmicros = max(NetBench_Micros(I_GetPreciseTime() - bot->joinstart), 1);
+	bot->cmdtics = 0;
+}
+
+// Reads the file list out of a PT_SERVERINFO packet, for all clients
+static void NetBench_ParseFiles(void)
+{
+	UINT8 *p = netbuffer->u.serverinfo.fileneeded;
+	const INT32 numfiles = netbuffer->u.serverinfo.fileneedednum;
+	INT32 i, mainfiles = 0;
+	UINT8 status;
+
+	// Every client already has the base game
+	for (i = 0; i < mainwads && i < numwadfiles; i++)
+		if (wadfiles[i]->important)
+			mainfiles++;
+
+	benchgotfiles = true;
+	numbenchfiles = 0;
+	if (!numfiles)
+		return;
+
+	benchfiles = Z_Realloc(benchfiles, numfiles * sizeof (*benchfiles), PU_STATIC, NULL);
+	for (i = 0; i < numfiles; i++)
+	{
+		status = READUINT8(p);
+		p += 4; // Size
+		READSTRINGN(p, benchfiles[numbenchfiles].name, MAX_WADPATH);
+		p += 16; // MD5
+		if (i >= mainfiles && (status >> 4) == 1) // Will send if requested
+			benchfiles[numbenchfiles++].fileid = (UINT8)i;
+	}
+}
+
+static void NetBench_GotFragment(benchclient_t *bot)
+{
+	const filetx_pak *pak = &netbuffer->u.filetxpak;
+	const UINT32 fragmentsize = SHORT(pak->size);
+	const UINT32 position = LONG(pak->position);
+	const UINT32 datasize = doomcom->datalength - BASEPACKETSIZE - FILETXHEADER;
+	doomdata_t *received;
+	UINT32 fragment;
+
+	if (bot->transfer == -1 || pak->fileid != bot->transfer || !fragmentsize)
+		return;
+
+	if (!bot->fragments)
+	{
+		bot->fragmentsize = fragmentsize;
+		bot->totalsize = LONG(pak->filesize) & ~FILETX_ZLIB;
+		bot->receivedsize = 0;
+		bot->iteration = 0;
+		bot->fragments = calloc(bot->totalsize / fragmentsize + 1, sizeof (*bot->fragments));
+		bot->ackpacket = calloc(1, sizeof (*bot->ackpacket) + 512);
+		if (!(bot->fragments && bot->ackpacket))
+			I_Error("NetBench_GotFragment: No more memory\n");
+	}
+
+	if (position >= bot->totalsize || fragmentsize != bot->fragmentsize)
+		return;
+
+	fragment = position / fragmentsize;
+	bot->iteration = max(bot->iteration, pak->iteration);
+	if (!bot->fragments[fragment])
+	{
+		bot->fragments[fragment] = true;
+		bot->receivedsize += datasize;
+	}
+	// Acknowledge again if we already had it, the ack was probably missed
+	NetBench_AckFragment(bot, fragment);
+
+	if (bot->receivedsize < bot->totalsize)
+		return;
+
+	received = NetBench_NewPacket(bot, PT_FILERECEIVED);
+	received->u.filereceived = (UINT8)bot->transfer;
+	NetBench_SendPacket(bot, 1);
+	NetBench_EndTransfer(bot);
+
+	if (bot->state == NB_LOADING)
+		NetBench_Joined(bot);
+	else if (bot->state == NB_DOWNLOAD)
+	{
+		bot->file = -1;
+		bot->nextfile++;
+	}
+}
+
+/** Handles a packet the server sent to a client, still in netbuffer
+  *
+  * \param bot The client
+  *
+  */
+static void NetBench_Receive(benchclient_t *bot)
+{
+	if (netbuffer->ack && (!bot->lastack || (SINT8)(netbuffer->ack - bot->lastack) > 0))
+		bot->lastack = netbuffer->ack;
+
+	switch (netbuffer->packettype)
+	{
+		case PT_SERVERINFO:
+			if (bot->state != NB_ASKINFO)
+				break;
+			if (!benchgotfiles)
+				NetBench_ParseFiles();
+			bot->state = NB_DOWNLOAD;
+			bot->file = -1;
+			bot->nextfile = 0;
+			break;
+
+		case PT_SERVERREFUSE:
+			if (bot->state != NB_WAITJOIN)
+				break;
+			bot->refusals++;
+			bot->state = NB_JOIN;
+			bot->statetime = I_GetTime() + TICRATE;
+			break;
+
+		case PT_SERVERCFG:
+			if (bot->state != NB_WAITJOIN)
+				break;
+			bot->neededtic = (tic_t)LONG(netbuffer->u.servercfg.gametic);
+			bot->angle = 0;
+			if (netbuffer->u.servercfg.gamestate == GS_LEVEL
+				|| netbuffer->u.servercfg.gamestate == GS_INTERMISSION)
+			{
+				bot->state = NB_LOADING;
+				bot->transfer = 0; // The savegame
+			}
+			else
+				NetBench_Joined(bot);
+			break;
+
+		case PT_FILEFRAGMENT:
+			NetBench_GotFragment(bot);
+			break;
+
+		case PT_SERVERTICS:
+		{
+			const tic_t realstart = netbuffer->u.serverpak.starttic;
+			const tic_t realend = realstart + netbuffer->u.serverpak.numtics;
+
+			if (realstart <= bot->neededtic && realend > bot->neededtic)
+				bot->neededtic = realend;
+			break;
+		}
+
+		case PT_RESYNCHING:
+		{
+			const UINT8 playernum = netbuffer->u.resynchpak.playernum;
+			doomdata_t *pak = NetBench_NewPacket(bot, PT_RESYNCHGET);
+
+			pak->u.resynchgot = playernum;
+			NetBench_SendPacket(bot, sizeof (UINT8));
+			bot->resynchs++;
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+// ------------------------------------------------------------------
+// Network driver wrappers
+// ------------------------------------------------------------------
+
+static void NetBench_Send(void)
+{
+	const INT32 node = doomcom->remotenode;
+
+	if (node > 0 && node < MAXNETNODES && nodeclient[node] != -1)
+	{
+		benchclient_t *bot = &benchclients[nodeclient[node]];
+		bot->bytesin += packetheaderlength + doomcom->datalength;
+		NetBench_Receive(bot);
+	}
+	else
+		oldsend();
+}
+
+static boolean NetBench_Get(void)
+{
+	while (queuecount)
+	{
+		const benchpacket_t *pak = &benchqueue[queuehead];
+
+		queuehead = (queuehead + 1) % BENCHQUEUESIZE;
+		queuecount--;
+		if (pak->node == -1)
+			continue;
+
+		M_Memcpy(doomcom->data, pak->data, pak->length);
+		doomcom->datalength = pak->length;
+		doomcom->remotenode = pak->node;
+		netbuffer->checksum = NetbufferChecksum();
+		benchclients[nodeclient[pak->node]].bytesout += packetheaderlength + pak->length;
+		return false;
+	}
+	return oldget();
+}
+
+static void NetBench_FreeNodenum(INT32 node)
+{
+	if (node > 0 && node < MAXNETNODES && nodeclient[node] != -1)
+	{
+		benchclient_t *bot = &benchclients[nodeclient[node]];
+		INT32 i;
+
+		// Whatever the client still had to say is lost with the node
+		for (i = 0; i < queuecount; i++)
+			if (benchqueue[(queuehead + i) % BENCHQUEUESIZE].node == node)
+				benchqueue[(queuehead + i) % BENCHQUEUESIZE].node = -1;
+
+		nodeclient[node] = -1;
+		bot->node = -1;
+
+		switch (bot->state)
+		{
+			case NB_DOWNLOAD:
+				// The server couldn't send the file
+				if (bot->file != -1)
+				{
+					bot->failedfiles++;
+					bot->file = -1;
+					bot->nextfile++;
+				}
+				break;
+			case NB_WAITJOIN:
+				bot->state = NB_JOIN;
+				break;
+			case NB_LOADING:
+			case NB_PLAYING:
+				bot->state = NB_GONE;
+				break;
+			default:
+				break;
+		}
+		NetBench_EndTransfer(bot);
+	}
+
+	oldfreenodenum(node);
+}
+
+// ------------------------------------------------------------------
+// Running the benchmark
+// ------------------------------------------------------------------
+
+static void NetBench_ClientTicker(benchclient_t *bot)
+{
+	const tic_t now = I_GetTime();
+	const INT32 queued = queuecount;
+
+	switch (bot->state)
+	{
+		case NB_ASKINFO:
+			if (now - bot->statetime < BENCHRETRYTICS)
+				break;
+			if (NetBench_GetNode(bot))
+			{
+				doomdata_t *pak = NetBench_NewPacket(bot, PT_ASKINFO);
+				pak->u.askinfo.version = VERSION;
+				pak->u.askinfo.time = (tic_t)LONG(now);
+				NetBench_SendPacket(bot, sizeof (askinfo_pak));
+				bot->statetime = now;
+			}
+			break;
+
+		case NB_DOWNLOAD:
+			if (bot->file != -1)
+				break;
+			if (bot->nextfile >= numbenchfiles)
+			{
+				bot->state = NB_JOIN;
+				bot->statetime = now;
+			}
+			else if (NetBench_GetNode(bot))
+			{
+				bot->file = bot->nextfile;
+				NetBench_SendFileRequest(bot);
+			}
+			break;
+
+		case NB_JOIN:
+			if (now >= bot->statetime && NetBench_GetNode(bot))
+			{
+				NetBench_SendJoin(bot);
+				bot->state = NB_WAITJOIN;
+			}
+			break;
+
+		case NB_LOADING:
+			NetBench_SendKeepAlive(bot);
+			break;
+
+		case NB_PLAYING:
+			NetBench_SendCmd(bot);
+			break;
+
+		default:
+			break;
+	}
+
+	if (bot->node == -1)
+		return;
+
+	NetBench_FlushAcks(bot);
+
+	// Nothing else went out, so return the acks on their own
+	if (queuecount == queued && bot->lastack != bot->ackreturned)
+	{
+		doomdata_t *pak = NetBench_NewPacket(bot, PT_NOTHING);
+		memset(pak->u.textcmd, 0, MAXACKTOSEND);
+		NetBench_SendPacket(bot, MAXACKTOSEND);
+	}
+}
+
+static int NetBench_Compare(const void *p1, const void *p2)
+{
+	const UINT32 v1 = *(const UINT32 *)p1;
+	const UINT32 v2 = *(const UINT32 *)p2;
+	if (v1 != v2)
+		return (v1 < v2) ? -1 : 1;
+	return 0;
+}
+
+static UINT32 NetBench_Percentile(const UINT32 *sorted, size_t count, size_t percent)
+{
+	if (!count)
+		return 0;
+	return sorted[min(count - 1, count * percent / 100)];
+}
+
+static void NetBench_Report(void)
+{
+	const tic_t elapsed = max((benchstopping ? benchstop : I_GetTime()) - benchstart, 1);
+	UINT32 *sorted;
+	UINT32 joins[MAXBENCHCLIENTS];
+	size_t numjoins = 0;
+	INT32 i;
+
+	CONS_Printf(M_GetText("Benchmark of %d clients over %u.%02u seconds:\n"), benchwanted,
+		elapsed / TICRATE, (elapsed % TICRATE) * 100 / TICRATE);
+
+	if (numtictimes)
+	{
+		sorted = Z_Malloc(numtictimes * sizeof (*sorted), PU_STATIC, NULL);
+		M_Memcpy(sorted, tictimes, numtictimes * sizeof (*sorted));
+		qsort(sorted, numtictimes, sizeof (*sorted), NetBench_Compare);
+		CONS_Printf(M_GetText(" Tic time over %s tics: %u us median, %u us p90, %u us p99, %u us worst\n"),
+			sizeu1(numtictimes),
+			NetBench_Percentile(sorted, numtictimes, 50),
+			NetBench_Percentile(sorted, numtictimes, 90),
+			NetBench_Percentile(sorted, numtictimes, 99),
+			sorted[numtictimes - 1]);
+		Z_Free(sorted);
+	}
+
+	for (i = 0; i < benchwanted; i++)
+		if (benchclients[i].joinmicros)
+			joins[numjoins++] = benchclients[i].joinmicros;
+	if (numjoins)
+	{
+		qsort(joins, numjoins, sizeof (*joins), NetBench_Compare);
+		CONS_Printf(M_GetText(" %s of %d joined: %u ms median, %u ms worst join time\n"),
+			sizeu1(numjoins), benchwanted,
+			NetBench_Percentile(joins, numjoins, 50) / 1000, joins[numjoins - 1] / 1000);
+	}
+	else
+		CONS_Printf(M_GetText(" None joined yet; \"joindelay\" limits how fast players may join\n"));
+	if (droppedpackets)
+		CONS_Printf(M_GetText(" %u client packets dropped, the queue was full\n"), droppedpackets);
+
+	CONS_Printf(" %-8s %4s %-8s %9s %9s %7s %7s %7s %6s\n",
+		"Client", "node", "state", "down kB/s", "up kB/s", "join ms", "resynch", "refused", "failed");
+	for (i = 0; i < benchwanted; i++)
+	{
+		const benchclient_t *bot = &benchclients[i];
+		CONS_Printf(" %-8d %4d %-8s %9u %9u %7u %7u %7u %6u\n", i + 1, bot->node,
+			benchstatenames[bot->state],
+			(UINT32)(bot->bytesin * TICRATE / elapsed / 1024),
+			(UINT32)(bot->bytesout * TICRATE / elapsed / 1024),
+			bot->joinmicros / 1000, bot->resynchs, bot->refusals, bot->failedfiles);
+	}
+}
+
+// Forgets everything about the benchmark; the hooks must be restored already
+static void NetBench_Clear(void)
+{
+	INT32 i;
+
+	if (benchclients)
+		for (i = 0; i < benchwanted; i++)
+			NetBench_EndTransfer(&benchclients[i]);
+
+	Z_Free(benchclients);
+	Z_Free(benchqueue);
+	Z_Free(benchfiles);
+	Z_Free(benchscript);
+	Z_Free(tictimes);
+	benchclients = NULL;
+	benchqueue = NULL;
+	benchfiles = NULL;
+	benchscript = NULL;
+	tictimes = NULL;
+
+	numbenchfiles = numbenchscriptlines = 0;
+	numtictimes = tictimescapacity = 0;
+	queuehead = queuecount = 0;
+	droppedpackets = 0;
+	benchgotfiles = benchrunning = benchstopping = false;
+	benchwanted = 0;
+}
+
+static void NetBench_Shutdown(void)
+{
+	INT32 i;
+
+	if (I_NetSend == NetBench_Send)
+	{
+		// Whoever didn't leave in time gets cut off
+		for (i = 0; i < benchwanted; i++)
+			if (benchclients[i].node != -1)
+				Net_CloseConnection(benchclients[i].node | FORCECLOSE);
+
+		I_NetSend = oldsend;
+		I_NetGet = oldget;
+		I_NetFreeNodenum = oldfreenodenum;
+	}
+
+	NetBench_Clear();
+	CONS_Printf(M_GetText("Benchmark ended\n"));
+}
+
+static void NetBench_Stop(void)
+{
+	INT32 i;
+
+	NetBench_Report();
+	benchstopping = true;
+	benchstop = I_GetTime();
+
+	for (i = 0; i < benchwanted; i++)
+	{
+		benchclient_t *bot = &benchclients[i];
+
+		if (bot->node != -1)
+		{
+			NetBench_NewPacket(bot, PT_CLIENTQUIT);
+			NetBench_SendPacket(bot, 0);
+		}
+		bot->state = NB_QUIT;
+	}
+}
+
+static boolean NetBench_Start(void)
+{
+	INT32 i;
+
+	if (gamestate != GS_LEVEL)
+		return false;
+
+	if (!I_NetMakeLocalNode)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("This network driver can't run a benchmark\n"));
+		NetBench_Clear();
+		return false;
+	}
+
+	benchclients = Z_Calloc(benchwanted * sizeof (*benchclients), PU_STATIC, NULL);
+	for (i = 0; i < benchwanted; i++)
+	{
+		benchclient_t *bot = &benchclients[i];
+
+		bot->state = NB_ASKINFO;
+		bot->node = -1;
+		bot->file = bot->transfer = -1;
+		bot->statetime = I_GetTime() - BENCHRETRYTICS; // Ask right away
+		bot->seed = 0x9E3779B9u * (i + 1);
+		// Spread the clients over the script
+		bot->scriptline = numbenchscriptlines ? (i * 7) % numbenchscriptlines : 0;
+	}
+
+	benchqueue = Z_Malloc(BENCHQUEUESIZE * sizeof (*benchqueue), PU_STATIC, NULL);
+	queuehead = queuecount = 0;
+	memset(nodeclient, -1, sizeof (nodeclient));
+
+	oldsend = I_NetSend;
+	oldget = I_NetGet;
+	oldfreenodenum = I_NetFreeNodenum;
+	I_NetSend = NetBench_Send;
+	I_NetGet = NetBench_Get;
+	I_NetFreeNodenum = NetBench_FreeNodenum;
+
+	benchrunning = true;
+	benchstart = I_GetTime();
+	CONS_Printf(M_GetText("Benchmark started with %d clients\n"), benchwanted);
+	return true;
+}
+
+/** Runs the synthetic clients, once per NetUpdate on the server
+  */
+void NetBench_Ticker(void)
+{
+	INT32 i;
+
+	if (!benchwanted)
+		return;
+
+	if (!(server && netgame))
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("No longer hosting a netgame, benchmark cancelled\n"));
+		NetBench_Shutdown();
+		return;
+	}
+
+	if (!benchrunning && !NetBench_Start())
+		return;
+
+	// The network was restarted under us
+	if (I_NetSend != NetBench_Send || I_NetGet != NetBench_Get)
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("The network was restarted, benchmark cancelled\n"));
+		if (!benchstopping)
+			NetBench_Report();
+		NetBench_Shutdown();
+		return;
+	}
+
+	if (!benchstopping && benchduration && I_GetTime() - benchstart >= benchduration)
+		NetBench_Stop();
+
+	for (i = 0; i < benchwanted; i++)
+		NetBench_ClientTicker(&benchclients[i]);
+
+	if (benchstopping)
+	{
+		for (i = 0; i < benchwanted; i++)
+			if (benchclients[i].node != -1)
+				break;
+		if (i == benchwanted || I_GetTime() - benchstop >= BENCHQUITTICS)
+			NetBench_Shutdown();
+	}
+}
+
+/** Records how long the server took to run a tic
+  *
+  * \param micros The time, in microseconds
+  *
+  */
+void NetBench_TicTime(INT32 micros)
+{
+	if (!benchrunning || benchstopping)
+		return;
+
+	if (numtictimes == tictimescapacity)
+	{
+		tictimescapacity = tictimescapacity ? tictimescapacity * 2 : 1024;
+		tictimes = Z_Realloc(tictimes, tictimescapacity * sizeof (*tictimes), PU_STATIC, NULL);
+	}
+	tictimes[numtictimes++] = (UINT32)max(micros, 0);
+}
+
+/** Reads a script of ticcmds for the clients to play
+  *
+  * Each line is "<tics> <forward> <side> <turn> <buttons>", where turn is
+  * added to the angle every tic; lines starting with # are comments.
+  *
+  * \param filename The script, in the home folder
+  * \return False if the file couldn't be read or had no ticcmds
+  *
+  */
+static boolean NetBench_LoadScript(const char *filename)
+{
+	char line[256];
+	INT32 linenum = 0;
+	FILE *f;
+
+	f = fopen(va("%s"PATHSEP"%s", srb2home, filename), "r");
+	if (!f)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't open %s\n"), filename);
+		return false;
+	}
+
+	while (fgets(line, sizeof line, f))
+	{
+		INT32 tics, forward, side, turn, buttons;
+		char *s = line;
+		benchscriptline_t *scriptline;
+
+		linenum++;
+		while (*s == ' ' || *s == '\t')
+			s++;
+		if (*s == '#' || *s == '\n' || *s == '\r' || *s == '\0')
+			continue;
+
+		if (sscanf(s, "%d %d %d %d %i", &tics, &forward, &side, &turn, &buttons) != 5 || tics <= 0)
+		{
+			CONS_Alert(CONS_WARNING, M_GetText("%s:%d: expected <tics> <forward> <side> <turn> <buttons>\n"), filename, linenum);
+			continue;
+		}
+
+		benchscript = Z_Realloc(benchscript, (numbenchscriptlines + 1) * sizeof (*benchscript), PU_STATIC, NULL);
+		scriptline = &benchscript[numbenchscriptlines++];
+		memset(scriptline, 0, sizeof (*scriptline));
+		scriptline->tics = tics;
+		scriptline->cmd.forwardmove = (SINT8)max(min(forward, MAXPLMOVE), -MAXPLMOVE);
+		scriptline->cmd.sidemove = (SINT8)max(min(side, MAXPLMOVE), -MAXPLMOVE);
+		scriptline->cmd.angleturn = (INT16)turn;
+		scriptline->cmd.buttons = (UINT16)buttons;
+	}
+	fclose(f);
+
+	if (!numbenchscriptlines)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("%s has no ticcmds\n"), filename);
+		return false;
+	}
+	return true;
+}
+
+void Command_Netbench_f(void)
+{
+	const char *arg = COM_Argc() >= 2 ? COM_Argv(1) : "";
+	INT32 count;
+
+	if (!stricmp(arg, "stop"))
+	{
+		if (!benchwanted)
+			CONS_Printf(M_GetText("There is no benchmark running.\n"));
+		else if (!benchrunning)
+			NetBench_Clear();
+		else if (!benchstopping)
+			NetBench_Stop();
+		return;
+	}
+
+	if (!*arg)
+	{
+		if (benchrunning)
+			NetBench_Report();
+		else if (benchwanted)
+			CONS_Printf(M_GetText("The benchmark will start once a level is running.\n"));
+		else
+			CONS_Printf(M_GetText("netbench <clients> [<seconds>] [<script>]: Load the server with fake clients\n"
+				"netbench: Show how the benchmark is going\n"
+				"netbench stop: Stop the benchmark and show the results\n"));
+		return;
+	}
+
+	if (benchwanted)
+	{
+		CONS_Printf(M_GetText("A benchmark is already running, use \"netbench stop\" first.\n"));
+		return;
+	}
+
+	if (!(server && netgame))
+	{
+		CONS_Printf(M_GetText("You must be hosting a netgame to run a benchmark.\n"));
+		return;
+	}
+
+	count = atoi(arg);
+	if (count <= 0)
+	{
+		CONS_Printf(M_GetText("The number of clients must be above zero.\n"));
+		return;
+	}
+	if (count > MAXBENCHCLIENTS)
+	{
+		CONS_Printf(M_GetText("Only %d clients fit in the nodes.\n"), MAXBENCHCLIENTS);
+		count = MAXBENCHCLIENTS;
+	}
+
+	benchduration = COM_Argc() >= 3 ? (tic_t)max(atoi(COM_Argv(2)), 0) * TICRATE : 0;
+
+	if (COM_Argc() >= 4 && !NetBench_LoadScript(COM_Argv(3)))
+	{
+		NetBench_Clear();
+		return;
+	}
+
+	benchwanted = count;
+}
+
+#endif
@@ -0,0 +1,23 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2020 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  d_netbench.h
+/// \brief Synthetic clients for load testing a server from its own process
+
+#ifndef __D_NETBENCH__
+#define __D_NETBENCH__
+
+#include "doomtype.h"
+
+#ifndef NONET
+void Command_Netbench_f(void);
+void NetBench_Ticker(void);
+void NetBench_TicTime(INT32 micros);
+#endif
+
+#endif
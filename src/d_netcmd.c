@@ -42,6 +42,7 @@
 #include "filesrch.h"
 #include "mserv.h"
 #include "z_zone.h"
+#include "dehacked.h" // cv_constantcache
 #include "lua_script.h"
 #include "lua_hook.h"
 #include "m_cond.h"
@@ -511,6 +512,8 @@ void D_RegisterServerCommands(void)
 	CV_RegisterVar(&cv_itemrespawntime);
 	CV_RegisterVar(&cv_itemrespawn);
 	CV_RegisterVar(&cv_flagtime);
+	CV_RegisterVar(&cv_dormancy);
+	CV_RegisterVar(&cv_dormancydist);
 
 	// misc
 	CV_RegisterVar(&cv_friendlyfire);
@@ -582,7 +585,9 @@ void D_RegisterServerCommands(void)
 	CV_RegisterVar(&cv_maxsend);
 	CV_RegisterVar(&cv_noticedownload);
 	CV_RegisterVar(&cv_downloadspeed);
+	CV_RegisterVar(&cv_httpsource);
 #ifndef NONET
+	CV_RegisterVar(&cv_netsavecompression);
 	CV_RegisterVar(&cv_allownewplayer);
 	CV_RegisterVar(&cv_joinnextround);
 	CV_RegisterVar(&cv_showjoinaddress);
@@ -603,6 +608,19 @@ void D_RegisterServerCommands(void)
 	 CV_RegisterVar(&cv_allowseenames);
 #endif
 
+	// p_tick, here so dedicated servers get it too
+	CV_RegisterVar(&cv_thinkerprofile);
+	CV_RegisterVar(&cv_thinkerprofilewindow);
+	COM_AddCommand("thinkerprof", Command_Thinkerprof_f);
+
+	// lua_hooklib
+	CV_RegisterVar(&cv_hookprofile);
+	CV_RegisterVar(&cv_hookprofiledump);
+	COM_AddCommand("hookprof", Command_Hookprof_f);
+
+	// lib_getenum in dehacked.c
+	CV_RegisterVar(&cv_constantcache);
+
 	CV_RegisterVar(&cv_dummyconsvar);
 }
 
@@ -637,6 +655,7 @@ void D_RegisterClientCommands(void)
 
 	COM_AddCommand("numthinkers", Command_Numthinkers_f);
 	COM_AddCommand("countmobjs", Command_CountMobjs_f);
+	COM_AddCommand("checkposbench", Command_Checkposbench_f);
 
 	COM_AddCommand("changeteam", Command_Teamchange_f);
 	COM_AddCommand("changeteam2", Command_Teamchange2_f);
@@ -56,6 +56,7 @@ extern consvar_t cv_itemrespawntime;
 extern consvar_t cv_itemrespawn;
 
 extern consvar_t cv_flagtime;
+extern consvar_t cv_dormancy, cv_dormancydist;
 
 extern consvar_t cv_touchtag;
 extern consvar_t cv_hidetime;
@@ -52,11 +52,20 @@
 #include "m_menu.h"
 #include "md5.h"
 #include "filesrch.h"
+#include "i_threads.h"
 
 #include <errno.h>
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_CURL
+#include <curl/curl.h>
+#endif
+
 // Prototypes
-static boolean AddFileToSendQueue(INT32 node, const char *filename, UINT8 fileid);
+static boolean AddFileToSendQueue(INT32 node, const char *filename, UINT8 fileid, boolean compress);
 
 // Sender structure
 typedef struct filetx_s
@@ -67,22 +76,42 @@ typedef struct filetx_s
 		char *ram; // Pointer to the data in RAM
 	} id;
 	UINT32 size; // Size of the file
+	boolean compressed; // The file is a zlib stream of the requested file
 	UINT8 fileid;
 	INT32 node; // Destination
 	struct filetx_s *next; // Next file in the list
 } filetx_t;
 
+// A fragment that has been sent and is waiting to be acknowledged
+typedef struct
+{
+	UINT32 fragment;
+	tic_t senttic; // Same as the fragment's senttics entry when it was sent
+} fileinflight_t;
+
+// Most fragments a node can have in flight at once
+#define MAXFILEWINDOW 512
+
 // Current transfers (one for each node)
 typedef struct filetran_s
 {
 	filetx_t *txlist; // Linked list of all files for the node
 	UINT8 iteration;
-	UINT8 ackediteration;
 	UINT32 position; // The current position in the file
 	boolean *ackedfragments;
 	UINT32 ackedsize;
 	FILE *currentfile; // The file currently being sent/received
-	tic_t dontsenduntil;
+
+	// Congestion control
+	tic_t *senttics; // When each fragment in flight was sent, plus one; 0 if it isn't in flight
+	boolean *resentfragments; // Fragments that were given up on once, so their acks can't be timed
+	fileinflight_t *sentqueue; // Fragments in flight, oldest first
+	UINT32 sentqueuehead, sentqueuecount;
+	UINT32 inflight; // Fragments sent but neither acknowledged nor given up on yet
+	fixed_t cwnd; // Congestion window, in fragments
+	fixed_t ssthresh; // Slow start threshold, in fragments
+	fixed_t srtt, rttvar; // Smoothed round-trip time and its variation, in tics
+	tic_t recoveryend; // Losses before this are part of the same congestion event
 } filetran_t;
 static filetran_t transfer[MAXNETNODES];
 
@@ -103,6 +132,8 @@ typedef struct
 	boolean *receivedfragments;
 	UINT32 fragmentsize;
 	UINT32 currentsize;
+	UINT32 totalsize;
+	boolean compressed;
 } pauseddownload_t;
 static pauseddownload_t *pauseddownload = NULL;
 
@@ -278,7 +309,21 @@ static boolean CL_CanResumeDownload(fileneeded_t *file)
 	return pauseddownload
 		&& !strcmp(pauseddownload->filename, file->filename) // Same name
 		&& !memcmp(pauseddownload->md5sum, file->md5sum, 16) // Same checksum
-		&& pauseddownload->fragmentsize == file->fragmentsize; // Same fragment size
+		&& pauseddownload->fragmentsize == file->fragmentsize // Same fragment size
+		&& pauseddownload->compressed == file->compressed // Same encoding
+		&& pauseddownload->totalsize == file->totalsize; // Same stream size
+}
+
+/** Gets the name of the file a download is written to as it is received
+  *
+  * \param filename The name of the needed file
+  * \param compressed True if the server sends a zlib stream of the file
+  * \return The name of the file, possibly in a va buffer
+  *
+  */
+static const char *DownloadStreamName(const char *filename, boolean compressed)
+{
+	return compressed ? va("%s.z", filename) : filename;
 }
 
 void CL_AbortDownloadResume(void)
@@ -287,7 +332,7 @@ void CL_AbortDownloadResume(void)
 		return;
 
 	free(pauseddownload->receivedfragments);
-	remove(pauseddownload->filename);
+	remove(DownloadStreamName(pauseddownload->filename, pauseddownload->compressed));
 	free(pauseddownload);
 	pauseddownload = NULL;
 }
@@ -304,6 +349,9 @@ boolean CL_SendFileRequest(void)
 	char *p;
 	INT32 i;
 	INT64 totalfreespaceneeded = 0, availablefreespace;
+#ifdef HAVE_ZLIB
+	INT64 largestfile = 0;
+#endif
 
 #ifdef PARANOIA
 	if (M_CheckParm("-nodownload"))
@@ -323,6 +371,10 @@ boolean CL_SendFileRequest(void)
 		if ((fileneeded[i].status == FS_NOTFOUND || fileneeded[i].status == FS_MD5SUMBAD))
 		{
 			totalfreespaceneeded += fileneeded[i].totalsize;
+#ifdef HAVE_ZLIB
+			if (fileneeded[i].totalsize > largestfile)
+				largestfile = fileneeded[i].totalsize;
+#endif
 			nameonly(fileneeded[i].filename);
 			WRITEUINT8(p, i); // fileid
 			WRITESTRINGN(p, fileneeded[i].filename, MAX_WADPATH);
@@ -331,6 +383,13 @@ boolean CL_SendFileRequest(void)
 			fileneeded[i].status = FS_REQUESTED;
 		}
 	WRITEUINT8(p, 0xFF);
+#ifdef HAVE_ZLIB
+	WRITEUINT8(p, FILEREQUEST_ZLIB); // Older servers stop reading at 0xFF
+
+	// A compressed stream is kept next to the file it inflates to until the
+	// download is done, and it is never bigger than that file
+	totalfreespaceneeded += largestfile;
+#endif
 	I_GetDiskFreeSpace(&availablefreespace);
 	if (totalfreespaceneeded > availablefreespace)
 		I_Error("To play on this server you must download %s KB,\n"
@@ -349,13 +408,27 @@ boolean PT_RequestFile(INT32 node)
 	char wad[MAX_WADPATH+1];
 	UINT8 *p = netbuffer->u.textcmd;
 	UINT8 id;
+	UINT8 flags = 0;
+
+	// Look for the flags after the file list first
+	while (p < netbuffer->u.textcmd + MAXTEXTCMD-1) // Don't allow hacked client to overflow
+	{
+		id = READUINT8(p);
+		if (id == 0xFF)
+			break;
+		READSTRINGN(p, wad, MAX_WADPATH);
+	}
+	if (p < (UINT8 *)netbuffer + doomcom->datalength)
+		flags = READUINT8(p);
+
+	p = netbuffer->u.textcmd;
 	while (p < netbuffer->u.textcmd + MAXTEXTCMD-1) // Don't allow hacked client to overflow
 	{
 		id = READUINT8(p);
 		if (id == 0xFF)
 			break;
 		READSTRINGN(p, wad, MAX_WADPATH);
-		if (!AddFileToSendQueue(node, wad, id))
+		if (!AddFileToSendQueue(node, wad, id, (flags & FILEREQUEST_ZLIB) != 0))
 		{
 			SV_AbortSendFiles(node);
 			return false; // don't read the rest of the files
@@ -696,16 +769,260 @@ void CL_PrepareDownloadLuaFile(void)
 // Little optimization to quickly test if there is a file in the queue
 static INT32 filestosend = 0;
 
+#if defined (HAVE_ZLIB) && !defined (NOMD5)
+// Compressed copies of the loaded files are kept in this directory,
+// named after their MD5, so each file only ever gets compressed once.
+// An empty copy means the file didn't get any smaller.
+#define NETCACHEDIR "netcache"
+
+typedef enum
+{
+	NETCACHE_UNKNOWN, // Not looked for yet
+	NETCACHE_READY,
+	NETCACHE_PENDING, // Being compressed
+	NETCACHE_NONE // Send the file as is
+} netcachestatus_t;
+static UINT8 netcachestatus[MAX_WADFILES];
+
+// A file waiting to be compressed
+typedef struct netcachejob_s
+{
+	UINT16 wadnum;
+	UINT32 filesize;
+	char filename[MAX_WADPATH];
+	char cachename[MAX_WADPATH];
+	struct netcachejob_s *next;
+} netcachejob_t;
+
+#ifdef HAVE_THREADS
+static I_mutex netcache_mutex;
+#  define Lock_netcache()   I_lock_mutex  (&netcache_mutex)
+#  define Unlock_netcache() I_unlock_mutex (netcache_mutex)
+#else
+#  define Lock_netcache()
+#  define Unlock_netcache()
+#endif
+
+/** Writes a zlib stream of a file
+  *
+  * \param srcname The file to compress
+  * \param destname The file to write the stream to
+  * \param srcsize The size of the file to compress
+  * \return True if the stream was written and is smaller than the file
+  *
+  */
+static boolean SV_CompressFile(const char *srcname, const char *destname, UINT32 srcsize)
+{
+	UINT8 inbuf[16384], outbuf[16384]; // Not static, files can be compressed on another thread
+	char tmpname[MAX_WADPATH+8];
+	FILE *in, *out;
+	z_stream stream;
+	size_t len;
+	INT32 flush;
+	boolean ok = true, smaller = true;
+
+	snprintf(tmpname, sizeof tmpname, "%s.tmp", destname);
+
+	in = fopen(srcname, "rb");
+	if (!in)
+		return false;
+	out = fopen(tmpname, "wb");
+	if (!out)
+	{
+		fclose(in);
+		return false;
+	}
+
+	memset(&stream, 0, sizeof (stream));
+	if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		fclose(out);
+		fclose(in);
+		remove(tmpname);
+		return false;
+	}
+
+	do
+	{
+		len = fread(inbuf, 1, sizeof (inbuf), in);
+		if (ferror(in)
+#ifdef HAVE_THREADS
+			|| I_thread_is_stopped() // Quitting, finish it on the next run
+#endif
+		)
+		{
+			ok = false;
+			break;
+		}
+		flush = feof(in) ? Z_FINISH : Z_NO_FLUSH;
+
+		stream.next_in = inbuf;
+		stream.avail_in = (uInt)len;
+		do
+		{
+			stream.next_out = outbuf;
+			stream.avail_out = sizeof (outbuf);
+			deflate(&stream, flush); // Can't fail with a valid stream and output room
+			len = sizeof (outbuf) - stream.avail_out;
+			if (len && fwrite(outbuf, 1, len, out) != len)
+				ok = false;
+		} while (ok && stream.avail_out == 0);
+
+		if (stream.total_out >= srcsize) // Not worth it, leave an empty copy
+			smaller = false;
+	} while (ok && smaller && flush != Z_FINISH);
+
+	deflateEnd(&stream);
+	fclose(in);
+	if (!smaller)
+		out = freopen(tmpname, "wb", out);
+	if (!out || fclose(out))
+		ok = false;
+
+	if (ok)
+	{
+		remove(destname);
+		ok = !rename(tmpname, destname);
+	}
+	if (!ok)
+		remove(tmpname);
+	return ok && smaller;
+}
+
+static void SV_NetCacheName(UINT16 wadnum, char *cachename)
+{
+	char md5hex[33];
+	INT32 i;
+
+	for (i = 0; i < 16; i++)
+		sprintf(&md5hex[i*2], "%02x", wadfiles[wadnum]->md5sum[i]);
+	snprintf(cachename, MAX_WADPATH, "%s" PATHSEP NETCACHEDIR PATHSEP "%s.z", srb2home, md5hex);
+}
+
+/** Compresses a list of files, then frees it
+  *
+  * \param jobs The files to compress
+  *
+  */
+static void SV_CompressFiles(netcachejob_t *jobs)
+{
+	netcachejob_t *next;
+	INT64 freespace;
+	UINT8 status;
+
+	for (; jobs; jobs = next)
+	{
+		next = jobs->next;
+
+		// The copy is at most as big as the file
+		I_GetDiskFreeSpace(&freespace);
+		if (freespace > jobs->filesize
+			&& SV_CompressFile(jobs->filename, jobs->cachename, jobs->filesize))
+			status = NETCACHE_READY;
+		else
+			status = NETCACHE_NONE;
+
+		Lock_netcache();
+		netcachestatus[jobs->wadnum] = status;
+		Unlock_netcache();
+
+		free(jobs);
+	}
+}
+
+/** Compresses the loaded files that can be downloaded and aren't in the
+  * cache yet, in the background if possible
+  *
+  * \sa SV_CompressedFileName
+  *
+  */
+void SV_PrepareNetCache(void)
+{
+	netcachejob_t *jobs = NULL, **tail = &jobs;
+	char cachename[MAX_WADPATH];
+	struct stat st;
+	UINT16 i;
+
+	Lock_netcache();
+	for (i = mainwads; i < numwadfiles; i++)
+	{
+		if (netcachestatus[i] != NETCACHE_UNKNOWN || !wadfiles[i]->important
+			|| wadfiles[i]->filesize > (UINT32)cv_maxsend.value * 1024)
+			continue;
+
+		SV_NetCacheName(i, cachename);
+		if (!stat(cachename, &st)) // Compressed by an earlier run
+		{
+			netcachestatus[i] = st.st_size ? NETCACHE_READY : NETCACHE_NONE;
+			continue;
+		}
+
+		*tail = malloc(sizeof (netcachejob_t));
+		if (!*tail)
+			break;
+		(*tail)->wadnum = i;
+		(*tail)->filesize = wadfiles[i]->filesize;
+		strlcpy((*tail)->filename, wadfiles[i]->filename, MAX_WADPATH);
+		strlcpy((*tail)->cachename, cachename, MAX_WADPATH);
+		(*tail)->next = NULL;
+		tail = &(*tail)->next;
+
+		netcachestatus[i] = NETCACHE_PENDING;
+		CONS_Printf(M_GetText("Compressing %s for downloads...\n"), wadfiles[i]->filename);
+	}
+	Unlock_netcache();
+
+	if (!jobs)
+		return;
+
+	I_mkdir(va("%s" PATHSEP NETCACHEDIR, srb2home), 0755);
+#ifdef HAVE_THREADS
+	I_spawn_thread("compress-files", (I_thread_fn)SV_CompressFiles, jobs);
+#else
+	SV_CompressFiles(jobs);
+#endif
+}
+
+/** Gets the compressed copy of a loaded file
+  *
+  * \param wadnum The index of the file in wadfiles
+  * \return The name of the compressed copy, or NULL if the file should be sent as is
+  * \sa SV_PrepareNetCache
+  *
+  */
+static const char *SV_CompressedFileName(UINT16 wadnum)
+{
+	static char cachename[MAX_WADPATH];
+	UINT8 status;
+
+	Lock_netcache();
+	status = netcachestatus[wadnum];
+	Unlock_netcache();
+
+	if (status != NETCACHE_READY) // Not compressed yet, or not worth it
+		return NULL;
+
+	SV_NetCacheName(wadnum, cachename);
+	return cachename;
+}
+#else
+void SV_PrepareNetCache(void)
+{
+	// Files are always sent as is
+}
+#endif
+
 /** Adds a file to the file list for a node
   *
   * \param node The node to send the file to
   * \param filename The file to send
   * \param fileid The index of the file in the list of added files
+  * \param compress True to send a zlib stream of the file if it makes it smaller
   * \sa AddRamToSendQueue
   * \sa AddLuaFileToSendQueue
   *
   */
-static boolean AddFileToSendQueue(INT32 node, const char *filename, UINT8 fileid)
+static boolean AddFileToSendQueue(INT32 node, const char *filename, UINT8 fileid, boolean compress)
 {
 	filetx_t **q; // A pointer to the "next" field of the last file in the list
 	filetx_t *p; // The new file request
@@ -777,6 +1094,20 @@ static boolean AddFileToSendQueue(INT32 node, const char *filename, UINT8 fileid
 		return false; // cancel the rest of the requests
 	}
 
+#if defined (HAVE_ZLIB) && !defined (NOMD5)
+	if (compress)
+	{
+		const char *cachename = SV_CompressedFileName((UINT16)i);
+		if (cachename)
+		{
+			strlcpy(p->id.filename, cachename, MAX_WADPATH);
+			p->compressed = true;
+		}
+	}
+#else
+	(void)compress;
+#endif
+
 	DEBFILE(va("Sending file %s (id=%d) to %d\n", filename, fileid, node));
 	p->ram = SF_FILE; // It's a file, we need to close it and free its name once we're done sending it
 	p->fileid = fileid;
@@ -910,6 +1241,12 @@ static void SV_EndFileSend(INT32 node)
 	if (transfer[node].ackedfragments)
 		free(transfer[node].ackedfragments);
 	transfer[node].ackedfragments = NULL;
+	free(transfer[node].senttics);
+	transfer[node].senttics = NULL;
+	free(transfer[node].resentfragments);
+	transfer[node].resentfragments = NULL;
+	free(transfer[node].sentqueue);
+	transfer[node].sentqueue = NULL;
 
 	filestosend--;
 }
@@ -917,64 +1254,201 @@ static void SV_EndFileSend(INT32 node)
 #define PACKETPERTIC net_bandwidth/(TICRATE*software_MAXPACKETLENGTH)
 #define FILEFRAGMENTSIZE (software_MAXPACKETLENGTH - (FILETXHEADER + BASEPACKETSIZE))
 
+// Each node gets its own congestion window, grown as fragments get
+// acknowledged and halved when they get lost (AIMD, as in TCP Reno).
+// A fragment counts as lost when it hasn't been acknowledged after
+// the retransmission timeout, which follows the measured round-trip time.
+
+/** Gives a new transfer its initial congestion window
+  *
+  * \param trans The transfer
+  *
+  */
+static void FileWindow_Init(filetran_t *trans)
+{
+	trans->sentqueuehead = trans->sentqueuecount = 0;
+	trans->inflight = 0;
+	trans->cwnd = 16*FRACUNIT; // The old fixed rate, so good links don't start slower
+	trans->ssthresh = MAXFILEWINDOW*FRACUNIT;
+	trans->srtt = trans->rttvar = 0;
+	trans->recoveryend = 0;
+}
+
+/** Returns how long to wait for the acknowledgement of a fragment before resending it
+  *
+  * \param trans The transfer
+  *
+  */
+static tic_t FileWindow_Timeout(filetran_t *trans)
+{
+	tic_t rto;
+
+	if (!trans->srtt) // No sample yet
+		return TICRATE/2;
+
+	rto = (tic_t)((trans->srtt + 4*trans->rttvar) >> FRACBITS) + 1;
+	return min(max(rto, 2), 2*TICRATE);
+}
+
+/** Shrinks the congestion window after a loss, once per round trip
+  *
+  * \param trans The transfer
+  *
+  */
+static void FileWindow_Loss(filetran_t *trans)
+{
+	const tic_t now = I_GetTime();
+
+	if (now < trans->recoveryend)
+		return;
+
+	trans->ssthresh = max(trans->cwnd / 2, 2*FRACUNIT);
+	trans->cwnd = trans->ssthresh;
+	trans->recoveryend = now + (tic_t)(trans->srtt >> FRACBITS) + 1;
+}
+
+/** Updates the congestion window when a fragment gets acknowledged
+  *
+  * \param trans    The transfer
+  * \param fragment The fragment that was acknowledged
+  *
+  */
+static void FileWindow_Ack(filetran_t *trans, UINT32 fragment)
+{
+	fixed_t rtt;
+
+	if (!trans->senttics[fragment]) // Already given up on, or never sent
+		return;
+
+	// Sample the round-trip time, unless the fragment was sent more than once,
+	// since the ack could then be for any of the copies (Karn's algorithm)
+	if (!trans->resentfragments[fragment])
+	{
+		rtt = (fixed_t)(I_GetTime() - (trans->senttics[fragment] - 1)) * FRACUNIT;
+		if (!trans->srtt)
+		{
+			trans->srtt = max(rtt, FRACUNIT);
+			trans->rttvar = trans->srtt / 2;
+		}
+		else
+		{
+			trans->rttvar += (abs(trans->srtt - rtt) - trans->rttvar) / 4;
+			trans->srtt += (rtt - trans->srtt) / 8;
+		}
+	}
+
+	trans->senttics[fragment] = 0;
+	trans->inflight--;
+
+	if (trans->cwnd < trans->ssthresh) // Slow start
+		trans->cwnd += FRACUNIT;
+	else // Congestion avoidance, about one more fragment per round trip
+		trans->cwnd += max(FRACUNIT / (trans->cwnd >> FRACBITS), 1);
+	trans->cwnd = min(trans->cwnd, MAXFILEWINDOW*FRACUNIT);
+}
+
+/** Forgets about the oldest fragments in flight if they have been acknowledged,
+  * resent, or waited on for too long, in which case they are lost
+  *
+  * \param trans The transfer
+  *
+  */
+static void FileWindow_Expire(filetran_t *trans)
+{
+	const tic_t now = I_GetTime();
+	const tic_t timeout = FileWindow_Timeout(trans);
+
+	while (trans->sentqueuecount)
+	{
+		fileinflight_t *sent = &trans->sentqueue[trans->sentqueuehead];
+
+		if (trans->senttics[sent->fragment] == sent->senttic)
+		{
+			if (now - (sent->senttic - 1) < timeout)
+				break; // Still waiting for this one
+
+			// Lost, let it be sent again
+			trans->senttics[sent->fragment] = 0;
+			trans->resentfragments[sent->fragment] = true;
+			trans->inflight--;
+			FileWindow_Loss(trans);
+		}
+
+		trans->sentqueuehead = (trans->sentqueuehead + 1) % MAXFILEWINDOW;
+		trans->sentqueuecount--;
+	}
+}
+
 /** Handles file transmission
+  *
+  * Fragments are given to the nodes one at a time in turn, to those
+  * whose congestion window isn't full, while staying below a global
+  * budget of cv_downloadspeed packets per tic. Whatever else the server
+  * sent since the last call, like PT_SERVERTICS, is taken out of that budget.
   *
   */
 void FileSendTicker(void)
 {
 	static INT32 currentnode = 0;
+	static INT64 lastsendbytes = 0;
 	filetx_pak *p;
 	size_t fragmentsize;
 	filetx_t *f;
-	INT32 packetsent, ram, i, j;
+	INT32 ram, i, idle;
+	INT64 budget;
+	boolean sent = false;
 
 	if (!filestosend) // No file to send
+	{
+		lastsendbytes = sendbytes;
 		return;
+	}
 
 	if (cv_downloadspeed.value) // New behavior
-		packetsent = cv_downloadspeed.value;
+		budget = cv_downloadspeed.value;
 	else // Old behavior
 	{
-		packetsent = PACKETPERTIC;
-		if (!packetsent)
-			packetsent = 1;
+		budget = PACKETPERTIC;
+		if (!budget)
+			budget = 1;
 	}
+	budget *= software_MAXPACKETLENGTH;
+	budget -= sendbytes - lastsendbytes; // Leave room for the game
 
 	netbuffer->packettype = PT_FILEFRAGMENT;
 
-	// (((sendbytes-nowsentbyte)*TICRATE)/(I_GetTime()-starttime)<(UINT32)net_bandwidth)
-	while (packetsent-- && filestosend != 0)
+	// Stop once every node in a row had nothing it could send
+	for (idle = 0; idle < MAXNETNODES && filestosend != 0 && (budget > 0 || !sent); idle++)
 	{
-		for (i = currentnode, j = 0; j < MAXNETNODES;
-			i = (i+1) % MAXNETNODES, j++)
-		{
-			if (transfer[i].txlist)
-				break;
-		}
-		// no transfer to do
-		if (j >= MAXNETNODES)
-			I_Error("filestosend=%d but no file to send found\n", filestosend);
+		filetran_t *trans;
+		UINT32 numfragments, fragment, k;
 
+		i = currentnode;
 		currentnode = (i+1) % MAXNETNODES;
-		f = transfer[i].txlist;
+		trans = &transfer[i];
+
+		if (!trans->txlist)
+			continue;
+
+		f = trans->txlist;
 		ram = f->ram;
 
 		// Open the file if it isn't open yet, or
-		if (!transfer[i].currentfile)
+		if (!trans->currentfile)
 		{
 			if (!ram) // Sending a file
 			{
 				long filesize;
 
-				transfer[i].currentfile =
+				trans->currentfile =
 					fopen(f->id.filename, "rb");
 
-				if (!transfer[i].currentfile)
+				if (!trans->currentfile)
 					I_Error("File %s does not exist",
 						f->id.filename);
 
-				fseek(transfer[i].currentfile, 0, SEEK_END);
-				filesize = ftell(transfer[i].currentfile);
+				fseek(trans->currentfile, 0, SEEK_END);
+				filesize = ftell(trans->currentfile);
 
 				// Nobody wants to transfer a file bigger
 				// than 4GB!
@@ -984,82 +1458,100 @@ void FileSendTicker(void)
 					I_Error("Error getting filesize of %s", f->id.filename);
 
 				f->size = (UINT32)filesize;
-				fseek(transfer[i].currentfile, 0, SEEK_SET);
+				fseek(trans->currentfile, 0, SEEK_SET);
 			}
 			else // Sending RAM
-				transfer[i].currentfile = (FILE *)1; // Set currentfile to a non-null value to indicate that it is open
+				trans->currentfile = (FILE *)1; // Set currentfile to a non-null value to indicate that it is open
 
-			transfer[i].iteration = 1;
-			transfer[i].ackediteration = 0;
-			transfer[i].position = 0;
-			transfer[i].ackedsize = 0;
+			trans->iteration = 1;
+			trans->position = 0;
+			trans->ackedsize = 0;
 
-			transfer[i].ackedfragments = calloc(f->size / FILEFRAGMENTSIZE + 1, sizeof(*transfer[i].ackedfragments));
-			if (!transfer[i].ackedfragments)
+			trans->ackedfragments = calloc(f->size / FILEFRAGMENTSIZE + 1, sizeof(*trans->ackedfragments));
+			trans->senttics = calloc(f->size / FILEFRAGMENTSIZE + 1, sizeof(*trans->senttics));
+			trans->resentfragments = calloc(f->size / FILEFRAGMENTSIZE + 1, sizeof(*trans->resentfragments));
+			trans->sentqueue = malloc(MAXFILEWINDOW * sizeof(*trans->sentqueue));
+			if (!(trans->ackedfragments && trans->senttics && trans->resentfragments && trans->sentqueue))
 				I_Error("FileSendTicker: No more memory\n");
 
-			transfer[i].dontsenduntil = 0;
+			FileWindow_Init(trans);
 		}
 
-		// If the client hasn't acknowledged any fragment from the previous iteration,
-		// it is most likely because their acks haven't had enough time to reach the server
-		// yet, due to latency. In that case, we wait a little to avoid useless resend.
-		if (I_GetTime() < transfer[i].dontsenduntil)
+		FileWindow_Expire(trans);
+
+		// Wait for acknowledgements if the window is full
+		if (trans->inflight >= (UINT32)max(trans->cwnd >> FRACBITS, 1)
+			|| trans->sentqueuecount == MAXFILEWINDOW)
 			continue;
 
-		// Find the first non-acknowledged fragment
-		while (transfer[i].ackedfragments[transfer[i].position / FILEFRAGMENTSIZE])
+		// Find the next fragment that is neither acknowledged nor in flight,
+		// going around the file once at most
+		numfragments = f->size / FILEFRAGMENTSIZE + 1;
+		for (k = 0; k < numfragments; k++)
 		{
-			transfer[i].position += FILEFRAGMENTSIZE;
-			if (transfer[i].position >= f->size)
-			{
-				if (transfer[i].ackediteration < transfer[i].iteration)
-					transfer[i].dontsenduntil = I_GetTime() + TICRATE / 2;
+			fragment = trans->position / FILEFRAGMENTSIZE;
+			if (!(trans->ackedfragments[fragment] || trans->senttics[fragment]))
+				break;
 
-				transfer[i].position = 0;
-				transfer[i].iteration++;
+			trans->position += FILEFRAGMENTSIZE;
+			if (trans->position >= f->size)
+			{
+				trans->position = 0;
+				trans->iteration++;
 			}
 		}
+		if (k == numfragments) // Everything left is in flight
+			continue;
 
 		// Build a packet containing a file fragment
 		p = &netbuffer->u.filetxpak;
 		fragmentsize = FILEFRAGMENTSIZE;
-		if (f->size-transfer[i].position < fragmentsize)
-			fragmentsize = f->size-transfer[i].position;
+		if (f->size-trans->position < fragmentsize)
+			fragmentsize = f->size-trans->position;
 		if (ram)
-			M_Memcpy(p->data, &f->id.ram[transfer[i].position], fragmentsize);
+			M_Memcpy(p->data, &f->id.ram[trans->position], fragmentsize);
 		else
 		{
-			fseek(transfer[i].currentfile, transfer[i].position, SEEK_SET);
+			fseek(trans->currentfile, trans->position, SEEK_SET);
 
-			if (fread(p->data, 1, fragmentsize, transfer[i].currentfile) != fragmentsize)
-				I_Error("FileSendTicker: can't read %s byte on %s at %d because %s", sizeu1(fragmentsize), f->id.filename, transfer[i].position, M_FileError(transfer[i].currentfile));
+			if (fread(p->data, 1, fragmentsize, trans->currentfile) != fragmentsize)
+				I_Error("FileSendTicker: can't read %s byte on %s at %d because %s", sizeu1(fragmentsize), f->id.filename, trans->position, M_FileError(trans->currentfile));
 		}
-		p->iteration = transfer[i].iteration;
-		p->position = LONG(transfer[i].position);
+		p->iteration = trans->iteration;
+		p->position = LONG(trans->position);
 		p->fileid = f->fileid;
-		p->filesize = LONG(f->size);
+		p->filesize = LONG(f->size | (f->compressed ? FILETX_ZLIB : 0));
 		p->size = SHORT((UINT16)FILEFRAGMENTSIZE);
 
 		// Send the packet
 		if (HSendPacket(i, false, 0, FILETXHEADER + fragmentsize)) // Don't use the default acknowledgement system
 		{ // Success
-			transfer[i].position = (UINT32)(transfer[i].position + fragmentsize);
-			if (transfer[i].position >= f->size)
-			{
-				if (transfer[i].ackediteration < transfer[i].iteration)
-					transfer[i].dontsenduntil = I_GetTime() + TICRATE / 2;
+			fileinflight_t *inflight = &trans->sentqueue[(trans->sentqueuehead + trans->sentqueuecount) % MAXFILEWINDOW];
 
-				transfer[i].position = 0;
-				transfer[i].iteration++;
+			inflight->fragment = fragment;
+			inflight->senttic = trans->senttics[fragment] = I_GetTime() + 1;
+			trans->sentqueuecount++;
+			trans->inflight++;
+
+			budget -= FILETXHEADER + BASEPACKETSIZE + fragmentsize;
+			sent = true;
+			idle = -1; // This node sent something, go around again
+
+			trans->position = (UINT32)(trans->position + fragmentsize);
+			if (trans->position >= f->size)
+			{
+				trans->position = 0;
+				trans->iteration++;
 			}
 		}
 		else
 		{ // Not sent for some odd reason, retry at next call
-			// Exit the while (can't send this one so why should i send the next?)
+			// Exit the loop (can't send this one so why should i send the next?)
 			break;
 		}
 	}
+
+	lastsendbytes = sendbytes;
 }
 
 void PT_FileAck(void)
@@ -1079,12 +1571,9 @@ void PT_FileAck(void)
 		return;
 	}
 
-	if (packet->iteration > trans->ackediteration)
-	{
-		trans->ackediteration = packet->iteration;
-		if (trans->ackediteration >= trans->iteration - 1)
-			trans->dontsenduntil = 0;
-	}
+	// Acks for a file we haven't started sending yet?
+	if (!trans->ackedfragments)
+		return;
 
 	for (i = 0; i < packet->numsegments; i++)
 	{
@@ -1093,15 +1582,18 @@ void PT_FileAck(void)
 		for (j = 0; j < 32; j++)
 			if (LONG(segment->acks) & (1 << j))
 			{
-				if (LONG(segment->start) * FILEFRAGMENTSIZE >= trans->txlist->size)
+				const UINT32 fragment = (UINT32)LONG(segment->start) + j;
+
+				if ((UINT64)fragment * FILEFRAGMENTSIZE >= trans->txlist->size)
 				{
 					Net_CloseConnection(node);
 					return;
 				}
 
-				if (!trans->ackedfragments[LONG(segment->start) + j])
+				if (!trans->ackedfragments[fragment])
 				{
-					trans->ackedfragments[LONG(segment->start) + j] = true;
+					FileWindow_Ack(trans, fragment);
+					trans->ackedfragments[fragment] = true;
 					trans->ackedsize += FILEFRAGMENTSIZE;
 
 					// If the last missing fragment was acked, finish!
@@ -1206,6 +1698,86 @@ void FileReceiveTicker(void)
 	}
 }
 
+#ifdef HAVE_ZLIB
+/** Starts rebuilding a file from the zlib stream being downloaded
+  *
+  * \param file The file being downloaded
+  *
+  */
+static void CL_StartInflating(fileneeded_t *file)
+{
+	z_stream *stream = calloc(1, sizeof (*stream));
+
+	if (!stream)
+		I_Error("PT_FileFragment: No more memory\n");
+	if (inflateInit(stream) != Z_OK)
+		I_Error("PT_FileFragment: Can't initialise zlib\n");
+	file->zstream = stream;
+	file->inflatedfragments = 0;
+
+	file->inflatedfile = fopen(file->filename, "wb");
+	if (!file->inflatedfile)
+		I_Error("Can't create file %s: %s", file->filename, strerror(errno));
+}
+
+/** Inflates the fragments received in a row since the last call
+  *
+  * \param file The file being downloaded
+  *
+  */
+static void CL_InflateFragments(fileneeded_t *file)
+{
+	static UINT8 inbuf[65536], outbuf[65536];
+	z_stream *stream = file->zstream;
+	UINT32 numfragments = (file->totalsize + file->fragmentsize - 1) / file->fragmentsize;
+	UINT32 position;
+	size_t len;
+	INT32 ret;
+
+	while (file->inflatedfragments < numfragments && file->receivedfragments[file->inflatedfragments])
+	{
+		position = file->inflatedfragments * file->fragmentsize;
+		len = min(file->fragmentsize, file->totalsize - position);
+
+		fseek(file->file, position, SEEK_SET);
+		if (fread(inbuf, 1, len, file->file) != len)
+			I_Error("Can't read %s: %s\n", file->filename, M_FileError(file->file));
+
+		stream->next_in = inbuf;
+		stream->avail_in = (uInt)len;
+		do
+		{
+			stream->next_out = outbuf;
+			stream->avail_out = sizeof (outbuf);
+			ret = inflate(stream, Z_NO_FLUSH);
+			if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+				I_Error("Corrupt download of %s\n", file->filename);
+
+			len = sizeof (outbuf) - stream->avail_out;
+			if (len && fwrite(outbuf, 1, len, file->inflatedfile) != len)
+				I_Error("Can't write to %s: %s\n", file->filename, M_FileError(file->inflatedfile));
+		} while (stream->avail_out == 0);
+
+		file->inflatedfragments++;
+	}
+}
+
+/** Stops rebuilding a file from the zlib stream being downloaded
+  *
+  * \param file The file being downloaded
+  *
+  */
+static void CL_StopInflating(fileneeded_t *file)
+{
+	inflateEnd(file->zstream);
+	free(file->zstream);
+	file->zstream = NULL;
+
+	fclose(file->inflatedfile);
+	file->inflatedfile = NULL;
+}
+#endif
+
 void PT_FileFragment(void)
 {
 	INT32 filenum = netbuffer->u.filetxpak.fileid;
@@ -1237,12 +1809,20 @@ void PT_FileFragment(void)
 
 	if (file->status == FS_REQUESTED)
 	{
+		UINT32 filesize = LONG(netbuffer->u.filetxpak.filesize);
+
 		if (file->file)
 			I_Error("PT_FileFragment: already open file\n");
 
 		file->status = FS_DOWNLOADING;
 		file->fragmentsize = fragmentsize;
 		file->iteration = 0;
+		file->compressed = (filesize & FILETX_ZLIB) != 0;
+		file->totalsize = filesize & ~FILETX_ZLIB;
+#ifndef HAVE_ZLIB
+		if (file->compressed)
+			I_Error("PT_FileFragment: %s was sent compressed but zlib isn't supported\n", filename);
+#endif
 
 		file->ackpacket = calloc(1, sizeof(*file->ackpacket) + 512);
 		if (!file->ackpacket)
@@ -1250,7 +1830,7 @@ void PT_FileFragment(void)
 
 		if (CL_CanResumeDownload(file))
 		{
-			file->file = fopen(filename, "r+b");
+			file->file = fopen(DownloadStreamName(filename, file->compressed), "r+b");
 			if (!file->file)
 				I_Error("Can't reopen file %s: %s", filename, strerror(errno));
 			CONS_Printf("\r%s...\n", filename);
@@ -1262,24 +1842,38 @@ void PT_FileFragment(void)
 
 			free(pauseddownload);
 			pauseddownload = NULL;
+
+#ifdef HAVE_ZLIB
+			// The file itself isn't kept, rebuild it from what was already received
+			if (file->compressed)
+			{
+				CL_StartInflating(file);
+				CL_InflateFragments(file);
+			}
+#endif
 		}
 		else
 		{
 			CL_AbortDownloadResume();
 
-			file->file = fopen(filename, "wb");
+			// Compressed streams get read back as they are inflated
+			file->file = fopen(DownloadStreamName(filename, file->compressed), file->compressed ? "w+b" : "wb");
 			if (!file->file)
 				I_Error("Can't create file %s: %s", filename, strerror(errno));
 
 			CONS_Printf("\r%s...\n",filename);
 
 			file->currentsize = 0;
-			file->totalsize = LONG(netbuffer->u.filetxpak.filesize);
 			file->ackresendposition = UINT32_MAX; // Only used for resumed downloads
 
 			file->receivedfragments = calloc(file->totalsize / fragmentsize + 1, sizeof(*file->receivedfragments));
 			if (!file->receivedfragments)
 				I_Error("FileSendTicker: No more memory\n");
+
+#ifdef HAVE_ZLIB
+			if (file->compressed)
+				CL_StartInflating(file);
+#endif
 		}
 
 		lasttimeackpacketsent = I_GetTime();
@@ -1304,6 +1898,11 @@ void PT_FileFragment(void)
 
 			AddFragmentToAckPacket(file->ackpacket, file->iteration, fragmentpos / fragmentsize, filenum);
 
+#ifdef HAVE_ZLIB
+			if (file->compressed)
+				CL_InflateFragments(file);
+#endif
+
 			// Finished?
 			if (file->currentsize == file->totalsize)
 			{
@@ -1313,6 +1912,14 @@ void PT_FileFragment(void)
 				free(file->ackpacket);
 				file->status = FS_FOUND;
 				file->justdownloaded = true;
+#ifdef HAVE_ZLIB
+				if (file->compressed)
+				{
+					CL_StopInflating(file);
+					remove(DownloadStreamName(filename, true));
+					file->status = checkfilemd5(filename, file->md5sum);
+				}
+#endif
 				CONS_Printf(M_GetText("Downloading %s...(done)\n"),
 					filename);
 
@@ -1395,6 +2002,10 @@ void CloseNetFile(void)
 	for (i = 0; i < MAXNETNODES; i++)
 		SV_AbortSendFiles(i);
 
+#if defined (HAVE_CURL) && !defined (NONET)
+	CL_AbortHTTPDownloads();
+#endif
+
 	// Receiving a file?
 	for (i = 0; i < MAX_WADFILES; i++)
 		if (fileneeded[i].status == FS_DOWNLOADING && fileneeded[i].file)
@@ -1402,6 +2013,15 @@ void CloseNetFile(void)
 			fclose(fileneeded[i].file);
 			free(fileneeded[i].ackpacket);
 
+#ifdef HAVE_ZLIB
+			if (fileneeded[i].compressed)
+			{
+				// Only the stream is kept, the file gets rebuilt from it on resume
+				CL_StopInflating(&fileneeded[i]);
+				remove(fileneeded[i].filename);
+			}
+#endif
+
 			if (!pauseddownload && i != 0) // 0 is either srb2.srb or the gamestate...
 			{
 				// Don't remove the file, save it for later in case we resume the download
@@ -1414,16 +2034,323 @@ void CloseNetFile(void)
 				pauseddownload->currentsize = fileneeded[i].currentsize;
 				pauseddownload->receivedfragments = fileneeded[i].receivedfragments;
 				pauseddownload->fragmentsize = fileneeded[i].fragmentsize;
+				pauseddownload->totalsize = fileneeded[i].totalsize;
+				pauseddownload->compressed = fileneeded[i].compressed;
 			}
 			else
 			{
 				free(fileneeded[i].receivedfragments);
 				// File is not complete delete it
-				remove(fileneeded[i].filename);
+				remove(DownloadStreamName(fileneeded[i].filename, fileneeded[i].compressed));
+			}
+		}
+}
+
+#if defined (HAVE_CURL) && !defined (NONET)
+// Files are fetched from the server's HTTP source a few at a time,
+// into a .part file that is kept to resume from if the transfer fails.
+// Anything that can't be fetched or doesn't match is left for the
+// server to send.
+#define MAXHTTPDOWNLOADS 4
+
+typedef struct
+{
+	CURL *handle; // NULL if the slot is free
+	INT32 fileid;
+	FILE *file;
+	char partname[MAX_WADPATH+8];
+	boolean resumed; // Continues a .part file from an earlier attempt
+	char error[CURL_ERROR_SIZE];
+} httpdownload_t;
+
+static boolean httpinitialised = false;
+static CURLM *httpmulti = NULL;
+static httpdownload_t httpdownloads[MAXHTTPDOWNLOADS];
+static char httpsource[MAX_MIRROR_LENGTH];
+static INT32 httpnextfile; // The next file in fileneeded to look at
+
+static size_t HTTP_Write(char *data, size_t size, size_t count, void *userdata)
+{
+	httpdownload_t *dl = userdata;
+	fileneeded_t *file = &fileneeded[dl->fileid];
+	size_t length = size * count;
+
+	// Don't let a misconfigured source fill the disk
+	if (file->currentsize + length > file->totalsize)
+		return 0;
+
+	if (fwrite(data, 1, length, dl->file) != length)
+		return 0;
+	file->currentsize += (UINT32)length;
+	return length;
+}
+
+/** Starts downloading a file from the HTTP source
+  *
+  * \param dl A free download slot
+  * \param fileid The index of the file in fileneeded
+  * \return False if the transfer couldn't be started
+  *
+  */
+static boolean CL_StartHTTPDownload(httpdownload_t *dl, INT32 fileid)
+{
+	fileneeded_t *file = &fileneeded[fileid];
+	char *escaped;
+	long partsize;
+
+	dl->handle = curl_easy_init();
+	if (!dl->handle)
+		return false;
+
+	nameonly(file->filename);
+	escaped = curl_easy_escape(dl->handle, file->filename, 0);
+	if (!escaped)
+	{
+		curl_easy_cleanup(dl->handle);
+		dl->handle = NULL;
+		return false;
+	}
+	curl_easy_setopt(dl->handle, CURLOPT_URL, va("%s/%s", httpsource, escaped));
+	curl_free(escaped);
+
+	// put it in download dir
+	strcatbf(file->filename, downloaddir, "/");
+	snprintf(dl->partname, sizeof dl->partname, "%s.part", file->filename);
+
+	// Pick up where an earlier attempt stopped
+	dl->file = fopen(dl->partname, "ab");
+	if (!dl->file)
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Can't create file %s: %s\n"), dl->partname, strerror(errno));
+		curl_easy_cleanup(dl->handle);
+		dl->handle = NULL;
+		return false;
+	}
+	fseek(dl->file, 0, SEEK_END);
+	partsize = ftell(dl->file);
+	if (partsize < 0 || (UINT32)partsize >= file->totalsize)
+	{
+		dl->file = freopen(dl->partname, "wb", dl->file);
+		if (!dl->file)
+		{
+			curl_easy_cleanup(dl->handle);
+			dl->handle = NULL;
+			return false;
+		}
+		partsize = 0;
+	}
+	dl->resumed = (partsize > 0);
+	dl->fileid = fileid;
+	dl->error[0] = '\0';
+
+	curl_easy_setopt(dl->handle, CURLOPT_WRITEFUNCTION, HTTP_Write);
+	curl_easy_setopt(dl->handle, CURLOPT_WRITEDATA, dl);
+	curl_easy_setopt(dl->handle, CURLOPT_ERRORBUFFER, dl->error);
+	curl_easy_setopt(dl->handle, CURLOPT_FAILONERROR, 1L);
+	curl_easy_setopt(dl->handle, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(dl->handle, CURLOPT_USERAGENT, va("%s/%s", SRB2APPLICATION, VERSIONSTRING));
+	curl_easy_setopt(dl->handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)partsize);
+	curl_easy_setopt(dl->handle, CURLOPT_CONNECTTIMEOUT, 10L);
+	// Give up on transfers that stall
+	curl_easy_setopt(dl->handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+	curl_easy_setopt(dl->handle, CURLOPT_LOW_SPEED_TIME, 30L);
+	curl_multi_add_handle(httpmulti, dl->handle);
+
+	file->currentsize = (UINT32)partsize;
+	file->status = FS_DOWNLOADING;
+	lastfilenum = fileid;
+
+	CONS_Printf("\r%s...\n", file->filename);
+	if (dl->resumed)
+		CONS_Printf("Resuming download...\n");
+	return true;
+}
+
+/** Checks and keeps a file downloaded from the HTTP source, or retries it
+  *
+  * \param dl The download slot of the file
+  * \param result How the transfer ended
+  *
+  */
+static void CL_FinishHTTPDownload(httpdownload_t *dl, CURLcode result)
+{
+	fileneeded_t *file = &fileneeded[dl->fileid];
+	boolean resumed = dl->resumed;
+
+	curl_multi_remove_handle(httpmulti, dl->handle);
+	curl_easy_cleanup(dl->handle);
+	dl->handle = NULL;
+	if (fclose(dl->file) && result == CURLE_OK)
+		result = CURLE_WRITE_ERROR;
+	dl->file = NULL;
+
+	if (result == CURLE_OK)
+	{
+		file->status = checkfilemd5(dl->partname, file->md5sum);
+		if (file->status == FS_FOUND)
+		{
+			remove(file->filename);
+			if (!rename(dl->partname, file->filename))
+			{
+				CONS_Printf(M_GetText("Downloading %s...(done)\n"), file->filename);
+				return;
 			}
+			file->status = FS_NOTFOUND;
 		}
+		else
+			CONS_Alert(CONS_WARNING, M_GetText("%s from the HTTP source doesn't match the server's copy\n"), file->filename);
+		remove(dl->partname);
+	}
+	else
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Can't download %s from the HTTP source: %s\n"), file->filename,
+			dl->error[0] ? dl->error : curl_easy_strerror(result));
+		file->status = FS_NOTFOUND;
+
+		// Keep what was received for next time, unless that can't be continued
+		if (result == CURLE_RANGE_ERROR || result == CURLE_HTTP_RETURNED_ERROR || !file->currentsize)
+			remove(dl->partname);
+	}
+
+	// The old part may have been the problem, try again from the start
+	if (resumed && !FIL_FileExists(dl->partname))
+		CL_StartHTTPDownload(dl, dl->fileid);
+}
+
+/** Starts downloading the missing files from the server's HTTP source
+  *
+  * \param source The base URL of the files
+  * \return False if the files can't be downloaded that way
+  *
+  */
+boolean CL_StartHTTPDownloads(const char *source)
+{
+	size_t length;
+
+	if (strnicmp(source, "http://", 7) && strnicmp(source, "https://", 8))
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Ignoring the server's HTTP source %s\n"), source);
+		return false;
+	}
+
+	if (!httpinitialised)
+	{
+		if (curl_global_init(CURL_GLOBAL_ALL) != 0)
+			return false;
+		atexit(curl_global_cleanup);
+		httpinitialised = true;
+	}
+
+	CL_AbortHTTPDownloads();
+	httpmulti = curl_multi_init();
+	if (!httpmulti)
+		return false;
+
+	strlcpy(httpsource, source, sizeof httpsource);
+	length = strlen(httpsource);
+	while (length && httpsource[length-1] == '/')
+		httpsource[--length] = '\0';
+	httpnextfile = 0;
+
+	// prepare to download
+	I_mkdir(downloaddir, 0755);
+	CONS_Printf(M_GetText("Downloading files from %s\n"), httpsource);
+	return true;
 }
 
+/** Runs the HTTP downloads, starting new ones as others end
+  *
+  * \return True while there is anything left to download
+  *
+  */
+boolean CL_HTTPDownloadTicker(void)
+{
+	INT32 i, running, queued;
+	CURLMsg *msg;
+
+	if (!httpmulti)
+		return false;
+
+	for (i = 0; i < MAXHTTPDOWNLOADS; i++)
+		while (!httpdownloads[i].handle && httpnextfile < fileneedednum)
+		{
+			INT32 fileid = httpnextfile++;
+			if (fileneeded[fileid].status == FS_NOTFOUND || fileneeded[fileid].status == FS_MD5SUMBAD)
+				CL_StartHTTPDownload(&httpdownloads[i], fileid);
+		}
+
+	curl_multi_perform(httpmulti, &running);
+
+	while ((msg = curl_multi_info_read(httpmulti, &queued)))
+	{
+		if (msg->msg != CURLMSG_DONE)
+			continue;
+		for (i = 0; i < MAXHTTPDOWNLOADS; i++)
+			if (httpdownloads[i].handle == msg->easy_handle)
+			{
+				CL_FinishHTTPDownload(&httpdownloads[i], msg->data.result);
+				break;
+			}
+	}
+
+	for (i = 0; i < MAXHTTPDOWNLOADS; i++)
+		if (httpdownloads[i].handle)
+			return true;
+	if (httpnextfile < fileneedednum)
+		return true;
+
+	CL_AbortHTTPDownloads();
+	return false;
+}
+
+/** Gets the combined speed of the HTTP downloads
+  *
+  * \return The speed in bytes per second
+  *
+  */
+UINT32 CL_HTTPDownloadSpeed(void)
+{
+	UINT32 speed = 0;
+	INT32 i;
+
+	for (i = 0; i < MAXHTTPDOWNLOADS; i++)
+		if (httpdownloads[i].handle)
+		{
+			curl_off_t bps = 0;
+			curl_easy_getinfo(httpdownloads[i].handle, CURLINFO_SPEED_DOWNLOAD_T, &bps);
+			speed += (UINT32)bps;
+		}
+	return speed;
+}
+
+/** Stops the HTTP downloads, keeping what they received to resume from
+  */
+void CL_AbortHTTPDownloads(void)
+{
+	INT32 i;
+
+	if (!httpmulti)
+		return;
+
+	for (i = 0; i < MAXHTTPDOWNLOADS; i++)
+	{
+		httpdownload_t *dl = &httpdownloads[i];
+		if (!dl->handle)
+			continue;
+
+		curl_multi_remove_handle(httpmulti, dl->handle);
+		curl_easy_cleanup(dl->handle);
+		dl->handle = NULL;
+		fclose(dl->file);
+		dl->file = NULL;
+		fileneeded[dl->fileid].status = FS_NOTFOUND;
+	}
+
+	curl_multi_cleanup(httpmulti);
+	httpmulti = NULL;
+}
+#endif
+
 void Command_Downloads_f(void)
 {
 	INT32 node;
@@ -52,6 +52,12 @@ typedef struct
 	UINT32 currentsize;
 	UINT32 totalsize;
 	UINT32 ackresendposition; // Used when resuming downloads
+
+	// Used only for compressed downloads, where file holds the zlib stream
+	boolean compressed;
+	FILE *inflatedfile; // The file being rebuilt from the stream
+	void *zstream;
+	UINT32 inflatedfragments; // Fragments already fed to the inflater
 } fileneeded_t;
 
 extern INT32 fileneedednum;
@@ -83,6 +89,16 @@ boolean CL_CheckDownloadable(void);
 boolean CL_SendFileRequest(void);
 boolean PT_RequestFile(INT32 node);
 
+// Written after the file list of a PT_REQUESTFILE packet
+#define FILEREQUEST_ZLIB 0x01 // The client can take zlib streams of the files
+
+#if defined (HAVE_CURL) && !defined (NONET)
+boolean CL_StartHTTPDownloads(const char *source);
+boolean CL_HTTPDownloadTicker(void);
+UINT32 CL_HTTPDownloadSpeed(void);
+void CL_AbortHTTPDownloads(void);
+#endif
+
 typedef enum
 {
 	LFTNS_WAITING, // This node is waiting for the server to send the file
@@ -120,6 +136,7 @@ void StoreLuaFileCallback(INT32 id);
 void RemoveLuaFileCallback(INT32 id);
 void MakePathDirs(char *path);
 
+void SV_PrepareNetCache(void);
 void SV_AbortSendFiles(INT32 node);
 void CloseNetFile(void);
 void CL_AbortDownloadResume(void);
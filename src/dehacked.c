@@ -60,6 +60,122 @@ memset(FREE_SKINCOLORS,0,sizeof(char *) * NUMCOLORFREESLOTS);\
 memset(used_spr,0,sizeof(UINT8) * ((NUMSPRITEFREESLOTS / 8) + 1));\
 }
 
+// Hashed name indexes, so looking up an S_/MT_/SPR_/etc. name doesn't
+// have to walk the whole table every time.
+// They're built on first use, and freeslots relink their slot once named.
+typedef struct
+{
+	const char *(*getname)(INT32 i); // current name of slot i, or NULL
+	INT32 count; // number of slots
+	INT32 firstfree, numfree; // freeslots, which are searched first
+	size_t len; // only compare this many characters (sprites)
+	UINT32 mask; // number of buckets - 1
+	INT32 *buckets; // first slot in each bucket, -1 if empty
+	INT32 *next; // next slot in the same bucket
+	INT32 *bucketof; // bucket slot i is linked into, -1 if none
+} nameindex_t;
+
+static const char *StateName(INT32 i);
+static const char *MobjTypeName(INT32 i);
+static const char *SkinColorName(INT32 i);
+static const char *SpriteName(INT32 i);
+static const char *SfxName(INT32 i);
+static const char *HudItemName(INT32 i);
+static const char *MenuTypeName(INT32 i);
+
+static nameindex_t stateindex = {StateName, NUMSTATES, S_FIRSTFREESLOT, NUMSTATEFREESLOTS, 0, 0, NULL, NULL, NULL};
+static nameindex_t mobjindex = {MobjTypeName, NUMMOBJTYPES, MT_FIRSTFREESLOT, NUMMOBJFREESLOTS, 0, 0, NULL, NULL, NULL};
+static nameindex_t colorindex = {SkinColorName, MAXSKINCOLORS, SKINCOLOR_FIRSTFREESLOT, NUMCOLORFREESLOTS, 0, 0, NULL, NULL, NULL};
+static nameindex_t spriteindex = {SpriteName, NUMSPRITES, 0, 0, 4, 0, NULL, NULL, NULL};
+static nameindex_t sfxindex = {SfxName, NUMSFX, 0, 0, 0, 0, NULL, NULL, NULL};
+static nameindex_t huditemindex = {HudItemName, NUMHUDITEMS, 0, 0, 0, 0, NULL, NULL, NULL};
+static nameindex_t menutypeindex = {MenuTypeName, NUMMENUTYPES, 0, 0, 0, 0, NULL, NULL, NULL};
+
+// Case-insensitive, so the same index serves SOC (any case) and Lua lookups.
+static UINT32 NameHash(const char *name, size_t len)
+{
+	UINT32 hash = 2166136261u;
+	size_t n;
+	for (n = 0; name[n] && (!len || n < len); n++)
+		hash = (hash ^ (UINT8)toupper(name[n])) * 16777619u;
+	return hash;
+}
+
+// Order in which a linear search used to find slot i
+static inline INT32 NameRank(const nameindex_t *ix, INT32 i)
+{
+	if (i >= ix->firstfree && i < ix->firstfree + ix->numfree)
+		return i - ix->firstfree;
+	return ix->numfree + i;
+}
+
+static void NameIndex_Link(nameindex_t *ix, INT32 i)
+{
+	const char *name;
+	INT32 *link;
+
+	if (!ix->buckets)
+		return; // not built yet, it'll pick the name up then
+
+	if (ix->bucketof[i] != -1) // unlink the old name
+	{
+		for (link = &ix->buckets[ix->bucketof[i]]; *link != i; link = &ix->next[*link])
+			;
+		*link = ix->next[i];
+		ix->bucketof[i] = -1;
+	}
+
+	name = ix->getname(i);
+	if (!name)
+		return;
+
+	// keep each bucket in search order, so duplicate names resolve like they always did
+	ix->bucketof[i] = NameHash(name, ix->len) & ix->mask;
+	for (link = &ix->buckets[ix->bucketof[i]]; *link != -1 && NameRank(ix, *link) < NameRank(ix, i); link = &ix->next[*link])
+		;
+	ix->next[i] = *link;
+	*link = i;
+}
+
+static void NameIndex_Build(nameindex_t *ix)
+{
+	UINT32 size = 1;
+	INT32 i;
+
+	while (size < (UINT32)ix->count)
+		size <<= 1;
+	ix->mask = size - 1;
+	ix->buckets = Z_Malloc(size * sizeof (INT32), PU_STATIC, NULL);
+	ix->next = Z_Malloc(ix->count * sizeof (INT32), PU_STATIC, NULL);
+	ix->bucketof = Z_Malloc(ix->count * sizeof (INT32), PU_STATIC, NULL);
+	memset(ix->buckets, -1, size * sizeof (INT32));
+	memset(ix->bucketof, -1, ix->count * sizeof (INT32));
+
+	for (i = 0; i < ix->count; i++)
+		NameIndex_Link(ix, i);
+}
+
+// Returns the slot named name, or -1 if there isn't one
+static INT32 NameIndex_Find(nameindex_t *ix, const char *name, boolean nocase)
+{
+	const char *slotname;
+	INT32 i;
+
+	if (!ix->buckets)
+		NameIndex_Build(ix);
+
+	for (i = ix->buckets[NameHash(name, ix->len) & ix->mask]; i != -1; i = ix->next[i])
+	{
+		slotname = ix->getname(i);
+		if (!slotname)
+			continue;
+		if (ix->len ? !strncmp(name, slotname, ix->len)
+			: (nocase ? fasticmp(name, slotname) : fastcmp(name, slotname)))
+			return i;
+	}
+	return -1;
+}
+
 // Crazy word-reading stuff
 /// \todo Put these in a seperate file or something.
 static mobjtype_t get_mobjtype(const char *word);
@@ -548,6 +664,7 @@ static void readfreeslots(MYFILE *f)
 					strncpy(sprnames[i],word,4);
 					//sprnames[i][4] = 0;
 					used_spr[(i-SPR_FIRSTFREESLOT)/8] |= 1<<(i%8); // Okay, this sprite slot has been named now.
+					NameIndex_Link(&spriteindex, i);
 					break;
 				}
 			}
@@ -557,6 +674,7 @@ static void readfreeslots(MYFILE *f)
 					if (!FREE_STATES[i]) {
 						FREE_STATES[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 						strcpy(FREE_STATES[i],word);
+						NameIndex_Link(&stateindex, S_FIRSTFREESLOT+i);
 						break;
 					}
 			}
@@ -566,6 +684,7 @@ static void readfreeslots(MYFILE *f)
 					if (!FREE_MOBJS[i]) {
 						FREE_MOBJS[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 						strcpy(FREE_MOBJS[i],word);
+						NameIndex_Link(&mobjindex, MT_FIRSTFREESLOT+i);
 						break;
 					}
 			}
@@ -575,6 +694,7 @@ static void readfreeslots(MYFILE *f)
 					if (!FREE_SKINCOLORS[i]) {
 						FREE_SKINCOLORS[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 						strcpy(FREE_SKINCOLORS[i],word);
+						NameIndex_Link(&colorindex, SKINCOLOR_FIRSTFREESLOT+i);
 						M_AddMenuColor(numskincolors++);
 						break;
 					}
@@ -9007,6 +9127,7 @@ static const char *const MOBJFLAG_LIST[] = {
 	"NOCLIPTHING",
 	"GRENADEBOUNCE",
 	"RUNSPAWNFUNC",
+	"DORMANT",
 	NULL
 };
 
@@ -9058,6 +9179,9 @@ static const char *const MOBJEFLAG_LIST[] = {
 	"SPRUNG", // Mobj was already sprung this tic
 	"APPLYPMOMZ", // Platform movement
 	"TRACERANGLE", // Compute and trigger on mobj angle relative to tracer
+	"PARKED", // Idle collectible, only animated until something disturbs it
+	"DORMANT", // Thinker is asleep, a player is needed nearby to wake it
+	"STAYAWAKE", // A player is near or something is chasing it, so stay awake this tic
 	NULL
 };
 
@@ -10088,76 +10212,114 @@ struct {
 	{NULL,0}
 };
 
+// Slot names for the name indexes, without their prefixes
+static const char *StateName(INT32 i)
+{
+	if (i < S_FIRSTFREESLOT)
+		return STATE_LIST[i]+2;
+	return FREE_STATES[i-S_FIRSTFREESLOT];
+}
+
+static const char *MobjTypeName(INT32 i)
+{
+	return DEH_MobjTypeName(i);
+}
+
+static const char *SkinColorName(INT32 i)
+{
+	if (i < SKINCOLOR_FIRSTFREESLOT)
+		return COLOR_ENUMS[i];
+	return FREE_SKINCOLORS[i-SKINCOLOR_FIRSTFREESLOT];
+}
+
+static const char *SpriteName(INT32 i)
+{
+	if (sprnames[i][4]) // replaced by a later freeslot of the same name
+		return NULL;
+	return sprnames[i];
+}
+
+static const char *SfxName(INT32 i)
+{
+	return S_sfx[i].name;
+}
+
+static const char *HudItemName(INT32 i)
+{
+	return HUDITEMS_LIST[i];
+}
+
+static const char *MenuTypeName(INT32 i)
+{
+	return MENUTYPES_LIST[i];
+}
+
+// Skin sounds and sfx freeslots get their names after the index is built
+void DEH_SfxRenamed(INT32 id)
+{
+	NameIndex_Link(&sfxindex, id);
+}
+
 static mobjtype_t get_mobjtype(const char *word)
 { // Returns the value of MT_ enumerations
-	mobjtype_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("MT_",word,3))
 		word += 3; // take off the MT_
-	for (i = 0; i < NUMMOBJFREESLOTS; i++) {
-		if (!FREE_MOBJS[i])
-			break;
-		if (fastcmp(word, FREE_MOBJS[i]))
-			return MT_FIRSTFREESLOT+i;
-	}
-	for (i = 0; i < MT_FIRSTFREESLOT; i++)
-		if (fastcmp(word, MOBJTYPE_LIST[i]+3))
-			return i;
+	if ((i = NameIndex_Find(&mobjindex, word, false)) != -1)
+		return i;
 	deh_warning("Couldn't find mobjtype named 'MT_%s'",word);
 	return MT_NULL;
 }
 
+// Returns the name of a mobjtype without the MT_, or NULL if it hasn't got one
+const char *DEH_MobjTypeName(INT32 type)
+{
+	if (type < 0)
+		return NULL;
+	if (type < MT_FIRSTFREESLOT)
+		return MOBJTYPE_LIST[type]+3;
+	if (type <= MT_LASTFREESLOT)
+		return FREE_MOBJS[type-MT_FIRSTFREESLOT];
+	return NULL;
+}
+
 static statenum_t get_state(const char *word)
 { // Returns the value of S_ enumerations
-	statenum_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("S_",word,2))
 		word += 2; // take off the S_
-	for (i = 0; i < NUMSTATEFREESLOTS; i++) {
-		if (!FREE_STATES[i])
-			break;
-		if (fastcmp(word, FREE_STATES[i]))
-			return S_FIRSTFREESLOT+i;
-	}
-	for (i = 0; i < S_FIRSTFREESLOT; i++)
-		if (fastcmp(word, STATE_LIST[i]+2))
-			return i;
+	if ((i = NameIndex_Find(&stateindex, word, false)) != -1)
+		return i;
 	deh_warning("Couldn't find state named 'S_%s'",word);
 	return S_NULL;
 }
 
 skincolornum_t get_skincolor(const char *word)
 { // Returns the value of SKINCOLOR_ enumerations
-	skincolornum_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("SKINCOLOR_",word,10))
 		word += 10; // take off the SKINCOLOR_
-	for (i = 0; i < NUMCOLORFREESLOTS; i++) {
-		if (!FREE_SKINCOLORS[i])
-			break;
-		if (fastcmp(word, FREE_SKINCOLORS[i]))
-			return SKINCOLOR_FIRSTFREESLOT+i;
-	}
-	for (i = 0; i < SKINCOLOR_FIRSTFREESLOT; i++)
-		if (fastcmp(word, COLOR_ENUMS[i]))
-			return i;
+	if ((i = NameIndex_Find(&colorindex, word, false)) != -1)
+		return i;
 	deh_warning("Couldn't find skincolor named 'SKINCOLOR_%s'",word);
 	return SKINCOLOR_GREEN;
 }
 
 static spritenum_t get_sprite(const char *word)
 { // Returns the value of SPR_ enumerations
-	spritenum_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("SPR_",word,4))
 		word += 4; // take off the SPR_
-	for (i = 0; i < NUMSPRITES; i++)
-		if (!sprnames[i][4] && memcmp(word,sprnames[i],4)==0)
-			return i;
+	if ((i = NameIndex_Find(&spriteindex, word, false)) != -1)
+		return i;
 	deh_warning("Couldn't find sprite named 'SPR_%s'",word);
 	return SPR_NULL;
 }
@@ -10178,16 +10340,15 @@ static playersprite_t get_sprite2(const char *word)
 
 static sfxenum_t get_sfx(const char *word)
 { // Returns the value of SFX_ enumerations
-	sfxenum_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("SFX_",word,4))
 		word += 4; // take off the SFX_
 	else if (fastncmp("DS",word,2))
 		word += 2; // take off the DS
-	for (i = 0; i < NUMSFX; i++)
-		if (S_sfx[i].name && fasticmp(word, S_sfx[i].name))
-			return i;
+	if ((i = NameIndex_Find(&sfxindex, word, true)) != -1)
+		return i;
 	deh_warning("Couldn't find sfx named 'SFX_%s'",word);
 	return sfx_None;
 }
@@ -10234,28 +10395,26 @@ static UINT16 get_mus(const char *word, UINT8 dehacked_mode)
 
 static hudnum_t get_huditem(const char *word)
 { // Returns the value of HUD_ enumerations
-	hudnum_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("HUD_",word,4))
 		word += 4; // take off the HUD_
-	for (i = 0; i < NUMHUDITEMS; i++)
-		if (fastcmp(word, HUDITEMS_LIST[i]))
-			return i;
+	if ((i = NameIndex_Find(&huditemindex, word, false)) != -1)
+		return i;
 	deh_warning("Couldn't find huditem named 'HUD_%s'",word);
 	return HUD_LIVES;
 }
 
 static menutype_t get_menutype(const char *word)
 { // Returns the value of MN_ enumerations
-	menutype_t i;
+	INT32 i;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("MN_",word,3))
 		word += 3; // take off the MN_
-	for (i = 0; i < NUMMENUTYPES; i++)
-		if (fastcmp(word, MENUTYPES_LIST[i]))
-			return i;
+	if ((i = NameIndex_Find(&menutypeindex, word, false)) != -1)
+		return i;
 	deh_warning("Couldn't find menutype named 'MN_%s'",word);
 	return MN_NONE;
 }
@@ -10647,6 +10806,7 @@ static inline int lib_freeslot(lua_State *L)
 				strncpy(sprnames[j],word,4);
 				//sprnames[j][4] = 0;
 				used_spr[(j-SPR_FIRSTFREESLOT)/8] |= 1<<(j%8); // Okay, this sprite slot has been named now.
+				NameIndex_Link(&spriteindex, j);
 				lua_pushinteger(L, j);
 				r++;
 				break;
@@ -10662,6 +10822,7 @@ static inline int lib_freeslot(lua_State *L)
 					CONS_Printf("State S_%s allocated.\n",word);
 					FREE_STATES[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 					strcpy(FREE_STATES[i],word);
+					NameIndex_Link(&stateindex, S_FIRSTFREESLOT+i);
 					lua_pushinteger(L, S_FIRSTFREESLOT + i);
 					r++;
 					break;
@@ -10677,6 +10838,7 @@ static inline int lib_freeslot(lua_State *L)
 					CONS_Printf("MobjType MT_%s allocated.\n",word);
 					FREE_MOBJS[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 					strcpy(FREE_MOBJS[i],word);
+					NameIndex_Link(&mobjindex, MT_FIRSTFREESLOT+i);
 					lua_pushinteger(L, MT_FIRSTFREESLOT + i);
 					r++;
 					break;
@@ -10692,6 +10854,7 @@ static inline int lib_freeslot(lua_State *L)
 					CONS_Printf("Skincolor SKINCOLOR_%s allocated.\n",word);
 					FREE_SKINCOLORS[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 					strcpy(FREE_SKINCOLORS[i],word);
+					NameIndex_Link(&colorindex, SKINCOLOR_FIRSTFREESLOT+i);
 					M_AddMenuColor(numskincolors++);
 					lua_pushinteger(L, SKINCOLOR_FIRSTFREESLOT + i);
 					r++;
@@ -10774,6 +10937,27 @@ static int lib_dummysuper(lua_State *L)
 	return luaL_error(L, "Can't call super() outside of hardcode-replacing A_Action functions being called by state changes!"); // convoluted, I know. @_@;;
 }
 
+// Resolved constants are remembered in a table kept as the second upvalue
+// of lib_getenum, so a global like MT_RING is only searched for once per
+// Lua state. Only values that can never change are stored there: freeslots
+// keep their number once allocated, but "super", actions, dynamic globals
+// and the reusable skin sound slots are looked up every time.
+consvar_t cv_constantcache = {"constantcache", "On", 0, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+#define CONSTCACHE lua_upvalueindex(2)
+
+static int lib_pushenum(lua_State *L, lua_Integer value)
+{
+	lua_pushinteger(L, value);
+	if (cv_constantcache.value)
+	{
+		lua_pushvalue(L, 2); // the constant's name
+		lua_pushinteger(L, value);
+		lua_rawset(L, CONSTCACHE);
+	}
+	return 1;
+}
+
 static inline int lib_getenum(lua_State *L)
 {
 	const char *word, *p;
@@ -10781,12 +10965,19 @@ static inline int lib_getenum(lua_State *L)
 	boolean mathlib = lua_toboolean(L, lua_upvalueindex(1));
 	if (lua_type(L,2) != LUA_TSTRING)
 		return 0;
+	if (cv_constantcache.value)
+	{
+		lua_pushvalue(L, 2);
+		lua_rawget(L, CONSTCACHE);
+		if (!lua_isnil(L, -1))
+			return 1;
+		lua_pop(L, 1);
+	}
 	word = lua_tostring(L,2);
 	if (strlen(word) == 1) { // Assume sprite frame if length 1.
 		if (*word >= 'A' && *word <= '~')
 		{
-			lua_pushinteger(L, *word-'A');
-			return 1;
+			return lib_pushenum(L, *word-'A');
 		}
 		if (mathlib) return luaL_error(L, "constant '%s' could not be parsed.\n", word);
 		return 0;
@@ -10795,8 +10986,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; MOBJFLAG_LIST[i]; i++)
 			if (fastcmp(p, MOBJFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mobjflag '%s' could not be found.\n", word);
 		return 0;
@@ -10805,8 +10995,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; MOBJFLAG2_LIST[i]; i++)
 			if (fastcmp(p, MOBJFLAG2_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mobjflag2 '%s' could not be found.\n", word);
 		return 0;
@@ -10815,8 +11004,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; MOBJEFLAG_LIST[i]; i++)
 			if (fastcmp(p, MOBJEFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mobjeflag '%s' could not be found.\n", word);
 		return 0;
@@ -10825,8 +11013,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; i < 4; i++)
 			if (MAPTHINGFLAG_LIST[i] && fastcmp(p, MAPTHINGFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mapthingflag '%s' could not be found.\n", word);
 		return 0;
@@ -10835,18 +11022,15 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; PLAYERFLAG_LIST[i]; i++)
 			if (fastcmp(p, PLAYERFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (fastcmp(p, "FULLSTASIS"))
 		{
-			lua_pushinteger(L, (lua_Integer)PF_FULLSTASIS);
-			return 1;
+			return lib_pushenum(L, (lua_Integer)PF_FULLSTASIS);
 		}
 		else if (fastcmp(p, "USEDOWN")) // Remove case when 2.3 nears release...
 		{
-			lua_pushinteger(L, (lua_Integer)PF_SPINDOWN);
-			return 1;
+			return lib_pushenum(L, (lua_Integer)PF_SPINDOWN);
 		}
 		if (mathlib) return luaL_error(L, "playerflag '%s' could not be found.\n", word);
 		return 0;
@@ -10855,8 +11039,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word;
 		for (i = 0; Gametype_ConstantNames[i]; i++)
 			if (fastcmp(p, Gametype_ConstantNames[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return lib_pushenum(L, i);
 			}
 		if (mathlib) return luaL_error(L, "gametype '%s' could not be found.\n", word);
 		return 0;
@@ -10865,8 +11048,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; GAMETYPERULE_LIST[i]; i++)
 			if (fastcmp(p, GAMETYPERULE_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "game type rule '%s' could not be found.\n", word);
 		return 0;
@@ -10875,8 +11057,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; TYPEOFLEVEL[i].name; i++)
 			if (fastcmp(p, TYPEOFLEVEL[i].name)) {
-				lua_pushinteger(L, TYPEOFLEVEL[i].flag);
-				return 1;
+				return lib_pushenum(L, TYPEOFLEVEL[i].flag);
 			}
 		if (mathlib) return luaL_error(L, "typeoflevel '%s' could not be found.\n", word);
 		return 0;
@@ -10885,53 +11066,27 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; i < 16; i++)
 			if (ML_LIST[i] && fastcmp(p, ML_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return lib_pushenum(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "linedef flag '%s' could not be found.\n", word);
 		return 0;
 	}
 	else if (fastncmp("S_",word,2)) {
 		p = word+2;
-		for (i = 0; i < NUMSTATEFREESLOTS; i++) {
-			if (!FREE_STATES[i])
-				break;
-			if (fastcmp(p, FREE_STATES[i])) {
-				lua_pushinteger(L, S_FIRSTFREESLOT+i);
-				return 1;
-			}
-		}
-		for (i = 0; i < S_FIRSTFREESLOT; i++)
-			if (fastcmp(p, STATE_LIST[i]+2)) {
-				lua_pushinteger(L, i);
-				return 1;
-			}
+		if ((i = NameIndex_Find(&stateindex, p, false)) != -1)
+			return lib_pushenum(L, i);
 		return luaL_error(L, "state '%s' does not exist.\n", word);
 	}
 	else if (fastncmp("MT_",word,3)) {
 		p = word+3;
-		for (i = 0; i < NUMMOBJFREESLOTS; i++) {
-			if (!FREE_MOBJS[i])
-				break;
-			if (fastcmp(p, FREE_MOBJS[i])) {
-				lua_pushinteger(L, MT_FIRSTFREESLOT+i);
-				return 1;
-			}
-		}
-		for (i = 0; i < MT_FIRSTFREESLOT; i++)
-			if (fastcmp(p, MOBJTYPE_LIST[i]+3)) {
-				lua_pushinteger(L, i);
-				return 1;
-			}
+		if ((i = NameIndex_Find(&mobjindex, p, false)) != -1)
+			return lib_pushenum(L, i);
 		return luaL_error(L, "mobjtype '%s' does not exist.\n", word);
 	}
 	else if (fastncmp("SPR_",word,4)) {
 		p = word+4;
-		for (i = 0; i < NUMSPRITES; i++)
-			if (!sprnames[i][4] && fastncmp(p,sprnames[i],4)) {
-				lua_pushinteger(L, i);
-				return 1;
-			}
+		if ((i = NameIndex_Find(&spriteindex, p, false)) != -1)
+			return lib_pushenum(L, i);
 		if (mathlib) return luaL_error(L, "sprite '%s' could not be found.\n", word);
 		return 0;
 	}
@@ -10944,13 +11099,11 @@ static inline int lib_getenum(lua_State *L)
 				// the spr2names entry will have "_" on the end, as in "RUN_"
 				if (spr2names[i][3] == '_' && !p[3]) {
 					if (fastncmp(p,spr2names[i],3)) {
-						lua_pushinteger(L, i);
-						return 1;
+						return lib_pushenum(L, i);
 					}
 				}
 				else if (fastncmp(p,spr2names[i],4)) {
-					lua_pushinteger(L, i);
-					return 1;
+					return lib_pushenum(L, i);
 				}
 			}
 		if (mathlib) return luaL_error(L, "player sprite '%s' could not be found.\n", word);
@@ -10958,29 +11111,35 @@ static inline int lib_getenum(lua_State *L)
 	}
 	else if (!mathlib && fastncmp("sfx_",word,4)) {
 		p = word+4;
-		for (i = 0; i < NUMSFX; i++)
-			if (S_sfx[i].name && fastcmp(p, S_sfx[i].name)) {
+		if ((i = NameIndex_Find(&sfxindex, p, false)) != -1) {
+			if (i >= sfx_skinsoundslot0) { // these get reused
 				lua_pushinteger(L, i);
 				return 1;
 			}
+			return lib_pushenum(L, i);
+		}
 		return 0;
 	}
 	else if (mathlib && fastncmp("SFX_",word,4)) { // SOCs are ALL CAPS!
 		p = word+4;
-		for (i = 0; i < NUMSFX; i++)
-			if (S_sfx[i].name && fasticmp(p, S_sfx[i].name)) {
+		if ((i = NameIndex_Find(&sfxindex, p, true)) != -1) {
+			if (i >= sfx_skinsoundslot0) { // these get reused
 				lua_pushinteger(L, i);
 				return 1;
 			}
+			return lib_pushenum(L, i);
+		}
 		return luaL_error(L, "sfx '%s' could not be found.\n", word);
 	}
 	else if (mathlib && fastncmp("DS",word,2)) {
 		p = word+2;
-		for (i = 0; i < NUMSFX; i++)
-			if (S_sfx[i].name && fasticmp(p, S_sfx[i].name)) {
+		if ((i = NameIndex_Find(&sfxindex, p, true)) != -1) {
+			if (i >= sfx_skinsoundslot0) { // these get reused
 				lua_pushinteger(L, i);
 				return 1;
 			}
+			return lib_pushenum(L, i);
+		}
 		if (mathlib) return luaL_error(L, "sfx '%s' could not be found.\n", word);
 		return 0;
 	}
@@ -11011,8 +11170,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; i < NUMPOWERS; i++)
 			if (fasticmp(p, POWERS_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return lib_pushenum(L, i);
 			}
 		return 0;
 	}
@@ -11020,36 +11178,21 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; i < NUMPOWERS; i++)
 			if (fastcmp(p, POWERS_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return lib_pushenum(L, i);
 			}
 		return luaL_error(L, "power '%s' could not be found.\n", word);
 	}
 	else if (fastncmp("HUD_",word,4)) {
 		p = word+4;
-		for (i = 0; i < NUMHUDITEMS; i++)
-			if (fastcmp(p, HUDITEMS_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
-			}
+		if ((i = NameIndex_Find(&huditemindex, p, false)) != -1)
+			return lib_pushenum(L, i);
 		if (mathlib) return luaL_error(L, "huditem '%s' could not be found.\n", word);
 		return 0;
 	}
 	else if (fastncmp("SKINCOLOR_",word,10)) {
 		p = word+10;
-		for (i = 0; i < NUMCOLORFREESLOTS; i++) {
-			if (!FREE_SKINCOLORS[i])
-				break;
-			if (fastcmp(p, FREE_SKINCOLORS[i])) {
-				lua_pushinteger(L, SKINCOLOR_FIRSTFREESLOT+i);
-				return 1;
-			}
-		}
-		for (i = 0; i < SKINCOLOR_FIRSTFREESLOT; i++)
-			if (fastcmp(p, COLOR_ENUMS[i])) {
-				lua_pushinteger(L, i);
-				return 1;
-			}
+		if ((i = NameIndex_Find(&colorindex, p, false)) != -1)
+			return lib_pushenum(L, i);
 		return luaL_error(L, "skincolor '%s' could not be found.\n", word);
 	}
 	else if (fastncmp("GRADE_",word,6))
@@ -11058,19 +11201,15 @@ static inline int lib_getenum(lua_State *L)
 		for (i = 0; NIGHTSGRADE_LIST[i]; i++)
 			if (*p == NIGHTSGRADE_LIST[i])
 			{
-				lua_pushinteger(L, i);
-				return 1;
+				return lib_pushenum(L, i);
 			}
 		if (mathlib) return luaL_error(L, "NiGHTS grade '%s' could not be found.\n", word);
 		return 0;
 	}
 	else if (fastncmp("MN_",word,3)) {
 		p = word+3;
-		for (i = 0; i < NUMMENUTYPES; i++)
-			if (fastcmp(p, MENUTYPES_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
-			}
+		if ((i = NameIndex_Find(&menutypeindex, p, false)) != -1)
+			return lib_pushenum(L, i);
 		if (mathlib) return luaL_error(L, "menutype '%s' could not be found.\n", word);
 		return 0;
 	}
@@ -11116,14 +11255,12 @@ static inline int lib_getenum(lua_State *L)
 
 	if (fastcmp(word, "BT_USE")) // Remove case when 2.3 nears release...
 	{
-		lua_pushinteger(L, (lua_Integer)BT_SPIN);
-		return 1;
+		return lib_pushenum(L, (lua_Integer)BT_SPIN);
 	}
 
 	for (i = 0; INT_CONST[i].n; i++)
 		if (fastcmp(word,INT_CONST[i].n)) {
-			lua_pushinteger(L, INT_CONST[i].v);
-			return 1;
+			return lib_pushenum(L, INT_CONST[i].v);
 		}
 
 	if (mathlib) return luaL_error(L, "constant '%s' could not be parsed.\n", word);
@@ -11134,6 +11271,8 @@ static inline int lib_getenum(lua_State *L)
 	return LUA_PushGlobals(L, word);
 }
 
+#undef CONSTCACHE
+
 int LUA_EnumLib(lua_State *L)
 {
 	if (lua_gettop(L) == 0)
@@ -11142,7 +11281,8 @@ int LUA_EnumLib(lua_State *L)
 	// Set the global metatable
 	lua_createtable(L, 0, 1);
 	lua_pushvalue(L, 1); // boolean passed to LUA_EnumLib as first argument.
-	lua_pushcclosure(L, lib_getenum, 1);
+	lua_newtable(L); // CONSTCACHE
+	lua_pushcclosure(L, lib_getenum, 2);
 	lua_setfield(L, -2, "__index");
 	lua_setmetatable(L, LUA_GLOBALSINDEX);
 	return 0;
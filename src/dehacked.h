@@ -14,6 +14,7 @@
 #define __DEHACKED_H__
 
 #include "m_fixed.h" // for get_number
+#include "command.h" // for cv_constantcache
 
 typedef enum
 {
@@ -33,6 +34,10 @@ void DEH_LoadDehackedLumpPwad(UINT16 wad, UINT16 lump, boolean mainfile);
 void DEH_Check(void);
 
 fixed_t get_number(const char *word);
+const char *DEH_MobjTypeName(INT32 type);
+void DEH_SfxRenamed(INT32 id);
+
+extern consvar_t cv_constantcache;
 
 boolean LUA_SetLuaAction(void *state, const char *actiontocompare);
 const char *LUA_GetActionName(void *action);
@@ -4,6 +4,7 @@
 UINT8 graphics_started = 0;
 
 UINT8 keyboard_started = 0;
+boolean quieterror = false;
 
 UINT32 I_GetFreeMem(UINT32 *total)
 {
@@ -21,6 +22,16 @@ int I_GetTimeMicros(void)
 	return 0;
 }
 
+precise_t I_GetPreciseTime(void)
+{
+	return 0;
+}
+
+UINT64 I_GetPrecisePrecision(void)
+{
+	return 1000000;
+}
+
 void I_Sleep(void){}
 
 void I_GetEvent(void){}
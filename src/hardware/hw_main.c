@@ -3443,6 +3443,7 @@ static gl_vissprite_t *gl_visspritechunks[MAXVISSPRITES >> VISSPRITECHUNKBITS] =
 static void HWR_ClearSprites(void)
 {
 	gl_visspritecount = 0;
+	R_ClearCollectibleProxies();
 }
 
 // --------------------------------------------------------------------------
@@ -4695,6 +4696,7 @@ static UINT8 sectorlight;
 static void HWR_AddSprites(sector_t *sec)
 {
 	mobj_t *thing;
+	collectible_t *rec;
 #ifdef HWPRECIP
 	precipmobj_t *precipthing;
 #endif
@@ -4723,6 +4725,18 @@ static void HWR_AddSprites(sector_t *sec)
 			HWR_ProjectSprite(thing);
 	}
 
+	for (rec = sec->collectiblelist; rec; rec = rec->snext)
+	{
+		if (!(thing = R_GetCollectibleProxy(rec)))
+			break;
+
+		if (R_ThingVisibleWithinDist(thing, limit_dist, hoop_limit_dist))
+		{
+			HWR_ProjectSprite(thing);
+			R_KeepCollectibleProxy();
+		}
+	}
+
 #ifdef HWPRECIP
 	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
 	if ((limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS))
@@ -499,10 +499,14 @@ HMS_list_servers (void)
 }
 
 msg_server_t *
-HMS_fetch_servers (msg_server_t *list, int room_number, int query_id)
+HMS_fetch_servers (int room_number, int query_id)
 {
 	struct HMS_buffer *hms;
 
+	msg_server_t *list;
+	msg_server_t *grown;
+	int capacity;
+
 	int doing_shit;
 
 	char local_version[9];
@@ -532,7 +536,11 @@ HMS_fetch_servers (msg_server_t *list, int room_number, int query_id)
 	if (! hms)
 		return NULL;
 
-	if (HMS_do(hms))
+	capacity = 32;
+	/* +1 for the terminator */
+	list = malloc(( capacity + 1 ) * sizeof *list);
+
+	if (list && HMS_do(hms))
 	{
 		doing_shit = 1;
 
@@ -555,7 +563,7 @@ HMS_fetch_servers (msg_server_t *list, int room_number, int query_id)
 			if (! p)
 				break;
 
-			while (i < MAXSERVERLIST && ( end = strchr(p, '\n') ))
+			while (( end = strchr(p, '\n') ))
 			{
 				*end = '\0';
 
@@ -580,6 +588,21 @@ HMS_fetch_servers (msg_server_t *list, int room_number, int query_id)
 
 					if (strcmp(version, local_version) == 0)
 					{
+						if (i == capacity)
+						{
+							grown = realloc(list,
+									( capacity * 2 + 1 ) * sizeof *list);
+
+							if (! grown)
+							{
+								section_end = 0;/* keep what we have */
+								break;
+							}
+
+							list = grown;
+							capacity *= 2;
+						}
+
 						strlcpy(list[i].ip,      address, sizeof list[i].ip);
 						strlcpy(list[i].port,    port,    sizeof list[i].port);
 						strlcpy(list[i].name,    title,   sizeof list[i].name);
@@ -615,7 +638,10 @@ HMS_fetch_servers (msg_server_t *list, int room_number, int query_id)
 			list[i].header.buffer[0] = 0;
 	}
 	else
+	{
+		free(list);
 		list = NULL;
+	}
 
 	HMS_end(hms);
 
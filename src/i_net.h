@@ -99,6 +99,10 @@ extern void (*I_NetSend)(void);
 */
 extern boolean (*I_NetCanSend)(void);
 
+/**	\brief send the packets the driver may have queued up, once per tic
+*/
+extern void (*I_NetFlush)(void);
+
 /**	\brief	close a connection
 
 	\param	nodenum	node to be closed
@@ -131,6 +135,40 @@ extern SINT8 I_NetMakeNode(const char *address);
 */
 extern SINT8 (*I_NetMakeNodewPort)(const char *address, const char *port);
 
+#define MAXNETADDRESSLENGTH 64 // enough for any numeric IPv6 address
+#define MAXNETPORTLENGTH 8
+
+/**	\brief	send the packet within doomcom to an address without giving it a node
+
+	\param	address	numeric address to send to, or NULL to broadcast on the LAN
+
+	\param	port	port to send to, or NULL for the default one
+
+	\return	false if the address could not be parsed or the packet could not be sent
+
+	\note	No name resolution is done, the address must already be numeric.
+*/
+extern boolean (*I_NetSendToAddress)(const char *address, const char *port);
+
+/**	\brief	get a packet sent to us in reply to I_NetSendToAddress
+
+	\param	address	filled with the numeric address of the sender, MAXNETADDRESSLENGTH bytes
+
+	\param	port	filled with the port of the sender, MAXNETPORTLENGTH bytes
+
+	\return	true if a packet was put in doomcom
+*/
+extern boolean (*I_NetGetFromAddress)(char *address, char *port);
+
+/**	\brief	reserve a node that has no address, for packets made inside the game
+
+	\return	number of node, or -1 if none is free
+
+	\note	The driver never sends to nor receives from such a node,
+		whoever asked for it has to wrap I_NetSend and I_NetGet.
+*/
+extern SINT8 (*I_NetMakeLocalNode)(void);
+
 /**	\brief open connection
 */
 extern boolean (*I_NetOpenSocket)(void);
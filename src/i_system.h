@@ -34,6 +34,11 @@ extern UINT8 graphics_started;
 */
 extern UINT8 keyboard_started;
 
+/**	\brief Set in a forked copy of the game, where I_Error must exit
+	at once without saving or shutting down anything the original owns
+*/
+extern boolean quieterror;
+
 /**	\brief	The I_GetFreeMem function
 
 	\param	total	total memory in the system
@@ -48,6 +53,15 @@ tic_t I_GetTime(void);
 
 int I_GetTimeMicros(void);// provides microsecond counter for render stats
 
+/**	\brief	Returns a high-resolution timer, for profiling.
+	Only the difference between two values means anything.
+*/
+precise_t I_GetPreciseTime(void);
+
+/**	\brief	Returns how many I_GetPreciseTime() units make up one second.
+*/
+UINT64 I_GetPrecisePrecision(void);
+
 /**	\brief	The I_Sleep function
 
 	\return	void
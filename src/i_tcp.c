@@ -12,6 +12,10 @@
 ///        This is not really OS-dependent because all OSes have the same socket API.
 ///        Just use ifdef for OS-dependent parts.
 
+#if defined (__linux__) && !defined (_GNU_SOURCE)
+#define _GNU_SOURCE // recvmmsg and sendmmsg
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -195,8 +199,27 @@
 	static mysockaddr_t broadcastaddress[MAXNETNODES+1];
 	static size_t broadcastaddresses = 0;
 	static boolean nodeconnected[MAXNETNODES+1];
+	static boolean nodelocal[MAXNETNODES+1]; // made by SOCK_NetMakeLocalNode, has no address
 	static mysockaddr_t banned[MAXBANS];
 	static UINT8 bannedmask[MAXBANS];
+
+	// Hash chains to find the node (or ban) of an address without going
+	// through all of them. Bans are hashed on their masked address, so every
+	// different mask in use has to be tried.
+	#define NODEHASHSIZE 256
+	#define BANHASHSIZE 128
+	static INT16 nodehash[NODEHASHSIZE];
+	static INT16 nodehashnext[MAXNETNODES+1];
+	static INT16 banhash[BANHASHSIZE];
+	static INT16 banhashnext[MAXBANS];
+	static INT32 banmasks[MAXBANS]; // family << 8 | mask
+	static size_t numbanmasks = 0;
+
+	#ifdef __linux__
+		// Move packets in and out in batches, one system call for several packets
+		#define SOCK_MMSG
+		#define MMSGBATCH 32
+	#endif
 #endif
 
 static size_t numbans = 0;
@@ -417,6 +440,8 @@ static const char *SOCK_GetNodeAddress(INT32 node)
 #else
 	if (!nodeconnected[node])
 		return NULL;
+	if (nodelocal[node])
+		return "local";
 	return SOCK_AddrToStr(&clientaddress[node]);
 #endif
 }
@@ -447,10 +472,25 @@ static const char *SOCK_GetBanMask(size_t ban)
 }
 
 #ifndef NONET
+// Number of address bits a mask covers, 0 meaning the whole address
+static UINT8 SOCK_MaskBits(int family, UINT8 mask)
+{
+#ifdef HAVE_IPV6
+	if (family == AF_INET6)
+		return (mask && mask < 128) ? mask : 128;
+#else
+	(void)family;
+#endif
+	return (mask && mask < 32) ? mask : 32;
+}
+
 static boolean SOCK_cmpaddr(mysockaddr_t *a, mysockaddr_t *b, UINT8 mask)
 {
 	UINT32 bitmask = INADDR_NONE;
 
+	if (a->any.sa_family != b->any.sa_family)
+		return false;
+
 	if (mask && mask < 32)
 		bitmask = htonl((UINT32)(-1) << (32 - mask));
 
@@ -459,13 +499,143 @@ static boolean SOCK_cmpaddr(mysockaddr_t *a, mysockaddr_t *b, UINT8 mask)
 			&& (b->ip4.sin_port == 0 || (a->ip4.sin_port == b->ip4.sin_port));
 #ifdef HAVE_IPV6
 	else if (b->any.sa_family == AF_INET6)
-		return memcmp(&a->ip6.sin6_addr, &b->ip6.sin6_addr, sizeof(b->ip6.sin6_addr))
-			&& (b->ip6.sin6_port == 0 || (a->ip6.sin6_port == b->ip6.sin6_port));
+	{
+		const UINT8 *aa = a->ip6.sin6_addr.s6_addr, *ba = b->ip6.sin6_addr.s6_addr;
+		UINT8 bits = SOCK_MaskBits(AF_INET6, mask);
+
+		for (; bits >= 8; bits -= 8)
+			if (*aa++ != *ba++)
+				return false;
+		if (bits && ((*aa ^ *ba) & (UINT8)(0xFF << (8 - bits))))
+			return false;
+		return (b->ip6.sin6_port == 0 || (a->ip6.sin6_port == b->ip6.sin6_port));
+	}
 #endif
 	else
 		return false;
 }
 
+// FNV-1a over the family, the first mask bits of the address, and the port if wanted
+static UINT32 SOCK_HashAddr(mysockaddr_t *sk, UINT8 mask, boolean withport)
+{
+	const UINT8 *addr;
+	UINT16 port;
+	UINT32 hash = 2166136261u;
+	UINT8 bits = SOCK_MaskBits(sk->any.sa_family, mask);
+
+	if (sk->any.sa_family == AF_INET)
+	{
+		addr = (const UINT8 *)&sk->ip4.sin_addr.s_addr;
+		port = sk->ip4.sin_port;
+	}
+#ifdef HAVE_IPV6
+	else if (sk->any.sa_family == AF_INET6)
+	{
+		addr = sk->ip6.sin6_addr.s6_addr;
+		port = sk->ip6.sin6_port;
+	}
+#endif
+	else
+		return 0;
+
+	hash = (hash ^ (UINT8)sk->any.sa_family) * 16777619u;
+	for (; bits >= 8; bits -= 8)
+		hash = (hash ^ *addr++) * 16777619u;
+	if (bits)
+		hash = (hash ^ (*addr & (UINT8)(0xFF << (8 - bits)))) * 16777619u;
+	if (withport)
+	{
+		hash = (hash ^ (port & 0xFF)) * 16777619u;
+		hash = (hash ^ (port >> 8)) * 16777619u;
+	}
+	return hash;
+}
+
+static void SOCK_UnlinkNodeAddress(INT32 node)
+{
+	INT16 *link = &nodehash[SOCK_HashAddr(&clientaddress[node], 0, true) & (NODEHASHSIZE-1)];
+
+	for (; *link != -1; link = &nodehashnext[*link])
+		if (*link == node)
+		{
+			*link = nodehashnext[node];
+			break;
+		}
+	nodehashnext[node] = -1;
+}
+
+static void SOCK_LinkNodeAddress(INT32 node)
+{
+	INT16 *link = &nodehash[SOCK_HashAddr(&clientaddress[node], 0, true) & (NODEHASHSIZE-1)];
+
+	// Append, so the lowest node still wins if two of them share an address
+	while (*link != -1)
+		link = &nodehashnext[*link];
+	*link = (INT16)node;
+	nodehashnext[node] = -1;
+}
+
+static void SOCK_ClearNodeHash(void)
+{
+	memset(nodehash, -1, sizeof (nodehash));
+	memset(nodehashnext, -1, sizeof (nodehashnext));
+}
+
+static INT32 SOCK_FindNodeAddress(mysockaddr_t *address)
+{
+	INT32 j;
+
+	for (j = nodehash[SOCK_HashAddr(address, 0, true) & (NODEHASHSIZE-1)]; j != -1; j = nodehashnext[j])
+		if (SOCK_cmpaddr(address, &clientaddress[j], 0))
+			return j;
+	return -1;
+}
+
+static void SOCK_RehashBans(void)
+{
+	size_t i, m;
+
+	memset(banhash, -1, sizeof (banhash));
+	numbanmasks = 0;
+
+	// Walk backwards so every chain ends up in ban order
+	for (i = numbans; i--;)
+	{
+		const int family = banned[i].any.sa_family;
+		const INT32 key = family << 8 | SOCK_MaskBits(family, bannedmask[i]);
+		INT16 *head = &banhash[SOCK_HashAddr(&banned[i], bannedmask[i], false) & (BANHASHSIZE-1)];
+
+		banhashnext[i] = *head;
+		*head = (INT16)i;
+
+		for (m = 0; m < numbanmasks; m++)
+			if (banmasks[m] == key)
+				break;
+		if (m == numbanmasks)
+			banmasks[numbanmasks++] = key;
+	}
+}
+
+static boolean SOCK_IsBanned(mysockaddr_t *address)
+{
+	size_t m;
+	INT32 i;
+
+	for (m = 0; m < numbanmasks; m++)
+	{
+		const UINT8 mask = (UINT8)(banmasks[m] & 0xFF);
+
+		if ((banmasks[m] >> 8) != address->any.sa_family)
+			continue;
+
+		for (i = banhash[SOCK_HashAddr(address, mask, false) & (BANHASHSIZE-1)]; i != -1; i = banhashnext[i])
+			if (SOCK_MaskBits(banned[i].any.sa_family, bannedmask[i]) == mask
+				&& SOCK_cmpaddr(address, &banned[i], bannedmask[i]))
+				return true;
+	}
+	return false;
+}
+
 // This is a hack. For some reason, nodes aren't being freed properly.
 // This goes through and cleans up what nodes were supposed to be freed.
 /** \warning This function causes the file downloading to stop if someone joins.
@@ -481,7 +651,7 @@ static void cleanupnodes(void)
 
 	// Why can't I start at zero?
 	for (j = 1; j < MAXNETNODES; j++)
-		if (!(nodeingame[j] || SendingFile(j)))
+		if (!(nodeingame[j] || SendingFile(j) || nodelocal[j]))
 			nodeconnected[j] = false;
 }
 
@@ -553,11 +723,156 @@ void Command_Numnodes(void)
 #endif
 
 #ifndef NONET
+/** Finds the node a packet came from, or gives it a new one
+  *
+  * \param fromaddress Where the packet came from
+  * \param fromlen     Length of the address
+  * \param socket      The socket the packet came in through
+  * \param newnode     Set to true if the node is a new one
+  * \return The node number, or -1 if there are no free nodes left
+  *
+  */
+static INT32 SOCK_NodeOfAddress(mysockaddr_t *fromaddress, socklen_t fromlen, SOCKET_TYPE socket, boolean *newnode)
+{
+	INT32 j;
+
+	// find remote node number
+	j = SOCK_FindNodeAddress(fromaddress);
+	if (j > 0)
+	{
+		nodesocket[j] = socket;
+		*newnode = false;
+		return j;
+	}
+	// not found
+
+	// find a free slot
+	j = getfreenode();
+	if (j > 0)
+	{
+		SOCK_UnlinkNodeAddress(j);
+		M_Memcpy(&clientaddress[j], fromaddress, fromlen);
+		SOCK_LinkNodeAddress(j);
+		nodesocket[j] = socket;
+		DEBFILE(va("New node detected: node:%d address:%s\n", j,
+				SOCK_GetNodeAddress(j)));
+
+		// check if it's a banned dude so we can send a refusal later
+		SOCK_bannednode[j] = SOCK_IsBanned(fromaddress);
+		if (SOCK_bannednode[j])
+			DEBFILE("This dude has been banned\n");
+		*newnode = true;
+		return j;
+	}
+
+	DEBFILE("New node detected: No more free slots\n");
+	return -1;
+}
+
+#ifdef SOCK_MMSG
+static struct
+{
+	UINT8 data[MAXPACKETLENGTH];
+	mysockaddr_t address;
+	INT16 node;
+} recvbatch[MMSGBATCH], sendbatch[MMSGBATCH];
+static struct iovec recviov[MMSGBATCH], sendiov[MMSGBATCH];
+static struct mmsghdr recvmsgs[MMSGBATCH], sendmsgs[MMSGBATCH];
+static SOCKET_TYPE sendsocket[MMSGBATCH];
+static size_t recvcount = 0, recvpos = 0, nextrecvsocket = 0;
+static size_t sendcount = 0;
+static SOCKET_TYPE recvsocket;
+
+// Sends all the queued packets, in as few system calls as possible
+static void SOCK_FlushSend(void)
+{
+	size_t i = 0, n;
+	int c;
+
+	while (i < sendcount)
+	{
+		// packets going out through the same socket are sent together
+		for (n = i + 1; n < sendcount && sendsocket[n] == sendsocket[i]; n++)
+			;
+
+		c = sendmmsg(sendsocket[i], &sendmsgs[i], (unsigned int)(n - i), 0);
+		if (c == ERRSOCKET) // the first packet couldn't be sent
+		{
+			int e = errno; // save error code so it can't be modified later
+			if (e != ECONNREFUSED && e != EWOULDBLOCK)
+				I_Error("SOCK_Send, error sending to node %d (%s) #%u: %s", sendbatch[i].node,
+					SOCK_AddrToStr(&sendbatch[i].address), e, strerror(e));
+			c = 1; // drop it, like a failed sendto would
+		}
+		i += c;
+	}
+
+	sendcount = 0;
+}
+
+// Reads as many waiting packets as possible from the next socket that has any
+static boolean SOCK_RecvBatch(void)
+{
+	size_t i, n;
+	int c;
+
+	for (n = 0; n < mysocketses; n++)
+	{
+		const SOCKET_TYPE socket = mysockets[nextrecvsocket];
+		nextrecvsocket = (nextrecvsocket + 1) % mysocketses;
+
+		for (i = 0; i < MMSGBATCH; i++)
+		{
+			recviov[i].iov_base = recvbatch[i].data;
+			recviov[i].iov_len = MAXPACKETLENGTH;
+			memset(&recvmsgs[i], 0, sizeof (recvmsgs[i]));
+			recvmsgs[i].msg_hdr.msg_name = &recvbatch[i].address;
+			recvmsgs[i].msg_hdr.msg_namelen = (socklen_t)sizeof (recvbatch[i].address);
+			recvmsgs[i].msg_hdr.msg_iov = &recviov[i];
+			recvmsgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		c = recvmmsg(socket, recvmsgs, MMSGBATCH, MSG_DONTWAIT, NULL);
+		if (c > 0)
+		{
+			recvcount = (size_t)c;
+			recvpos = 0;
+			recvsocket = socket;
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
 // Returns true if a packet was received from a new node, false in all other cases
 static boolean SOCK_Get(void)
 {
-	size_t i, n;
-	int j;
+	INT32 j;
+	boolean newnode;
+#ifdef SOCK_MMSG
+	// Whatever was queued up to now should have left before we wait for answers
+	SOCK_FlushSend();
+
+	do
+	{
+		while (recvpos < recvcount)
+		{
+			const size_t k = recvpos++;
+
+			j = SOCK_NodeOfAddress(&recvbatch[k].address, recvmsgs[k].msg_hdr.msg_namelen, recvsocket, &newnode);
+			if (j != -1)
+			{
+				M_Memcpy(&doomcom->data, recvbatch[k].data, recvmsgs[k].msg_len);
+				doomcom->remotenode = (INT16)j; // good packet from a game player
+				doomcom->datalength = (INT16)recvmsgs[k].msg_len;
+				return newnode;
+			}
+		}
+	} while (SOCK_RecvBatch());
+#else
+	size_t n;
 	ssize_t c;
 	mysockaddr_t fromaddress;
 	socklen_t fromlen;
@@ -569,48 +884,16 @@ static boolean SOCK_Get(void)
 			(void *)&fromaddress, &fromlen);
 		if (c != ERRSOCKET)
 		{
-			// find remote node number
-			for (j = 1; j <= MAXNETNODES; j++) //include LAN
+			j = SOCK_NodeOfAddress(&fromaddress, fromlen, mysockets[n], &newnode);
+			if (j != -1)
 			{
-				if (SOCK_cmpaddr(&fromaddress, &clientaddress[j], 0))
-				{
-					doomcom->remotenode = (INT16)j; // good packet from a game player
-					doomcom->datalength = (INT16)c;
-					nodesocket[j] = mysockets[n];
-					return false;
-				}
-			}
-			// not found
-
-			// find a free slot
-			j = getfreenode();
-			if (j > 0)
-			{
-				M_Memcpy(&clientaddress[j], &fromaddress, fromlen);
-				nodesocket[j] = mysockets[n];
-				DEBFILE(va("New node detected: node:%d address:%s\n", j,
-						SOCK_GetNodeAddress(j)));
 				doomcom->remotenode = (INT16)j; // good packet from a game player
 				doomcom->datalength = (INT16)c;
-
-				// check if it's a banned dude so we can send a refusal later
-				for (i = 0; i < numbans; i++)
-				{
-					if (SOCK_cmpaddr(&fromaddress, &banned[i], bannedmask[i]))
-					{
-						SOCK_bannednode[j] = true;
-						DEBFILE("This dude has been banned\n");
-						break;
-					}
-				}
-				if (i == numbans)
-					SOCK_bannednode[j] = false;
-				return true;
+				return newnode;
 			}
-			else
-				DEBFILE("New node detected: No more free slots\n");
 		}
 	}
+#endif
 
 	doomcom->remotenode = -1; // no packet
 	return false;
@@ -688,7 +971,29 @@ static inline ssize_t SOCK_SendToAddr(SOCKET_TYPE socket, mysockaddr_t *sockaddr
 		default:       d = da; break;
 	}
 
+#ifdef SOCK_MMSG
+	// Queue it up, it leaves with the next flush
+	if (sendcount == MMSGBATCH)
+		SOCK_FlushSend();
+
+	M_Memcpy(sendbatch[sendcount].data, &doomcom->data, doomcom->datalength);
+	M_Memcpy(&sendbatch[sendcount].address, sockaddr, d);
+	sendbatch[sendcount].node = doomcom->remotenode;
+	sendsocket[sendcount] = socket;
+
+	sendiov[sendcount].iov_base = sendbatch[sendcount].data;
+	sendiov[sendcount].iov_len = doomcom->datalength;
+	memset(&sendmsgs[sendcount], 0, sizeof (sendmsgs[sendcount]));
+	sendmsgs[sendcount].msg_hdr.msg_name = &sendbatch[sendcount].address;
+	sendmsgs[sendcount].msg_hdr.msg_namelen = d;
+	sendmsgs[sendcount].msg_hdr.msg_iov = &sendiov[sendcount];
+	sendmsgs[sendcount].msg_hdr.msg_iovlen = 1;
+	sendcount++;
+
+	return doomcom->datalength;
+#else
 	return sendto(socket, (char *)&doomcom->data, doomcom->datalength, 0, &sockaddr->any, d);
+#endif
 }
 
 static void SOCK_Send(void)
@@ -745,9 +1050,11 @@ static void SOCK_FreeNodenum(INT32 numnode)
 	DEBFILE(va("Free node %d (%s)\n", numnode, SOCK_GetNodeAddress(numnode)));
 
 	nodeconnected[numnode] = false;
+	nodelocal[numnode] = false;
 	nodesocket[numnode] = ERRSOCKET;
 
 	// put invalid address
+	SOCK_UnlinkNodeAddress(numnode);
 	memset(&clientaddress[numnode], 0, sizeof (clientaddress[numnode]));
 }
 #endif
@@ -1080,6 +1387,217 @@ static boolean UDP_Socket(void)
 
 	return true;
 }
+
+//
+// Server browser
+//
+// Server queries go out of their own sockets, bound to any port, so that the
+// replies never reach SOCK_Get and never take up a node. Servers are only
+// known by their address until we actually connect to one.
+//
+static SOCKET_TYPE browsersockets[2] = {ERRSOCKET, ERRSOCKET};
+static int browserfamily[2];
+static size_t browsersocketses = 0;
+
+static SOCKET_TYPE BrowserBind(int family)
+{
+	SOCKET_TYPE s = socket(family, SOCK_DGRAM, IPPROTO_UDP);
+	mysockaddr_t addr;
+	socklen_t addrlen;
+	int opt;
+#ifdef FIONBIO
+#ifdef WATTCP
+	char trueval = true;
+#else
+	unsigned long trueval = true;
+#endif
+#endif
+
+	if (s == (SOCKET_TYPE)ERRSOCKET)
+		return (SOCKET_TYPE)ERRSOCKET;
+
+	memset(&addr, 0, sizeof (addr));
+	addr.any.sa_family = family;
+#ifdef HAVE_IPV6
+	if (family == AF_INET6)
+	{
+		addr.ip6.sin6_addr = in6addr_any;
+		addrlen = (socklen_t)sizeof (struct sockaddr_in6);
+#ifdef IPV6_V6ONLY
+		opt = true;
+		setsockopt(s, SOL_SOCKET, IPV6_V6ONLY, (char *)&opt, (socklen_t)sizeof (opt));
+#endif
+	}
+	else
+#endif
+	{
+		addr.ip4.sin_addr.s_addr = htonl(INADDR_ANY);
+		addrlen = (socklen_t)sizeof (struct sockaddr_in);
+		// for LAN queries
+		opt = true;
+		setsockopt(s, SOL_SOCKET, SO_BROADCAST, (char *)&opt, (socklen_t)sizeof (opt));
+	}
+
+	if (bind(s, &addr.any, addrlen) == ERRSOCKET)
+	{
+		close(s);
+		return (SOCKET_TYPE)ERRSOCKET;
+	}
+
+#ifdef FIONBIO
+	if (ioctl(s, FIONBIO, &trueval) != 0)
+	{
+		close(s);
+		return (SOCKET_TYPE)ERRSOCKET;
+	}
+#endif
+
+	return s;
+}
+
+static void SOCK_OpenBrowserSockets(void)
+{
+	if (browsersocketses)
+		return;
+
+	browsersockets[browsersocketses] = BrowserBind(AF_INET);
+	if (browsersockets[browsersocketses] != (SOCKET_TYPE)ERRSOCKET)
+		browserfamily[browsersocketses++] = AF_INET;
+#ifdef HAVE_IPV6
+	if (M_CheckParm("-ipv6"))
+	{
+		browsersockets[browsersocketses] = BrowserBind(AF_INET6);
+		if (browsersockets[browsersocketses] != (SOCKET_TYPE)ERRSOCKET)
+			browserfamily[browsersocketses++] = AF_INET6;
+	}
+#endif
+
+	if (!browsersocketses)
+		CONS_Alert(CONS_WARNING, M_GetText("Could not open a socket to query servers\n"));
+}
+
+static void SOCK_CloseBrowserSockets(void)
+{
+	size_t i;
+
+	for (i = 0; i < browsersocketses; i++)
+	{
+		close(browsersockets[i]);
+		browsersockets[i] = ERRSOCKET;
+	}
+	browsersocketses = 0;
+}
+
+static boolean SOCK_BrowserSendTo(mysockaddr_t *sockaddr, socklen_t addrlen)
+{
+	size_t i;
+
+	for (i = 0; i < browsersocketses; i++)
+		if (browserfamily[i] == sockaddr->any.sa_family)
+			return sendto(browsersockets[i], (char *)&doomcom->data, doomcom->datalength, 0,
+				&sockaddr->any, addrlen) != ERRSOCKET;
+	return false;
+}
+
+static boolean SOCK_SendToAddress(const char *address, const char *port)
+{
+	struct my_addrinfo *ai, *runp, hints;
+	boolean sent = false;
+	size_t i;
+
+	if (!port || !port[0])
+		port = DEFAULTPORT;
+
+	SOCK_OpenBrowserSockets();
+
+	if (address == NULL)
+	{
+		const UINT16 nport = htons((UINT16)atoi(port));
+		mysockaddr_t sockaddr;
+
+		for (i = 0; i < broadcastaddresses; i++)
+		{
+			M_Memcpy(&sockaddr, &broadcastaddress[i], sizeof (sockaddr));
+#ifdef HAVE_IPV6
+			if (sockaddr.any.sa_family == AF_INET6)
+			{
+				sockaddr.ip6.sin6_port = nport;
+				sent |= SOCK_BrowserSendTo(&sockaddr, (socklen_t)sizeof (struct sockaddr_in6));
+			}
+			else
+#endif
+			{
+				sockaddr.ip4.sin_port = nport;
+				sent |= SOCK_BrowserSendTo(&sockaddr, (socklen_t)sizeof (struct sockaddr_in));
+			}
+		}
+		return sent;
+	}
+
+	// Numeric only, a name here would stall us while it resolves
+	memset(&hints, 0x00, sizeof (hints));
+	hints.ai_flags = AI_NUMERICHOST;
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_protocol = IPPROTO_UDP;
+
+	if (I_getaddrinfo(address, port, &hints, &ai) != 0)
+	{
+		DEBFILE(va("Can't query %s@%s: not a numeric address\n", address, port));
+		return false;
+	}
+
+	for (runp = ai; runp != NULL && !sent; runp = runp->ai_next)
+		sent = SOCK_BrowserSendTo((mysockaddr_t *)runp->ai_addr, (socklen_t)runp->ai_addrlen);
+
+	I_freeaddrinfo(ai);
+	return sent;
+}
+
+static boolean SOCK_GetFromAddress(char *address, char *port)
+{
+	mysockaddr_t fromaddress;
+	socklen_t fromlen;
+	ssize_t c;
+	size_t i;
+
+	for (i = 0; i < browsersocketses; i++)
+	{
+		fromlen = (socklen_t)sizeof (fromaddress);
+		c = recvfrom(browsersockets[i], (char *)&doomcom->data, MAXPACKETLENGTH, 0,
+			(void *)&fromaddress, &fromlen);
+		if (c == ERRSOCKET)
+			continue;
+
+#ifdef HAVE_IPV6
+		if (fromaddress.any.sa_family == AF_INET6)
+		{
+			if (inet_ntop(AF_INET6, &fromaddress.ip6.sin6_addr, address, MAXNETADDRESSLENGTH) == NULL)
+				continue;
+			snprintf(port, MAXNETPORTLENGTH, "%u", ntohs(fromaddress.ip6.sin6_port));
+		}
+		else
+#endif
+		if (fromaddress.any.sa_family == AF_INET)
+		{
+#ifdef HAVE_NTOP
+			if (inet_ntop(AF_INET, &fromaddress.ip4.sin_addr, address, MAXNETADDRESSLENGTH) == NULL)
+				continue;
+#else
+			strlcpy(address, inet_ntoa(fromaddress.ip4.sin_addr), MAXNETADDRESSLENGTH);
+#endif
+			snprintf(port, MAXNETPORTLENGTH, "%u", ntohs(fromaddress.ip4.sin_port));
+		}
+		else
+			continue;
+
+		doomcom->remotenode = -1;
+		doomcom->datalength = (INT16)c;
+		return true;
+	}
+
+	return false;
+}
 #endif
 
 boolean I_InitTcpDriver(void)
@@ -1212,6 +1730,10 @@ boolean I_InitTcpDriver(void)
 static void SOCK_CloseSocket(void)
 {
 	size_t i;
+#ifdef SOCK_MMSG
+	SOCK_FlushSend();
+	recvcount = recvpos = nextrecvsocket = 0;
+#endif
 	for (i=0; i < MAXNETNODES+1; i++)
 	{
 		if (mysockets[i] != (SOCKET_TYPE)ERRSOCKET
@@ -1224,6 +1746,7 @@ static void SOCK_CloseSocket(void)
 		}
 		mysockets[i] = ERRSOCKET;
 	}
+	SOCK_CloseBrowserSockets();
 }
 #endif
 
@@ -1286,7 +1809,9 @@ static SINT8 SOCK_NetMakeNodewPort(const char *address, const char *port)
 		// find ip of the server
 		if (sendto(mysockets[0], NULL, 0, 0, runp->ai_addr, runp->ai_addrlen) == 0)
 		{
+			SOCK_UnlinkNodeAddress(newnode);
 			memcpy(&clientaddress[newnode], runp->ai_addr, runp->ai_addrlen);
+			SOCK_LinkNodeAddress(newnode);
 			break;
 		}
 		runp = runp->ai_next;
@@ -1296,22 +1821,49 @@ static SINT8 SOCK_NetMakeNodewPort(const char *address, const char *port)
 }
 #endif
 
+#ifndef NONET
+static SINT8 SOCK_NetMakeLocalNode(void)
+{
+	SINT8 newnode = getfreenode();
+
+	if (newnode <= 0)
+		return -1;
+
+	// No address, so SOCK_Send never finds a socket for it
+	// and no incoming packet can ever be matched to it
+	SOCK_UnlinkNodeAddress(newnode);
+	memset(&clientaddress[newnode], 0, sizeof (clientaddress[newnode]));
+	nodesocket[newnode] = ERRSOCKET;
+	nodelocal[newnode] = true;
+	DEBFILE(va("New local node: node:%d\n", newnode));
+	return newnode;
+}
+#endif
+
 static boolean SOCK_OpenSocket(void)
 {
 #ifndef NONET
 	size_t i;
 
 	memset(clientaddress, 0, sizeof (clientaddress));
+	SOCK_ClearNodeHash();
 
 	nodeconnected[0] = true; // always connected to self
 	for (i = 1; i < MAXNETNODES; i++)
 		nodeconnected[i] = false;
 	nodeconnected[BROADCASTADDR] = true;
+	memset(nodelocal, 0, sizeof (nodelocal));
 	I_NetSend = SOCK_Send;
 	I_NetGet = SOCK_Get;
 	I_NetCloseSocket = SOCK_CloseSocket;
 	I_NetFreeNodenum = SOCK_FreeNodenum;
 	I_NetMakeNodewPort = SOCK_NetMakeNodewPort;
+	I_NetSendToAddress = SOCK_SendToAddress;
+	I_NetGetFromAddress = SOCK_GetFromAddress;
+	I_NetMakeLocalNode = SOCK_NetMakeLocalNode;
+#ifdef SOCK_MMSG
+	I_NetFlush = SOCK_FlushSend;
+#endif
 
 #ifdef SELECTTEST
 	// seem like not work with libsocket : (
@@ -1351,6 +1903,7 @@ static boolean SOCK_Ban(INT32 node)
 	}
 #endif
 	numbans++;
+	SOCK_RehashBans();
 	return true;
 #endif
 }
@@ -1404,6 +1957,7 @@ static boolean SOCK_SetBanAddress(const char *address, const char *mask)
 	}
 
 	I_freeaddrinfo(ai);
+	SOCK_RehashBans();
 
 	return true;
 #endif
@@ -1412,6 +1966,9 @@ static boolean SOCK_SetBanAddress(const char *address, const char *mask)
 static void SOCK_ClearBans(void)
 {
 	numbans = 0;
+#ifndef NONET
+	SOCK_RehashBans();
+#endif
 }
 
 boolean I_InitTcpNetwork(void)
@@ -23,6 +23,9 @@
 #include "lua_hook.h"
 #include "lua_hud.h" // hud_running errors
 
+#include "i_system.h" // I_GetPreciseTime
+#include "d_main.h" // srb2home
+
 static UINT8 hooksAvailable[(hook_MAX/8)+1];
 
 const char *const hookNames[hook_MAX+1] = {
@@ -77,50 +80,323 @@ const char *const hookNames[hook_MAX+1] = {
 // Hook metadata
 struct hook_s
 {
-	struct hook_s *next;
 	enum hook type;
-	UINT16 id;
+	int ref; // of the function, in the registry
 	union {
 		mobjtype_t mt;
 		char *str;
 	} s;
 	boolean error;
+	hookprof_t *prof;
 };
 typedef struct hook_s* hook_p;
 
-#define FMT_HOOKID "hook_%d"
+// The hooks for one event, in the order they were added
+typedef struct
+{
+	struct hook_s *hooks;
+	size_t numhooks;
+} hooklist_t;
+
+#define FOR_HOOKS(hookp, list) for (hookp = (list)->hooks; hookp < (list)->hooks + (list)->numhooks; hookp++)
+
+// Hooks that take a mobj type get a list for every type, so calling them
+// only goes through the hooks for MT_NULL (all types) and the mobj's own.
+// The lists for a hook are made the first time one is added.
+static hooklist_t *mobjhooks[hook_MAX];
+static UINT8 mobjhooksAvailable[NUMMOBJTYPES][(hook_MAX/8)+1];
+
+// Every other hook has just the one list
+static hooklist_t hooks[hook_MAX];
 
-// For each mobj type, a linked list to its thinker and collision hooks.
-// That way, we don't have to iterate through all the hooks.
-// We could do that with all other mobj hooks, but it would probably just be
-// a waste of memory since they are only called occasionally. Probably...
-static hook_p mobjthinkerhooks[NUMMOBJTYPES];
-static hook_p mobjcollidehooks[NUMMOBJTYPES];
+static hooklist_t nohooks;
 
-// For each mobj type, a linked list for other mobj hooks
-static hook_p mobjhooks[NUMMOBJTYPES];
+// While set, no mobj hook is called; see LUAh_SuspendMobjHooks
+static boolean mobjhookssuspended = false;
 
-// A linked list for player hooks
-static hook_p playerhooks;
+static boolean IsMobjHook(enum hook type)
+{
+	switch (type)
+	{
+	case hook_MobjSpawn:
+	case hook_MobjCollide:
+	case hook_MobjLineCollide:
+	case hook_MobjMoveCollide:
+	case hook_TouchSpecial:
+	case hook_MobjFuse:
+	case hook_MobjThinker:
+	case hook_BossThinker:
+	case hook_ShouldDamage:
+	case hook_MobjDamage:
+	case hook_MobjDeath:
+	case hook_BossDeath:
+	case hook_MobjRemoved:
+	case hook_MobjMoveBlocked:
+	case hook_MapThingSpawn:
+	case hook_FollowMobj:
+		return true;
+	default:
+		return false;
+	}
+}
 
-// A linked list for linedef executor hooks
-static hook_p linedefexecutorhooks;
+static inline hooklist_t *MobjHooks(enum hook which, mobjtype_t mt)
+{
+	return mobjhooks[which] ? &mobjhooks[which][mt] : &nohooks;
+}
 
-// For other hooks, a unique linked list
-hook_p roothook;
+// Are there any hooks for this mobj type, or for every type?
+static inline boolean MobjHooksAvailable(enum hook which, mobjtype_t mt)
+{
+	if (mobjhookssuspended)
+		return false;
+	return ((mobjhooksAvailable[MT_NULL][which/8] | mobjhooksAvailable[mt][which/8]) & (1<<(which%8))) != 0;
+}
 
 static void PushHook(lua_State *L, hook_p hookp)
 {
-	lua_pushfstring(L, FMT_HOOKID, hookp->id);
-	lua_gettable(L, LUA_REGISTRYINDEX);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, hookp->ref);
+}
+
+//
+// Hook profiling
+//
+// With hookprofile on, every call to a Lua hook or HUD function is timed
+// and charged to the function itself, which is named by the script and
+// line it was defined on. Times include anything the function set off,
+// nested hooks included. hookprofile_dump appends the costliest functions
+// to hookprof.txt every so many seconds.
+//
+
+static void HookProfile_OnChange(void);
+
+static CV_PossibleValue_t hookprofiledump_cons_t[] = {{0, "MIN"}, {3600, "MAX"}, {0, NULL}};
+consvar_t cv_hookprofile = {"hookprofile", "Off", CV_CALL, CV_OnOff, HookProfile_OnChange, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_hookprofiledump = {"hookprofile_dump", "0", 0, hookprofiledump_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+typedef struct
+{
+	precise_t time; // total time spent
+	precise_t peak; // longest single call
+	UINT32 calls;
+} hookstat_t;
+
+struct hookprof_s
+{
+	struct hookprof_s *next; // every function, in the order they were added
+	char kind[32]; // hook name
+	char source[LUA_IDSIZE];
+	int line;
+	hookstat_t total; // since profiling started
+	hookstat_t recent; // since the last dump
+};
+
+static hookprof_t *hookprofs = NULL;
+static hookprof_t **lasthookprof = &hookprofs;
+static size_t numhookprofs = 0;
+static tic_t hookprofstart, hookproflastdump;
+static size_t hookprofsortoffset;
+
+// Makes a profile for the function at idx
+hookprof_t *LUA_NewHookProfile(lua_State *L, int idx, const char *kind)
+{
+	hookprof_t *prof = Z_Calloc(sizeof (*prof), PU_STATIC, NULL);
+	lua_Debug ar;
+
+	lua_pushvalue(L, idx);
+	lua_getinfo(L, ">S", &ar);
+
+	strlcpy(prof->kind, kind, sizeof (prof->kind));
+	strlcpy(prof->source, ar.short_src, sizeof (prof->source));
+	prof->line = ar.linedefined;
+
+	*lasthookprof = prof;
+	lasthookprof = &prof->next;
+	numhookprofs++;
+	return prof;
+}
+
+static void HookProfile_OnChange(void)
+{
+	hookprof_t *prof;
+
+	for (prof = hookprofs; prof; prof = prof->next)
+	{
+		memset(&prof->total, 0, sizeof (prof->total));
+		memset(&prof->recent, 0, sizeof (prof->recent));
+	}
+
+	hookprofstart = hookproflastdump = I_GetTime();
+}
+
+static int HookProfile_Compare(const void *p1, const void *p2)
+{
+	const hookstat_t *stat1 = (const hookstat_t *)(*(const char *const *)p1 + hookprofsortoffset);
+	const hookstat_t *stat2 = (const hookstat_t *)(*(const char *const *)p2 + hookprofsortoffset);
+	if (stat1->time != stat2->time)
+		return (stat1->time > stat2->time) ? -1 : 1;
+	return 0;
+}
+
+// Lists the profiles with any calls, costliest first
+static size_t HookProfile_Sort(hookprof_t **order, size_t offset)
+{
+	hookprof_t *prof;
+	size_t count = 0;
+
+	for (prof = hookprofs; prof; prof = prof->next)
+		if (((hookstat_t *)((char *)prof + offset))->calls)
+			order[count++] = prof;
+
+	hookprofsortoffset = offset;
+	qsort(order, count, sizeof (*order), HookProfile_Compare);
+	return count;
+}
+
+static UINT32 HookProfile_Micros(precise_t time)
+{
+	return (UINT32)(time * 1000000 / I_GetPrecisePrecision());
+}
+
+static void HookProfile_Dump(void)
+{
+	hookprof_t **order;
+	size_t i, count;
+	FILE *f;
+
+	f = fopen(va("%s"PATHSEP"%s", srb2home, "hookprof.txt"), "a");
+	if (!f)
+		return;
+
+	order = Z_Malloc(numhookprofs * sizeof (*order), PU_STATIC, NULL);
+	count = HookProfile_Sort(order, offsetof(hookprof_t, recent));
+
+	fprintf(f, "-- %u seconds, gametic %u --\n", (I_GetTime() - hookproflastdump) / NEWTICRATE, gametic);
+	for (i = 0; i < count && i < 20; i++)
+	{
+		const hookstat_t *stat = &order[i]->recent;
+		fprintf(f, "%-20s %s:%d: %u calls, %u us, %u us peak\n", order[i]->kind, order[i]->source, order[i]->line,
+			stat->calls, HookProfile_Micros(stat->time), HookProfile_Micros(stat->peak));
+	}
+
+	Z_Free(order);
+	fclose(f);
+}
+
+// Returns 0 if there's no need to time anything
+precise_t LUA_HookProfileStart(void)
+{
+	return cv_hookprofile.value ? I_GetPreciseTime() : 0;
+}
+
+void LUA_HookProfileEnd(hookprof_t *prof, precise_t start)
+{
+	precise_t time;
+
+	if (!start || !prof)
+		return;
+
+	time = I_GetPreciseTime() - start;
+
+	prof->total.time += time;
+	prof->total.calls++;
+	if (time > prof->total.peak)
+		prof->total.peak = time;
+
+	prof->recent.time += time;
+	prof->recent.calls++;
+	if (time > prof->recent.peak)
+		prof->recent.peak = time;
+
+	if (cv_hookprofiledump.value && I_GetTime() - hookproflastdump >= (tic_t)cv_hookprofiledump.value * NEWTICRATE)
+	{
+		hookprof_t *p;
+
+		HookProfile_Dump();
+
+		for (p = hookprofs; p; p = p->next)
+			memset(&p->recent, 0, sizeof (p->recent));
+		hookproflastdump = I_GetTime();
+	}
+}
+
+void Command_Hookprof_f(void)
+{
+	hookprof_t **order;
+	size_t i, count, limit = 15;
+	tic_t seconds;
+
+	if (!cv_hookprofile.value)
+	{
+		CONS_Printf(M_GetText("Hook profiling is off. Set \"hookprofile\" to \"On\" to start it.\n"));
+		return;
+	}
+
+	if (COM_Argc() >= 2)
+	{
+		if (!stricmp(COM_Argv(1), "reset"))
+		{
+			HookProfile_OnChange();
+			return;
+		}
+
+		limit = atoi(COM_Argv(1));
+		if (!limit)
+		{
+			CONS_Printf(M_GetText("hookprof [<count>]: Show the costliest Lua hooks since profiling started\n"
+				"hookprof reset: Start over\n"));
+			return;
+		}
+	}
+
+	if (!numhookprofs)
+	{
+		CONS_Printf(M_GetText("No hooks have been added.\n"));
+		return;
+	}
+
+	seconds = max((I_GetTime() - hookprofstart) / NEWTICRATE, 1);
+
+	order = Z_Malloc(numhookprofs * sizeof (*order), PU_STATIC, NULL);
+	count = HookProfile_Sort(order, offsetof(hookprof_t, total));
+
+	CONS_Printf(M_GetText("Lua hooks over the last %u seconds:\n"), seconds);
+	CONS_Printf(" %-20s %8s %8s %8s %8s  %s\n", "Hook", "calls/s", "us/s", "us/call", "peak", "Function");
+	for (i = 0; i < count && i < limit; i++)
+	{
+		const hookstat_t *stat = &order[i]->total;
+		CONS_Printf(" %-20s %8u %8u %8u %8u  %s:%d\n", order[i]->kind,
+			stat->calls / seconds,
+			HookProfile_Micros(stat->time) / seconds,
+			HookProfile_Micros(stat->time) / stat->calls,
+			HookProfile_Micros(stat->peak),
+			order[i]->source, order[i]->line);
+	}
+
+	Z_Free(order);
+}
+
+// Calls the hook on top of the stack, timing it if need be
+static int CallHook(hook_p hookp, int nargs, int nresults, int errfunc)
+{
+	precise_t start;
+	int ret;
+
+	if (!cv_hookprofile.value)
+		return lua_pcall(gL, nargs, nresults, errfunc);
+
+	start = LUA_HookProfileStart();
+	ret = lua_pcall(gL, nargs, nresults, errfunc);
+	LUA_HookProfileEnd(hookp->prof, start);
+	return ret;
 }
 
 // Takes hook, function, and additional arguments (mobj type to act on, etc.)
 static int lib_addHook(lua_State *L)
 {
-	static struct hook_s hook = {NULL, 0, 0, {0}, false};
-	static UINT32 nextid;
-	hook_p hookp, *lastp;
+	static struct hook_s hook = {0, 0, {0}, false, NULL};
+	hooklist_t *list;
+	hook_p hookp;
 
 	hook.type = luaL_checkoption(L, 1, NULL, hookNames);
 	lua_remove(L, 1);
@@ -175,77 +451,41 @@ static int lib_addHook(lua_State *L)
 
 	hooksAvailable[hook.type/8] |= 1<<(hook.type%8);
 
-	// set hook.id to the highest id + 1
-	hook.id = nextid++;
-
-	// Special cases for some hook types (see the comments above mobjthinkerhooks declaration)
-	switch(hook.type)
+	if (IsMobjHook(hook.type))
 	{
-	case hook_MobjThinker:
-		lastp = &mobjthinkerhooks[hook.s.mt];
-		break;
-	case hook_MobjCollide:
-	case hook_MobjLineCollide:
-	case hook_MobjMoveCollide:
-		lastp = &mobjcollidehooks[hook.s.mt];
-		break;
-	case hook_MobjSpawn:
-	case hook_TouchSpecial:
-	case hook_MobjFuse:
-	case hook_BossThinker:
-	case hook_ShouldDamage:
-	case hook_MobjDamage:
-	case hook_MobjDeath:
-	case hook_BossDeath:
-	case hook_MobjRemoved:
-	case hook_MobjMoveBlocked:
-	case hook_MapThingSpawn:
-	case hook_FollowMobj:
-		lastp = &mobjhooks[hook.s.mt];
-		break;
-	case hook_JumpSpecial:
-	case hook_AbilitySpecial:
-	case hook_SpinSpecial:
-	case hook_JumpSpinSpecial:
-	case hook_PlayerSpawn:
-	case hook_PlayerCanDamage:
-	case hook_TeamSwitch:
-	case hook_ViewpointSwitch:
-	case hook_SeenPlayer:
-	case hook_ShieldSpawn:
-	case hook_ShieldSpecial:
-	case hook_PlayerThink:
-		lastp = &playerhooks;
-		break;
-	case hook_LinedefExecute:
-		lastp = &linedefexecutorhooks;
-		break;
-	default:
-		lastp = &roothook;
-		break;
+		if (!mobjhooks[hook.type])
+			mobjhooks[hook.type] = Z_Calloc(NUMMOBJTYPES * sizeof (hooklist_t), PU_STATIC, NULL);
+		list = &mobjhooks[hook.type][hook.s.mt];
+		mobjhooksAvailable[hook.s.mt][hook.type/8] |= 1<<(hook.type%8);
 	}
+	else
+		list = &hooks[hook.type];
 
-	// iterate the hook metadata structs
-	// set lastp to the last hook struct's "next" pointer.
-	for (hookp = *lastp; hookp; hookp = hookp->next)
-		lastp = &hookp->next;
-	// allocate a permanent memory struct to stuff hook.
-	hookp = ZZ_Alloc(sizeof(struct hook_s));
+	// tack it onto the end of the list.
+	list->hooks = Z_Realloc(list->hooks, (list->numhooks + 1) * sizeof (*list->hooks), PU_STATIC, NULL);
+	hookp = &list->hooks[list->numhooks++];
 	memcpy(hookp, &hook, sizeof(struct hook_s));
-	// tack it onto the end of the linked list.
-	*lastp = hookp;
+	hookp->prof = LUA_NewHookProfile(L, 1, hookNames[hook.type]);
 
-	// set the hook function in the registry.
-	lua_pushfstring(L, FMT_HOOKID, hook.id);
+	// keep the hook function in the registry.
 	lua_pushvalue(L, 1);
-	lua_settable(L, LUA_REGISTRYINDEX);
+	hookp->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	// parked collectibles skip the mobj thinker hooks
+	if (hook.type == hook_MobjThinker && ISINLEVEL)
+		P_WakeParkedCollectibles();
 	return 0;
 }
 
 int LUA_HookLib(lua_State *L)
 {
 	memset(hooksAvailable,0,sizeof(UINT8[(hook_MAX/8)+1]));
-	roothook = NULL;
+	memset(mobjhooksAvailable,0,sizeof(mobjhooksAvailable));
+	memset(mobjhooks,0,sizeof(mobjhooks));
+	memset(hooks,0,sizeof(hooks));
+	hookprofs = NULL;
+	lasthookprof = &hookprofs;
+	numhookprofs = 0;
 	lua_register(L, "addHook", lib_addHook);
 	return 0;
 }
@@ -254,25 +494,22 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
-		return false;
-
 	I_Assert(mo->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(which, mo->type))
+		return false;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(which, MT_NULL))
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -284,16 +521,13 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[mo->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(which, mo->type))
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -319,16 +553,13 @@ boolean LUAh_PlayerHook(player_t *plr, enum hook which)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[which])
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 			LUA_PushUserdata(gL, plr, META_PLAYER);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -355,14 +586,11 @@ void LUAh_MapChange(INT16 mapnumber)
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 	lua_pushinteger(gL, mapnumber);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_MapChange])
 	{
-		if (hookp->type != hook_MapChange)
-			continue;
-
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 0, 1)) {
+		if (CallHook(hookp, 1, 0, 1)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -382,14 +610,11 @@ void LUAh_MapLoad(void)
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 	lua_pushinteger(gL, gamemap);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_MapLoad])
 	{
-		if (hookp->type != hook_MapLoad)
-			continue;
-
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 0, 1)) {
+		if (CallHook(hookp, 1, 0, 1)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -409,14 +634,11 @@ void LUAh_PlayerJoin(int playernum)
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 	lua_pushinteger(gL, playernum);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_PlayerJoin])
 	{
-		if (hookp->type != hook_PlayerJoin)
-			continue;
-
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 0, 1)) {
+		if (CallHook(hookp, 1, 0, 1)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -434,13 +656,10 @@ void LUAh_PreThinkFrame(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_PreThinkFrame])
 	{
-		if (hookp->type != hook_PreThinkFrame)
-			continue;
-
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -460,13 +679,10 @@ void LUAh_ThinkFrame(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_ThinkFrame])
 	{
-		if (hookp->type != hook_ThinkFrame)
-			continue;
-
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -486,13 +702,10 @@ void LUAh_PostThinkFrame(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_PostThinkFrame])
 	{
-		if (hookp->type != hook_PostThinkFrame)
-			continue;
-
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -508,20 +721,17 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 {
 	hook_p hookp;
 	UINT8 shouldCollide = 0; // 0 = default, 1 = force yes, 2 = force no.
-	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
-		return 0;
-
 	I_Assert(thing1->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(which, thing1->type))
+		return 0;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj collision hooks
-	for (hookp = mobjcollidehooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(which, MT_NULL))
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, thing1, META_MOBJ);
@@ -530,7 +740,7 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -547,11 +757,8 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjcollidehooks[thing1->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(which, thing1->type))
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, thing1, META_MOBJ);
@@ -560,7 +767,7 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -585,20 +792,17 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 {
 	hook_p hookp;
 	UINT8 shouldCollide = 0; // 0 = default, 1 = force yes, 2 = force no.
-	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
-		return 0;
-
 	I_Assert(thing->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(which, thing->type))
+		return 0;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj collision hooks
-	for (hookp = mobjcollidehooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(which, MT_NULL))
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, thing, META_MOBJ);
@@ -607,7 +811,7 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -624,11 +828,8 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjcollidehooks[thing->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(which, thing->type))
 	{
-		if (hookp->type != which)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, thing, META_MOBJ);
@@ -637,7 +838,7 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -658,27 +859,39 @@ UINT8 LUAh_MobjLineCollideHook(mobj_t *thing, line_t *line, enum hook which)
 	return shouldCollide;
 }
 
+// Stops calling mobj hooks, so the engine can move objects about
+// for its own ends (like the checkposbench command) without scripts noticing
+void LUAh_SuspendMobjHooks(boolean suspend)
+{
+	mobjhookssuspended = suspend;
+}
+
 // Hook for mobj thinkers
+boolean LUAh_MobjThinkerHooked(mobjtype_t type)
+{
+	return gL && MobjHooksAvailable(hook_MobjThinker, type);
+}
+
 boolean LUAh_MobjThinker(mobj_t *mo)
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[hook_MobjThinker/8] & (1<<(hook_MobjThinker%8))))
-		return false;
-
 	I_Assert(mo->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(hook_MobjThinker, mo->type))
+		return false;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj thinker hooks
-	for (hookp = mobjthinkerhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MobjThinker, MT_NULL))
 	{
 		if (lua_gettop(gL) == 1)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -690,13 +903,13 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjthinkerhooks[mo->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MobjThinker, mo->type))
 	{
 		if (lua_gettop(gL) == 1)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 1)) {
+		if (CallHook(hookp, 1, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -717,20 +930,17 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[hook_TouchSpecial/8] & (1<<(hook_TouchSpecial%8))))
-		return 0;
-
 	I_Assert(special->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(hook_TouchSpecial, special->type))
+		return 0;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic touch special hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_TouchSpecial, MT_NULL))
 	{
-		if (hookp->type != hook_TouchSpecial)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, special, META_MOBJ);
@@ -739,7 +949,7 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -751,11 +961,8 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[special->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_TouchSpecial, special->type))
 	{
-		if (hookp->type != hook_TouchSpecial)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, special, META_MOBJ);
@@ -764,7 +971,7 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -785,20 +992,17 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 {
 	hook_p hookp;
 	UINT8 shouldDamage = 0; // 0 = default, 1 = force yes, 2 = force no.
-	if (!gL || !(hooksAvailable[hook_ShouldDamage/8] & (1<<(hook_ShouldDamage%8))))
-		return 0;
-
 	I_Assert(target->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(hook_ShouldDamage, target->type))
+		return 0;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic should damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_ShouldDamage, MT_NULL))
 	{
-		if (hookp->type != hook_ShouldDamage)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -813,7 +1017,7 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -830,10 +1034,8 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_ShouldDamage, target->type))
 	{
-		if (hookp->type != hook_ShouldDamage)
-			continue;
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -848,7 +1050,7 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -874,20 +1076,17 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[hook_MobjDamage/8] & (1<<(hook_MobjDamage%8))))
-		return 0;
-
 	I_Assert(target->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(hook_MobjDamage, target->type))
+		return 0;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MobjDamage, MT_NULL))
 	{
-		if (hookp->type != hook_MobjDamage)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -902,7 +1101,7 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -914,11 +1113,8 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MobjDamage, target->type))
 	{
-		if (hookp->type != hook_MobjDamage)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -933,7 +1129,7 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -954,20 +1150,17 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[hook_MobjDeath/8] & (1<<(hook_MobjDeath%8))))
-		return 0;
-
 	I_Assert(target->type < NUMMOBJTYPES);
 
+	if (!gL || !MobjHooksAvailable(hook_MobjDeath, target->type))
+		return 0;
+
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj death hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MobjDeath, MT_NULL))
 	{
-		if (hookp->type != hook_MobjDeath)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -980,7 +1173,7 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -992,11 +1185,8 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MobjDeath, target->type))
 	{
-		if (hookp->type != hook_MobjDeath)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -1009,7 +1199,7 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1036,11 +1226,8 @@ boolean LUAh_BotTiccmd(player_t *bot, ticcmd_t *cmd)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_BotTiccmd])
 	{
-		if (hookp->type != hook_BotTiccmd)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, bot, META_PLAYER);
@@ -1049,7 +1236,7 @@ boolean LUAh_BotTiccmd(player_t *bot, ticcmd_t *cmd)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1076,10 +1263,9 @@ boolean LUAh_BotAI(mobj_t *sonic, mobj_t *tails, ticcmd_t *cmd)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_BotAI])
 	{
-		if (hookp->type != hook_BotAI
-		|| (hookp->s.str && strcmp(hookp->s.str, ((skin_t*)tails->skin)->name)))
+		if (hookp->s.str && strcmp(hookp->s.str, ((skin_t*)tails->skin)->name))
 			continue;
 
 		if (lua_gettop(gL) == 1)
@@ -1090,7 +1276,7 @@ boolean LUAh_BotAI(mobj_t *sonic, mobj_t *tails, ticcmd_t *cmd)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 8, 1)) {
+		if (CallHook(hookp, 2, 8, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1139,11 +1325,8 @@ boolean LUAh_BotRespawn(mobj_t *sonic, mobj_t *tails)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_BotRespawn])
 	{
-		if (hookp->type != hook_BotRespawn)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, sonic, META_MOBJ);
@@ -1152,7 +1335,7 @@ boolean LUAh_BotRespawn(mobj_t *sonic, mobj_t *tails)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1184,7 +1367,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = linedefexecutorhooks; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_LinedefExecute])
 	{
 		if (strcmp(hookp->s.str, line->stringargs[0]))
 			continue;
@@ -1199,7 +1382,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
-		if (lua_pcall(gL, 3, 0, 1)) {
+		if (CallHook(hookp, 3, 0, 1)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -1221,11 +1404,8 @@ boolean LUAh_PlayerMsg(int source, int target, int flags, char *msg)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_PlayerMsg])
 	{
-		if (hookp->type != hook_PlayerMsg)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, &players[source], META_PLAYER); // Source player
@@ -1249,7 +1429,7 @@ boolean LUAh_PlayerMsg(int source, int target, int flags, char *msg)
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1277,10 +1457,9 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source, UINT8
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_HurtMsg])
 	{
-		if (hookp->type != hook_HurtMsg
-		|| (hookp->s.mt && !(inflictor && hookp->s.mt == inflictor->type)))
+		if (hookp->s.mt && !(inflictor && hookp->s.mt == inflictor->type))
 			continue;
 
 		if (lua_gettop(gL) == 1)
@@ -1295,7 +1474,7 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source, UINT8
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
 		lua_pushvalue(gL, -5);
-		if (lua_pcall(gL, 4, 1, 1)) {
+		if (CallHook(hookp, 4, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1330,14 +1509,11 @@ void LUAh_NetArchiveHook(lua_CFunction archFunc)
 	lua_pushcclosure(gL, archFunc, 1);
 	// stack: tables, archFunc
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_NetVars])
 	{
-		if (hookp->type != hook_NetVars)
-			continue;
-
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -2); // archFunc
-		if (lua_pcall(gL, 1, 0, errorhandlerindex)) {
+		if (CallHook(hookp, 1, 0, errorhandlerindex)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -1351,18 +1527,15 @@ boolean LUAh_MapThingSpawn(mobj_t *mo, mapthing_t *mthing)
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[hook_MapThingSpawn/8] & (1<<(hook_MapThingSpawn%8))))
+	if (!gL || !MobjHooksAvailable(hook_MapThingSpawn, mo->type))
 		return false;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj map thing spawn hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MapThingSpawn, MT_NULL))
 	{
-		if (hookp->type != hook_MapThingSpawn)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, mo, META_MOBJ);
@@ -1371,7 +1544,7 @@ boolean LUAh_MapThingSpawn(mobj_t *mo, mapthing_t *mthing)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1383,11 +1556,8 @@ boolean LUAh_MapThingSpawn(mobj_t *mo, mapthing_t *mthing)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[mo->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_MapThingSpawn, mo->type))
 	{
-		if (hookp->type != hook_MapThingSpawn)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, mo, META_MOBJ);
@@ -1396,7 +1566,7 @@ boolean LUAh_MapThingSpawn(mobj_t *mo, mapthing_t *mthing)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1417,18 +1587,15 @@ boolean LUAh_FollowMobj(player_t *player, mobj_t *mobj)
 {
 	hook_p hookp;
 	boolean hooked = false;
-	if (!gL || !(hooksAvailable[hook_FollowMobj/8] & (1<<(hook_FollowMobj%8))))
+	if (!gL || !MobjHooksAvailable(hook_FollowMobj, mobj->type))
 		return 0;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
 	// Look for all generic mobj follow item hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_FollowMobj, MT_NULL))
 	{
-		if (hookp->type != hook_FollowMobj)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, player, META_PLAYER);
@@ -1437,7 +1604,7 @@ boolean LUAh_FollowMobj(player_t *player, mobj_t *mobj)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1449,11 +1616,8 @@ boolean LUAh_FollowMobj(player_t *player, mobj_t *mobj)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[mobj->type]; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, MobjHooks(hook_FollowMobj, mobj->type))
 	{
-		if (hookp->type != hook_FollowMobj)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, player, META_PLAYER);
@@ -1462,7 +1626,7 @@ boolean LUAh_FollowMobj(player_t *player, mobj_t *mobj)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1489,11 +1653,8 @@ UINT8 LUAh_PlayerCanDamage(player_t *player, mobj_t *mobj)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_PlayerCanDamage])
 	{
-		if (hookp->type != hook_PlayerCanDamage)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, player, META_PLAYER);
@@ -1502,7 +1663,7 @@ UINT8 LUAh_PlayerCanDamage(player_t *player, mobj_t *mobj)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1532,11 +1693,8 @@ void LUAh_PlayerQuit(player_t *plr, kickreason_t reason)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_PlayerQuit])
 	{
-		if (hookp->type != hook_PlayerQuit)
-			continue;
-
 	    if (lua_gettop(gL) == 1)
 	    {
 	        LUA_PushUserdata(gL, plr, META_PLAYER); // Player that quit
@@ -1545,7 +1703,7 @@ void LUAh_PlayerQuit(player_t *plr, kickreason_t reason)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 0, 1)) {
+		if (CallHook(hookp, 2, 0, 1)) {
 			CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
 		}
@@ -1563,13 +1721,10 @@ void LUAh_IntermissionThinker(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_IntermissionThinker])
 	{
-		if (hookp->type != hook_IntermissionThinker)
-			continue;
-
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1592,11 +1747,8 @@ boolean LUAh_TeamSwitch(player_t *player, int newteam, boolean fromspectators, b
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_TeamSwitch])
 	{
-		if (hookp->type != hook_TeamSwitch)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, player, META_PLAYER);
@@ -1611,7 +1763,7 @@ boolean LUAh_TeamSwitch(player_t *player, int newteam, boolean fromspectators, b
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
 		lua_pushvalue(gL, -6);
-		if (lua_pcall(gL, 5, 1, 1)) {
+		if (CallHook(hookp, 5, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1640,11 +1792,8 @@ UINT8 LUAh_ViewpointSwitch(player_t *player, player_t *newdisplayplayer, boolean
 
 	hud_running = true; // local hook
 
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_ViewpointSwitch])
 	{
-		if (hookp->type != hook_ViewpointSwitch)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, player, META_PLAYER);
@@ -1655,7 +1804,7 @@ UINT8 LUAh_ViewpointSwitch(player_t *player, player_t *newdisplayplayer, boolean
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
 		lua_pushvalue(gL, -4);
-		if (lua_pcall(gL, 3, 1, 1)) {
+		if (CallHook(hookp, 3, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1693,11 +1842,8 @@ boolean LUAh_SeenPlayer(player_t *player, player_t *seenfriend)
 
 	hud_running = true; // local hook
 
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_SeenPlayer])
 	{
-		if (hookp->type != hook_SeenPlayer)
-			continue;
-
 		if (lua_gettop(gL) == 1)
 		{
 			LUA_PushUserdata(gL, player, META_PLAYER);
@@ -1706,7 +1852,7 @@ boolean LUAh_SeenPlayer(player_t *player, player_t *seenfriend)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1738,10 +1884,9 @@ boolean LUAh_ShouldJingleContinue(player_t *player, const char *musname)
 
 	hud_running = true; // local hook
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_ShouldJingleContinue])
 	{
-		if (hookp->type != hook_ShouldJingleContinue
-			|| (hookp->s.str && strcmp(hookp->s.str, musname)))
+		if (hookp->s.str && strcmp(hookp->s.str, musname))
 			continue;
 
 		if (lua_gettop(gL) == 1)
@@ -1752,7 +1897,7 @@ boolean LUAh_ShouldJingleContinue(player_t *player, const char *musname)
 		PushHook(gL, hookp);
 		lua_pushvalue(gL, -3);
 		lua_pushvalue(gL, -3);
-		if (lua_pcall(gL, 2, 1, 1)) {
+		if (CallHook(hookp, 2, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -1780,13 +1925,10 @@ void LUAh_GameQuit(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	FOR_HOOKS(hookp, &hooks[hook_GameQuit])
 	{
-		if (hookp->type != hook_GameQuit)
-			continue;
-
 		PushHook(gL, hookp);
-		if (lua_pcall(gL, 0, 0, 1)) {
+		if (CallHook(hookp, 0, 0, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -112,6 +112,17 @@ static const char *const hudhook_opt[] = {
 	"titlecard",
 	NULL};
 
+// Hook profile for each function in HUD[2+], by hudhook and index
+static hookprof_t **hudhookprofs[hudhook_titlecard+1];
+static size_t numhudhookprofs[hudhook_titlecard+1];
+
+static hookprof_t *HUD_HookProfile(enum hudhook field, lua_Integer idx)
+{
+	if (idx < 1 || (size_t)idx > numhudhookprofs[field])
+		return NULL;
+	return hudhookprofs[field][idx-1];
+}
+
 // alignment types for v.drawString
 enum align {
 	align_left = 0,
@@ -1227,6 +1238,9 @@ static int lib_hudadd(lua_State *L)
 	lua_pushvalue(L, 1);
 	lua_rawseti(L, -2, (int)(lua_objlen(L, -2) + 1));
 
+	hudhookprofs[field] = Z_Realloc(hudhookprofs[field], (numhudhookprofs[field] + 1) * sizeof (*hudhookprofs[field]), PU_STATIC, NULL);
+	hudhookprofs[field][numhudhookprofs[field]++] = LUA_NewHookProfile(L, 1, va("HUD %s", hudhook_opt[field]));
+
 	hudAvailable |= 1<<field;
 	return 0;
 }
@@ -1246,6 +1260,7 @@ static luaL_Reg lib_hud[] = {
 int LUA_HudLib(lua_State *L)
 {
 	memset(hud_enabled, 0xff, (hud_MAX/8)+1);
+	memset(numhudhookprofs, 0, sizeof (numhudhookprofs));
 
 #ifdef LUA_PATCH_SAFETY
 	numluapatches = 0;
@@ -1348,10 +1363,14 @@ void LUAh_GameHUD(player_t *stplayr)
 
 	lua_pushnil(gL);
 	while (lua_next(gL, -5) != 0) {
+		hookprof_t *prof = HUD_HookProfile(hudhook_game, lua_tointeger(gL, -2));
+		precise_t start;
 		lua_pushvalue(gL, -5); // graphics library (HUD[1])
 		lua_pushvalue(gL, -5); // stplayr
 		lua_pushvalue(gL, -5); // camera
+		start = LUA_HookProfileStart();
 		LUA_Call(gL, 3);
+		LUA_HookProfileEnd(prof, start);
 	}
 	lua_pop(gL, -1);
 	hud_running = false;
@@ -1375,8 +1394,12 @@ void LUAh_ScoresHUD(void)
 	lua_remove(gL, -3); // pop HUD
 	lua_pushnil(gL);
 	while (lua_next(gL, -3) != 0) {
+		hookprof_t *prof = HUD_HookProfile(hudhook_scores, lua_tointeger(gL, -2));
+		precise_t start;
 		lua_pushvalue(gL, -3); // graphics library (HUD[1])
+		start = LUA_HookProfileStart();
 		LUA_Call(gL, 1);
+		LUA_HookProfileEnd(prof, start);
 	}
 	lua_pop(gL, -1);
 	hud_running = false;
@@ -1400,8 +1423,12 @@ void LUAh_TitleHUD(void)
 	lua_remove(gL, -3); // pop HUD
 	lua_pushnil(gL);
 	while (lua_next(gL, -3) != 0) {
+		hookprof_t *prof = HUD_HookProfile(hudhook_title, lua_tointeger(gL, -2));
+		precise_t start;
 		lua_pushvalue(gL, -3); // graphics library (HUD[1])
+		start = LUA_HookProfileStart();
 		LUA_Call(gL, 1);
+		LUA_HookProfileEnd(prof, start);
 	}
 	lua_pop(gL, -1);
 	hud_running = false;
@@ -1430,11 +1457,15 @@ void LUAh_TitleCardHUD(player_t *stplayr)
 	lua_pushnil(gL);
 
 	while (lua_next(gL, -6) != 0) {
+		hookprof_t *prof = HUD_HookProfile(hudhook_titlecard, lua_tointeger(gL, -2));
+		precise_t start;
 		lua_pushvalue(gL, -6); // graphics library (HUD[1])
 		lua_pushvalue(gL, -6); // stplayr
 		lua_pushvalue(gL, -6); // lt_ticker
 		lua_pushvalue(gL, -6); // lt_endtime
+		start = LUA_HookProfileStart();
 		LUA_Call(gL, 4);
+		LUA_HookProfileEnd(prof, start);
 	}
 
 	lua_pop(gL, -1);
@@ -1459,8 +1490,12 @@ void LUAh_IntermissionHUD(void)
 	lua_remove(gL, -3); // pop HUD
 	lua_pushnil(gL);
 	while (lua_next(gL, -3) != 0) {
+		hookprof_t *prof = HUD_HookProfile(hudhook_intermission, lua_tointeger(gL, -2));
+		precise_t start;
 		lua_pushvalue(gL, -3); // graphics library (HUD[1])
+		start = LUA_HookProfileStart();
 		LUA_Call(gL, 1);
+		LUA_HookProfileEnd(prof, start);
 	}
 	lua_pop(gL, -1);
 	hud_running = false;
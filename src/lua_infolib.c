@@ -29,6 +29,7 @@
 extern CV_PossibleValue_t Color_cons_t[];
 extern UINT8 skincolor_modified[];
 
+boolean LUA_HasAction(const char *action);
 boolean LUA_CallAction(const char *action, mobj_t *actor);
 state_t *astate;
 
@@ -49,6 +50,8 @@ const char *const sfxinfo_ropt[] = {
 	"skinsound",
 	NULL};
 
+static int sfxinfo_read_fields_ref = LUA_NOREF;
+
 enum sfxinfo_write {
 	sfxinfow_singular = 0,
 	sfxinfow_priority,
@@ -62,6 +65,8 @@ const char *const sfxinfo_wopt[] = {
 	"caption",
 	NULL};
 
+static int sfxinfo_write_fields_ref = LUA_NOREF;
+
 //
 // Sprite Names
 //
@@ -800,6 +805,24 @@ boolean LUA_SetLuaAction(void *stv, const char *action)
 	return true; // action successfully set.
 }
 
+// Has Lua replaced this action?
+// action is assumed to be in all-caps already !!
+boolean LUA_HasAction(const char *action)
+{
+	boolean found;
+
+	I_Assert(action != NULL);
+
+	if (!gL)
+		return false;
+
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_ACTIONS);
+	lua_getfield(gL, -1, action);
+	found = !lua_isnil(gL, -1);
+	lua_pop(gL, 2); // pop the function (or nil) and LREG_ACTIONS
+	return found;
+}
+
 boolean LUA_CallAction(const char *csaction, mobj_t *actor)
 {
 	I_Assert(csaction != NULL);
@@ -850,20 +873,48 @@ boolean LUA_CallAction(const char *csaction, mobj_t *actor)
 	return true; // action successfully called.
 }
 
+enum state_e {
+	state_sprite = 0,
+	state_frame,
+	state_tics,
+	state_action,
+	state_var1,
+	state_var2,
+	state_nextstate
+};
+
+static const char *const state_opt[] = {
+	"sprite",
+	"frame",
+	"tics",
+	"action",
+	"var1",
+	"var2",
+	"nextstate",
+	NULL};
+
+static int state_fields_ref = LUA_NOREF;
+
 // state_t *, field -> number
 static int state_get(lua_State *L)
 {
 	state_t *st = *((state_t **)luaL_checkudata(L, 1, META_STATE));
-	const char *field = luaL_checkstring(L, 2);
+	enum state_e field = Lua_optoption(L, 2, -1, state_fields_ref);
 	lua_Integer number;
 
-	if (fastcmp(field,"sprite"))
+	switch(field)
+	{
+	case state_sprite:
 		number = st->sprite;
-	else if (fastcmp(field,"frame"))
+		break;
+	case state_frame:
 		number = st->frame;
-	else if (fastcmp(field,"tics"))
+		break;
+	case state_tics:
 		number = st->tics;
-	else if (fastcmp(field,"action")) {
+		break;
+	case state_action:
+	{
 		const char *name;
 		if (!st->action.acp1) // Action is NULL.
 			return 0; // return nil.
@@ -882,16 +933,21 @@ static int state_get(lua_State *L)
 		// because the metatable will trigger.
 		lua_getglobal(L, name); // actually gets from LREG_ACTIONS if applicable, and pushes a META_ACTION userdata if not.
 		return 1; // return just the function
-	} else if (fastcmp(field,"var1"))
+	}
+	case state_var1:
 		number = st->var1;
-	else if (fastcmp(field,"var2"))
+		break;
+	case state_var2:
 		number = st->var2;
-	else if (fastcmp(field,"nextstate"))
+		break;
+	case state_nextstate:
 		number = st->nextstate;
-	else if (devparm)
-		return luaL_error(L, LUA_QL("state_t") " has no field named " LUA_QS, field);
-	else
+		break;
+	default:
+		if (devparm)
+			return luaL_error(L, LUA_QL("state_t") " has no field named " LUA_QS, lua_tostring(L, 2));
 		return 0;
+	}
 
 	lua_pushinteger(L, number);
 	return 1;
@@ -901,22 +957,27 @@ static int state_get(lua_State *L)
 static int state_set(lua_State *L)
 {
 	state_t *st = *((state_t **)luaL_checkudata(L, 1, META_STATE));
-	const char *field = luaL_checkstring(L, 2);
+	enum state_e field = Lua_optoption(L, 2, -1, state_fields_ref);
 	lua_Integer value;
 
 	if (hud_running)
 		return luaL_error(L, "Do not alter states in HUD rendering code!");
 
-	if (fastcmp(field,"sprite")) {
+	switch(field)
+	{
+	case state_sprite:
 		value = luaL_checknumber(L, 3);
 		if (value < SPR_NULL || value >= NUMSPRITES)
 			return luaL_error(L, "sprite number %d is invalid.", value);
 		st->sprite = (spritenum_t)value;
-	} else if (fastcmp(field,"frame"))
+		break;
+	case state_frame:
 		st->frame = (UINT32)luaL_checknumber(L, 3);
-	else if (fastcmp(field,"tics"))
+		break;
+	case state_tics:
 		st->tics = (INT32)luaL_checknumber(L, 3);
-	else if (fastcmp(field,"action")) {
+		break;
+	case state_action:
 		switch(lua_type(L, 3))
 		{
 		case LUA_TNIL: // Null? Set the action to nothing, then.
@@ -949,17 +1010,22 @@ static int state_set(lua_State *L)
 		default: // ?!
 			return luaL_typerror(L, 3, "function");
 		}
-	} else if (fastcmp(field,"var1"))
+		break;
+	case state_var1:
 		st->var1 = (INT32)luaL_checknumber(L, 3);
-	else if (fastcmp(field,"var2"))
+		break;
+	case state_var2:
 		st->var2 = (INT32)luaL_checknumber(L, 3);
-	else if (fastcmp(field,"nextstate")) {
+		break;
+	case state_nextstate:
 		value = luaL_checkinteger(L, 3);
 		if (value < S_NULL || value >= NUMSTATES)
 			return luaL_error(L, "nextstate number %d is invalid.", value);
 		st->nextstate = (statenum_t)value;
-	} else
-		return luaL_error(L, LUA_QL("state_t") " has no field named " LUA_QS, field);
+		break;
+	default:
+		return luaL_error(L, LUA_QL("state_t") " has no field named " LUA_QS, lua_tostring(L, 2));
+	}
 
 	return 0;
 }
@@ -1092,75 +1158,158 @@ static int lib_mobjinfolen(lua_State *L)
 	return 1;
 }
 
+enum mobjinfo_e {
+	mobjinfo_doomednum = 0,
+	mobjinfo_spawnstate,
+	mobjinfo_spawnhealth,
+	mobjinfo_seestate,
+	mobjinfo_seesound,
+	mobjinfo_reactiontime,
+	mobjinfo_attacksound,
+	mobjinfo_painstate,
+	mobjinfo_painchance,
+	mobjinfo_painsound,
+	mobjinfo_meleestate,
+	mobjinfo_missilestate,
+	mobjinfo_deathstate,
+	mobjinfo_xdeathstate,
+	mobjinfo_deathsound,
+	mobjinfo_speed,
+	mobjinfo_radius,
+	mobjinfo_height,
+	mobjinfo_dispoffset,
+	mobjinfo_mass,
+	mobjinfo_damage,
+	mobjinfo_activesound,
+	mobjinfo_flags,
+	mobjinfo_raisestate
+};
+
+static const char *const mobjinfo_opt[] = {
+	"doomednum",
+	"spawnstate",
+	"spawnhealth",
+	"seestate",
+	"seesound",
+	"reactiontime",
+	"attacksound",
+	"painstate",
+	"painchance",
+	"painsound",
+	"meleestate",
+	"missilestate",
+	"deathstate",
+	"xdeathstate",
+	"deathsound",
+	"speed",
+	"radius",
+	"height",
+	"dispoffset",
+	"mass",
+	"damage",
+	"activesound",
+	"flags",
+	"raisestate",
+	NULL};
+
+static int mobjinfo_fields_ref = LUA_NOREF;
+
 // mobjinfo_t *, field -> number
 static int mobjinfo_get(lua_State *L)
 {
 	mobjinfo_t *info = *((mobjinfo_t **)luaL_checkudata(L, 1, META_MOBJINFO));
-	const char *field = luaL_checkstring(L, 2);
+	enum mobjinfo_e field = Lua_optoption(L, 2, -1, mobjinfo_fields_ref);
 
 	I_Assert(info != NULL);
 	I_Assert(info >= mobjinfo);
 
-	if (fastcmp(field,"doomednum"))
+	switch(field)
+	{
+	case mobjinfo_doomednum:
 		lua_pushinteger(L, info->doomednum);
-	else if (fastcmp(field,"spawnstate"))
+		break;
+	case mobjinfo_spawnstate:
 		lua_pushinteger(L, info->spawnstate);
-	else if (fastcmp(field,"spawnhealth"))
+		break;
+	case mobjinfo_spawnhealth:
 		lua_pushinteger(L, info->spawnhealth);
-	else if (fastcmp(field,"seestate"))
+		break;
+	case mobjinfo_seestate:
 		lua_pushinteger(L, info->seestate);
-	else if (fastcmp(field,"seesound"))
+		break;
+	case mobjinfo_seesound:
 		lua_pushinteger(L, info->seesound);
-	else if (fastcmp(field,"reactiontime"))
+		break;
+	case mobjinfo_reactiontime:
 		lua_pushinteger(L, info->reactiontime);
-	else if (fastcmp(field,"attacksound"))
+		break;
+	case mobjinfo_attacksound:
 		lua_pushinteger(L, info->attacksound);
-	else if (fastcmp(field,"painstate"))
+		break;
+	case mobjinfo_painstate:
 		lua_pushinteger(L, info->painstate);
-	else if (fastcmp(field,"painchance"))
+		break;
+	case mobjinfo_painchance:
 		lua_pushinteger(L, info->painchance);
-	else if (fastcmp(field,"painsound"))
+		break;
+	case mobjinfo_painsound:
 		lua_pushinteger(L, info->painsound);
-	else if (fastcmp(field,"meleestate"))
+		break;
+	case mobjinfo_meleestate:
 		lua_pushinteger(L, info->meleestate);
-	else if (fastcmp(field,"missilestate"))
+		break;
+	case mobjinfo_missilestate:
 		lua_pushinteger(L, info->missilestate);
-	else if (fastcmp(field,"deathstate"))
+		break;
+	case mobjinfo_deathstate:
 		lua_pushinteger(L, info->deathstate);
-	else if (fastcmp(field,"xdeathstate"))
+		break;
+	case mobjinfo_xdeathstate:
 		lua_pushinteger(L, info->xdeathstate);
-	else if (fastcmp(field,"deathsound"))
+		break;
+	case mobjinfo_deathsound:
 		lua_pushinteger(L, info->deathsound);
-	else if (fastcmp(field,"speed"))
+		break;
+	case mobjinfo_speed:
 		lua_pushinteger(L, info->speed); // sometimes it's fixed_t, sometimes it's not...
-	else if (fastcmp(field,"radius"))
+		break;
+	case mobjinfo_radius:
 		lua_pushfixed(L, info->radius);
-	else if (fastcmp(field,"height"))
+		break;
+	case mobjinfo_height:
 		lua_pushfixed(L, info->height);
-	else if (fastcmp(field,"dispoffset"))
+		break;
+	case mobjinfo_dispoffset:
 		lua_pushinteger(L, info->dispoffset);
-	else if (fastcmp(field,"mass"))
+		break;
+	case mobjinfo_mass:
 		lua_pushinteger(L, info->mass);
-	else if (fastcmp(field,"damage"))
+		break;
+	case mobjinfo_damage:
 		lua_pushinteger(L, info->damage);
-	else if (fastcmp(field,"activesound"))
+		break;
+	case mobjinfo_activesound:
 		lua_pushinteger(L, info->activesound);
-	else if (fastcmp(field,"flags"))
+		break;
+	case mobjinfo_flags:
 		lua_pushinteger(L, info->flags);
-	else if (fastcmp(field,"raisestate"))
+		break;
+	case mobjinfo_raisestate:
 		lua_pushinteger(L, info->raisestate);
-	else {
+		break;
+	default:
 		lua_getfield(L, LUA_REGISTRYINDEX, LREG_EXTVARS);
 		I_Assert(lua_istable(L, -1));
 		lua_pushlightuserdata(L, info);
 		lua_rawget(L, -2);
 		if (!lua_istable(L, -1)) { // no extra values table
-			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "mobjinfo_t", field);
+			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "mobjinfo_t", lua_tostring(L, 2));
 			return 0;
 		}
-		lua_getfield(L, -1, field);
+		lua_getfield(L, -1, lua_tostring(L, 2));
 		if (lua_isnil(L, -1)) // no value for this field
-			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "mobjinfo_t", field);
+			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "mobjinfo_t", lua_tostring(L, 2));
+		break;
 	}
 	return 1;
 }
@@ -1169,7 +1318,7 @@ static int mobjinfo_get(lua_State *L)
 static int mobjinfo_set(lua_State *L)
 {
 	mobjinfo_t *info = *((mobjinfo_t **)luaL_checkudata(L, 1, META_MOBJINFO));
-	const char *field = luaL_checkstring(L, 2);
+	enum mobjinfo_e field = Lua_optoption(L, 2, -1, mobjinfo_fields_ref);
 
 	if (hud_running)
 		return luaL_error(L, "Do not alter mobjinfo in HUD rendering code!");
@@ -1177,55 +1326,81 @@ static int mobjinfo_set(lua_State *L)
 	I_Assert(info != NULL);
 	I_Assert(info >= mobjinfo);
 
-	if (fastcmp(field,"doomednum"))
+	switch(field)
+	{
+	case mobjinfo_doomednum:
 		info->doomednum = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spawnstate"))
+		break;
+	case mobjinfo_spawnstate:
 		info->spawnstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spawnhealth"))
+		break;
+	case mobjinfo_spawnhealth:
 		info->spawnhealth = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seestate"))
+		break;
+	case mobjinfo_seestate:
 		info->seestate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seesound"))
+		break;
+	case mobjinfo_seesound:
 		info->seesound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"reactiontime"))
+		break;
+	case mobjinfo_reactiontime:
 		info->reactiontime = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"attacksound"))
+		break;
+	case mobjinfo_attacksound:
 		info->attacksound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"painstate"))
+		break;
+	case mobjinfo_painstate:
 		info->painstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"painchance"))
+		break;
+	case mobjinfo_painchance:
 		info->painchance = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"painsound"))
+		break;
+	case mobjinfo_painsound:
 		info->painsound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"meleestate"))
+		break;
+	case mobjinfo_meleestate:
 		info->meleestate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"missilestate"))
+		break;
+	case mobjinfo_missilestate:
 		info->missilestate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"deathstate"))
+		break;
+	case mobjinfo_deathstate:
 		info->deathstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"xdeathstate"))
+		break;
+	case mobjinfo_xdeathstate:
 		info->xdeathstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"deathsound"))
+		break;
+	case mobjinfo_deathsound:
 		info->deathsound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"speed"))
+		break;
+	case mobjinfo_speed:
 		info->speed = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"radius"))
+		break;
+	case mobjinfo_radius:
 		info->radius = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"height"))
+		break;
+	case mobjinfo_height:
 		info->height = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"dispoffset"))
+		break;
+	case mobjinfo_dispoffset:
 		info->dispoffset = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"mass"))
+		break;
+	case mobjinfo_mass:
 		info->mass = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"damage"))
+		break;
+	case mobjinfo_damage:
 		info->damage = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"activesound"))
+		break;
+	case mobjinfo_activesound:
 		info->activesound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flags"))
+		break;
+	case mobjinfo_flags:
 		info->flags = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"raisestate"))
+		break;
+	case mobjinfo_raisestate:
 		info->raisestate = luaL_checkinteger(L, 3);
-	else {
+		break;
+	default:
 		lua_getfield(L, LUA_REGISTRYINDEX, LREG_EXTVARS);
 		I_Assert(lua_istable(L, -1));
 		lua_pushlightuserdata(L, info);
@@ -1233,18 +1408,19 @@ static int mobjinfo_set(lua_State *L)
 		if (lua_isnil(L, -1)) {
 			// This index doesn't have a table for extra values yet, let's make one.
 			lua_pop(L, 1);
-			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; adding it as Lua data.\n"), "mobjinfo_t", field);
+			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; adding it as Lua data.\n"), "mobjinfo_t", lua_tostring(L, 2));
 			lua_newtable(L);
 			lua_pushlightuserdata(L, info);
 			lua_pushvalue(L, -2); // ext value table
 			lua_rawset(L, -4); // LREG_EXTVARS table
 		}
 		lua_pushvalue(L, 3); // value to store
-		lua_setfield(L, -2, field);
+		lua_setfield(L, -2, lua_tostring(L, 2));
 		lua_pop(L, 2);
-	}
+		break;
 	//else
-		//return luaL_error(L, LUA_QL("mobjinfo_t") " has no field named " LUA_QS, field);
+	}
+		//return luaL_error(L, LUA_QL("mobjinfo_t") " has no field named " LUA_QS, lua_tostring(L, 2));
 	return 0;
 }
 
@@ -1303,7 +1479,7 @@ static int lib_setSfxInfo(lua_State *L)
 		if (lua_isnumber(L, 2))
 			i = lua_tointeger(L, 2) - 1; // lua is one based, this enum is zero based.
 		else
-			i = luaL_checkoption(L, 2, NULL, sfxinfo_wopt);
+			i = Lua_checkoption(L, 2, -1, sfxinfo_write_fields_ref);
 
 		switch(i)
 		{
@@ -1338,7 +1514,7 @@ static int lib_sfxlen(lua_State *L)
 static int sfxinfo_get(lua_State *L)
 {
 	sfxinfo_t *sfx = *((sfxinfo_t **)luaL_checkudata(L, 1, META_SFXINFO));
-	enum sfxinfo_read field = luaL_checkoption(L, 2, NULL, sfxinfo_ropt);
+	enum sfxinfo_read field = Lua_checkoption(L, 2, -1, sfxinfo_read_fields_ref);
 
 	I_Assert(sfx != NULL);
 
@@ -1372,7 +1548,7 @@ static int sfxinfo_get(lua_State *L)
 static int sfxinfo_set(lua_State *L)
 {
 	sfxinfo_t *sfx = *((sfxinfo_t **)luaL_checkudata(L, 1, META_SFXINFO));
-	enum sfxinfo_write field = luaL_checkoption(L, 2, NULL, sfxinfo_wopt);
+	enum sfxinfo_write field = Lua_checkoption(L, 2, -1, sfxinfo_write_fields_ref);
 
 	if (hud_running)
 		return luaL_error(L, "Do not alter S_sfx in HUD rendering code!");
@@ -1590,29 +1766,59 @@ static int lib_skincolorslen(lua_State *L)
 	return 1;
 }
 
+enum skincolor_e {
+	skincolor_name = 0,
+	skincolor_ramp,
+	skincolor_invcolor,
+	skincolor_invshade,
+	skincolor_chatcolor,
+	skincolor_accessible
+};
+
+static const char *const skincolor_opt[] = {
+	"name",
+	"ramp",
+	"invcolor",
+	"invshade",
+	"chatcolor",
+	"accessible",
+	NULL};
+
+static int skincolor_fields_ref = LUA_NOREF;
+
 // skincolor_t *, field -> number
 static int skincolor_get(lua_State *L)
 {
 	skincolor_t *info = *((skincolor_t **)luaL_checkudata(L, 1, META_SKINCOLOR));
-	const char *field = luaL_checkstring(L, 2);
+	enum skincolor_e field = Lua_optoption(L, 2, -1, skincolor_fields_ref);
 
 	I_Assert(info != NULL);
 	I_Assert(info >= skincolors);
 
-	if (fastcmp(field,"name"))
+	switch(field)
+	{
+	case skincolor_name:
 		lua_pushstring(L, info->name);
-	else if (fastcmp(field,"ramp"))
+		break;
+	case skincolor_ramp:
 		LUA_PushUserdata(L, info->ramp, META_COLORRAMP);
-	else if (fastcmp(field,"invcolor"))
+		break;
+	case skincolor_invcolor:
 		lua_pushinteger(L, info->invcolor);
-	else if (fastcmp(field,"invshade"))
+		break;
+	case skincolor_invshade:
 		lua_pushinteger(L, info->invshade);
-	else if (fastcmp(field,"chatcolor"))
+		break;
+	case skincolor_chatcolor:
 		lua_pushinteger(L, info->chatcolor);
-	else if (fastcmp(field,"accessible"))
+		break;
+	case skincolor_accessible:
 		lua_pushboolean(L, info->accessible);
-	else
-		CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "skincolor_t", field);
+		break;
+	default:
+		CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "skincolor_t", lua_tostring(L, 2));
+		break;
+	}
 	return 1;
 }
 
@@ -1621,7 +1827,7 @@ static int skincolor_set(lua_State *L)
 {
 	UINT32 i;
 	skincolor_t *info = *((skincolor_t **)luaL_checkudata(L, 1, META_SKINCOLOR));
-	const char *field = luaL_checkstring(L, 2);
+	enum skincolor_e field = Lua_optoption(L, 2, -1, skincolor_fields_ref);
 	UINT16 cnum = (UINT16)(info-skincolors);
 
 	I_Assert(info != NULL);
@@ -1630,7 +1836,10 @@ static int skincolor_set(lua_State *L)
 	if (!cnum || cnum >= numskincolors)
 		return luaL_error(L, "skincolors[] index %d out of range (1 - %d)", cnum, numskincolors-1);
 
-	if (fastcmp(field,"name")) {
+	switch(field)
+	{
+	case skincolor_name:
+	{
 		const char* n = luaL_checkstring(L, 3);
 		strlcpy(info->name, n, MAXCOLORNAME+1);
 		if (strlen(n) > MAXCOLORNAME)
@@ -1646,7 +1855,9 @@ static int skincolor_set(lua_State *L)
 			if (!stricmp(info->name, skincolors[SKINCOLOR_NONE].name) || (dupecheck && (dupecheck != cnum)))
 				CONS_Alert(CONS_WARNING, "skincolor_t field 'name' ('%s') is a duplicate of another skincolor's name.\n", info->name);
 		}
-	} else if (fastcmp(field,"ramp")) {
+		break;
+	}
+	case skincolor_ramp:
 		if (!lua_istable(L, 3) && luaL_checkudata(L, 3, META_COLORRAMP) == NULL)
 			return luaL_error(L, LUA_QL("skincolor_t") " field 'ramp' must be a table or array.");
 		else if (lua_istable(L, 3))
@@ -1655,23 +1866,34 @@ static int skincolor_set(lua_State *L)
 			for (i=0; i<COLORRAMPSIZE; i++)
 				info->ramp[i] = (*((UINT8 **)luaL_checkudata(L, 3, META_COLORRAMP)))[i];
 		skincolor_modified[cnum] = true;
-	} else if (fastcmp(field,"invcolor")) {
+		break;
+	case skincolor_invcolor:
+	{
 		UINT16 v = (UINT16)luaL_checkinteger(L, 3);
 		if (v >= numskincolors)
 			return luaL_error(L, "skincolor_t field 'invcolor' out of range (1 - %d)", numskincolors-1);
 		info->invcolor = v;
-	} else if (fastcmp(field,"invshade"))
+		break;
+	}
+	case skincolor_invshade:
 		info->invshade = (UINT8)luaL_checkinteger(L, 3)%COLORRAMPSIZE;
-	else if (fastcmp(field,"chatcolor"))
+		break;
+	case skincolor_chatcolor:
 		info->chatcolor = (UINT16)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"accessible")) {
+		break;
+	case skincolor_accessible:
+	{
 		boolean v = lua_toboolean(L, 3);
 		if (cnum < FIRSTSUPERCOLOR && v != skincolors[cnum].accessible)
 			return luaL_error(L, "skincolors[] index %d is a standard color; accessibility changes are prohibited.", cnum);
 		else
 			info->accessible = v;
-	} else
-		CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "skincolor_t", field);
+		break;
+	}
+	default:
+		CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "skincolor_t", lua_tostring(L, 2));
+		break;
+	}
 	return 1;
 }
 
@@ -1730,6 +1952,12 @@ static int colorramp_len(lua_State *L)
 //
 int LUA_InfoLib(lua_State *L)
 {
+	sfxinfo_read_fields_ref = Lua_CreateFieldTable(L, sfxinfo_ropt);
+	sfxinfo_write_fields_ref = Lua_CreateFieldTable(L, sfxinfo_wopt);
+	state_fields_ref = Lua_CreateFieldTable(L, state_opt);
+	mobjinfo_fields_ref = Lua_CreateFieldTable(L, mobjinfo_opt);
+	skincolor_fields_ref = Lua_CreateFieldTable(L, skincolor_opt);
+
 	// index of A_Lua actions to run for each state
 	lua_newtable(L);
 	lua_setfield(L, LUA_REGISTRYINDEX, LREG_STATEACTION);
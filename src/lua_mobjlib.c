@@ -161,12 +161,14 @@ static const char *const mobj_opt[] = {
 	"shadowscale",
 	NULL};
 
+static int mobj_fields_ref = LUA_NOREF;
+
 #define UNIMPLEMENTED luaL_error(L, LUA_QL("mobj_t") " field " LUA_QS " is not implemented for Lua and cannot be accessed.", mobj_opt[field])
 
 static int mobj_get(lua_State *L)
 {
 	mobj_t *mo = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
-	enum mobj_e field = Lua_optoption(L, 2, NULL, mobj_opt);
+	enum mobj_e field = Lua_optoption(L, 2, -1, mobj_fields_ref);
 	lua_settop(L, 2);
 
 	if (!mo || !ISINLEVEL) {
@@ -427,7 +429,7 @@ static int mobj_get(lua_State *L)
 static int mobj_set(lua_State *L)
 {
 	mobj_t *mo = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
-	enum mobj_e field = Lua_optoption(L, 2, mobj_opt[0], mobj_opt);
+	enum mobj_e field = Lua_optoption(L, 2, 0, mobj_fields_ref);
 	lua_settop(L, 3);
 
 	INLEVEL
@@ -627,8 +629,7 @@ static int mobj_set(lua_State *L)
 		mobjtype_t newtype = luaL_checkinteger(L, 3);
 		if (newtype >= NUMMOBJTYPES)
 			return luaL_error(L, "mobj.type %d out of range (0 - %d).", newtype, NUMMOBJTYPES-1);
-		mo->type = newtype;
-		mo->info = &mobjinfo[newtype];
+		P_SetMobjType(mo, newtype);
 		P_SetScale(mo, mo->scale);
 		break;
 	}
@@ -761,6 +762,9 @@ static int mobj_set(lua_State *L)
 		lua_pop(L, 2);
 		break;
 	}
+
+	// let the full thinker look at whatever was changed
+	mo->eflags &= ~MFE_PARKED;
 	return 0;
 }
 
@@ -805,14 +809,52 @@ static int thingstringargs_len(lua_State *L)
 	return 1;
 }
 
+enum mapthing_e {
+	mapthing_valid = 0,
+	mapthing_x,
+	mapthing_y,
+	mapthing_angle,
+	mapthing_pitch,
+	mapthing_roll,
+	mapthing_type,
+	mapthing_options,
+	mapthing_scale,
+	mapthing_z,
+	mapthing_extrainfo,
+	mapthing_tag,
+	mapthing_args,
+	mapthing_stringargs,
+	mapthing_mobj
+};
+
+static const char *const mapthing_opt[] = {
+	"valid",
+	"x",
+	"y",
+	"angle",
+	"pitch",
+	"roll",
+	"type",
+	"options",
+	"scale",
+	"z",
+	"extrainfo",
+	"tag",
+	"args",
+	"stringargs",
+	"mobj",
+	NULL};
+
+static int mapthing_fields_ref = LUA_NOREF;
+
 static int mapthing_get(lua_State *L)
 {
 	mapthing_t *mt = *((mapthing_t **)luaL_checkudata(L, 1, META_MAPTHING));
-	const char *field = luaL_checkstring(L, 2);
+	enum mapthing_e field = Lua_optoption(L, 2, -1, mapthing_fields_ref);
 	lua_Integer number;
 
 	if (!mt) {
-		if (fastcmp(field,"valid")) {
+		if (field == mapthing_valid) {
 			lua_pushboolean(L, false);
 			return 1;
 		}
@@ -821,48 +863,58 @@ static int mapthing_get(lua_State *L)
 		return 0;
 	}
 
-	if (fastcmp(field,"valid")) {
+	switch(field)
+	{
+	case mapthing_valid:
 		lua_pushboolean(L, true);
 		return 1;
-	} else if(fastcmp(field,"x"))
+	case mapthing_x:
 		number = mt->x;
-	else if(fastcmp(field,"y"))
+		break;
+	case mapthing_y:
 		number = mt->y;
-	else if(fastcmp(field,"angle"))
+		break;
+	case mapthing_angle:
 		number = mt->angle;
-	else if(fastcmp(field,"pitch"))
+		break;
+	case mapthing_pitch:
 		number = mt->pitch;
-	else if(fastcmp(field,"roll"))
+		break;
+	case mapthing_roll:
 		number = mt->roll;
-	else if(fastcmp(field,"type"))
+		break;
+	case mapthing_type:
 		number = mt->type;
-	else if(fastcmp(field,"options"))
+		break;
+	case mapthing_options:
 		number = mt->options;
-	else if(fastcmp(field,"scale"))
+		break;
+	case mapthing_scale:
 		number = mt->scale;
-	else if(fastcmp(field,"z"))
+		break;
+	case mapthing_z:
 		number = mt->z;
-	else if(fastcmp(field,"extrainfo"))
+		break;
+	case mapthing_extrainfo:
 		number = mt->extrainfo;
-	else if(fastcmp(field,"tag"))
+		break;
+	case mapthing_tag:
 		number = mt->tag;
-	else if(fastcmp(field,"args"))
-	{
+		break;
+	case mapthing_args:
 		LUA_PushUserdata(L, mt->args, META_THINGARGS);
 		return 1;
-	}
-	else if(fastcmp(field,"stringargs"))
-	{
+	case mapthing_stringargs:
 		LUA_PushUserdata(L, mt->stringargs, META_THINGSTRINGARGS);
 		return 1;
-	}
-	else if(fastcmp(field,"mobj")) {
+	case mapthing_mobj:
 		LUA_PushUserdata(L, mt->mobj, META_MOBJ);
 		return 1;
-	} else if (devparm)
-		return luaL_error(L, LUA_QL("mapthing_t") " has no field named " LUA_QS, field);
-	else
+	default:
+		if (devparm)
+			return luaL_error(L, LUA_QL("mapthing_t") " has no field named " LUA_QS, lua_tostring(L, 2));
 		return 0;
+	}
 
 	lua_pushinteger(L, number);
 	return 1;
@@ -871,7 +923,7 @@ static int mapthing_get(lua_State *L)
 static int mapthing_set(lua_State *L)
 {
 	mapthing_t *mt = *((mapthing_t **)luaL_checkudata(L, 1, META_MAPTHING));
-	const char *field = luaL_checkstring(L, 2);
+	enum mapthing_e field = Lua_optoption(L, 2, -1, mapthing_fields_ref);
 
 	if (!mt)
 		return luaL_error(L, "accessed mapthing_t doesn't exist anymore.");
@@ -879,37 +931,52 @@ static int mapthing_set(lua_State *L)
 	if (hud_running)
 		return luaL_error(L, "Do not alter mapthing_t in HUD rendering code!");
 
-	if(fastcmp(field,"x"))
+	switch(field)
+	{
+	case mapthing_x:
 		mt->x = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"y"))
+		break;
+	case mapthing_y:
 		mt->y = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"angle"))
+		break;
+	case mapthing_angle:
 		mt->angle = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"pitch"))
+		break;
+	case mapthing_pitch:
 		mt->pitch = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"roll"))
+		break;
+	case mapthing_roll:
 		mt->roll = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"type"))
+		break;
+	case mapthing_type:
 		mt->type = (UINT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"options"))
+		break;
+	case mapthing_options:
 		mt->options = (UINT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"scale"))
+		break;
+	case mapthing_scale:
 		mt->scale = luaL_checkfixed(L, 3);
-	else if(fastcmp(field,"z"))
+		break;
+	case mapthing_z:
 		mt->z = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"extrainfo"))
+		break;
+	case mapthing_extrainfo:
 	{
 		INT32 extrainfo = luaL_checkinteger(L, 3);
 		if (extrainfo & ~15)
 			return luaL_error(L, "mapthing_t extrainfo set %d out of range (%d - %d)", extrainfo, 0, 15);
 		mt->extrainfo = (UINT8)extrainfo;
+		break;
 	}
-	else if (fastcmp(field,"tag"))
+	case mapthing_tag:
 		mt->tag = (INT16)luaL_checkinteger(L, 3);
-	else if(fastcmp(field,"mobj"))
+		break;
+	case mapthing_mobj:
 		mt->mobj = *((mobj_t **)luaL_checkudata(L, 3, META_MOBJ));
-	else
-		return luaL_error(L, LUA_QL("mapthing_t") " has no field named " LUA_QS, field);
+		break;
+	default:
+		return luaL_error(L, LUA_QL("mapthing_t") " has no field named " LUA_QS, lua_tostring(L, 2));
+	}
 
 	return 0;
 }
@@ -973,6 +1040,9 @@ static int lib_nummapthings(lua_State *L)
 
 int LUA_MobjLib(lua_State *L)
 {
+	mobj_fields_ref = Lua_CreateFieldTable(L, mobj_opt);
+	mapthing_fields_ref = Lua_CreateFieldTable(L, mapthing_opt);
+
 	luaL_newmetatable(L, META_MOBJ);
 		lua_pushcfunction(L, mobj_get);
 		lua_setfield(L, -2, "__index");
@@ -400,6 +400,10 @@ static int setglobals(lua_State *L)
 		lua_rawset(L, -3); // rawset doesn't trigger this metatable again.
 		// otherwise we would've used setfield, obviously.
 
+		// parked collectibles skip A_AttractChase
+		if (ISINLEVEL)
+			P_WakeParkedCollectibles();
+
 		Z_Free(name);
 		return 0;
 	}
@@ -465,6 +469,12 @@ void LUA_ClearExtVars(void)
 }
 #endif
 
+// Whether any Lua has been loaded, see P_QueueParkedCollectible
+boolean LUA_IsLoaded(void)
+{
+	return gL != NULL;
+}
+
 // Use this variable to prevent certain functions from running
 // if they were not called on lump load
 // (i.e. they were called in hooks or coroutines etc)
@@ -479,7 +489,12 @@ static inline void LUA_LoadFile(MYFILE *f, char *name, boolean noresults)
 		name = wadfiles[f->wad]->filename;
 	CONS_Printf("Loading Lua script from %s\n", name);
 	if (!gL) // Lua needs to be initialized
+	{
 		LUA_ClearState();
+
+		// Scripts can get at any mobj, so none can be stored from now on
+		P_PromoteAllCollectibles();
+	}
 	lua_pushinteger(gL, f->wad);
 	lua_setfield(gL, LUA_REGISTRYINDEX, "WAD");
 
@@ -888,6 +903,7 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 {
 	if (myindex < 0)
 		myindex = lua_gettop(gL)+1+myindex;
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
 	switch (lua_type(gL, myindex))
 	{
 	case LUA_TNONE:
@@ -935,6 +951,7 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		// fixing the awful crashes previously encountered for reading strings longer than 1024
 		// (yes I know that's kind of a stupid thing to care about, but it'd be evil to trim or ignore them?)
 		// -- Monster Iestyn 05/08/18
+		P_SaveBufferReserve(SAVEBLOCKSIZE + len);
 		if (len < 255)
 		{
 			WRITEUINT8(save_p, ARCH_SMALLSTRING);
@@ -1205,6 +1222,7 @@ static void ArchiveExtVars(void *pointer, const char *ptype)
 		return;
 	}
 
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
 	if (fastcmp(ptype,"mobj")) // mobjs must write their mobjnum as a header
 		WRITEUINT32(save_p, ((mobj_t *)pointer)->mobjnum);
 	WRITEUINT16(save_p, i);
@@ -1212,6 +1230,7 @@ static void ArchiveExtVars(void *pointer, const char *ptype)
 	while (lua_next(gL, -2))
 	{
 		I_Assert(lua_type(gL, -2) == LUA_TSTRING);
+		P_SaveBufferReserve(SAVEBLOCKSIZE + lua_objlen(gL, -2));
 		WRITESTRING(save_p, lua_tostring(gL, -2));
 		if (ArchiveValue(TABLESINDEX, -1) == 2)
 			CONS_Alert(CONS_ERROR, "Type of value for %s entry '%s' (%s) could not be archived!\n", ptype, lua_tostring(gL, -2), luaL_typename(gL, -1));
@@ -1513,7 +1532,7 @@ void LUA_UnArchive(void)
 {
 	UINT32 mobjnum;
 	INT32 i;
-	thinker_t *th;
+	mobj_t *mobj;
 
 	if (gL)
 		lua_newtable(gL); // tables to be read
@@ -1525,17 +1544,15 @@ void LUA_UnArchive(void)
 		UnArchiveExtVars(&players[i]);
 	}
 
-	do {
+	for (;;)
+	{
 		mobjnum = READUINT32(save_p); // read a mobjnum
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
-		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-			if (((mobj_t *)th)->mobjnum != mobjnum) // find matching mobj
-				continue;
-			UnArchiveExtVars(th); // apply variables
-		}
-	} while(mobjnum != UINT32_MAX); // repeat until end of mobjs marker.
+		if (mobjnum == UINT32_MAX) // end of mobjs marker
+			break;
+		mobj = P_FindNewPosition(mobjnum); // find matching mobj
+		if (mobj)
+			UnArchiveExtVars(mobj); // apply variables
+	}
 
 	LUAh_NetArchiveHook(NetUnArchive); // call the NetArchive hook in unarchive mode
 	UnArchiveTables();
@@ -1544,14 +1561,53 @@ void LUA_UnArchive(void)
 		lua_pop(gL, 1); // pop tables
 }
 
-// For mobj_t, player_t, etc. to take custom variables.
-int Lua_optoption(lua_State *L, int narg,
-	const char *def, const char *const lst[])
+// Makes a table mapping every name in lst to its index and keeps it in the
+// registry, for Lua_optoption and Lua_checkoption. Lua strings are interned,
+// so looking a field up in it is a single hash lookup instead of a string
+// compare against every name in the list.
+int Lua_CreateFieldTable(lua_State *L, const char *const lst[])
 {
-	const char *name = (def) ? luaL_optstring(L, narg, def) :  luaL_checkstring(L, narg);
 	int i;
-	for (i=0; lst[i]; i++)
-		if (fastcmp(lst[i], name))
-			return i;
-	return -1;
+	lua_newtable(L);
+	for (i = 0; lst[i]; i++)
+	{
+		lua_pushstring(L, lst[i]);
+		lua_pushinteger(L, i);
+		lua_rawset(L, -3);
+	}
+	return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+// For mobj_t, player_t, etc. to take custom variables.
+// Returns the index of the field named at narg in a table made by
+// Lua_CreateFieldTable, or -1 if there's no such field.
+// def is returned if the argument is absent, unless it is -1.
+int Lua_optoption(lua_State *L, int narg, int def, int fields)
+{
+	int i = -1;
+
+	if (def != -1 && lua_isnoneornil(L, narg))
+		return def;
+
+	luaL_checkstring(L, narg);
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, fields);
+	I_Assert(lua_istable(L, -1));
+	lua_pushvalue(L, narg);
+	lua_rawget(L, -2);
+	if (lua_isnumber(L, -1))
+		i = lua_tointeger(L, -1);
+	lua_pop(L, 2);
+	return i;
+}
+
+// Same as Lua_optoption, but errors out on an unknown field like
+// luaL_checkoption does.
+int Lua_checkoption(lua_State *L, int narg, int def, int fields)
+{
+	int i = Lua_optoption(L, narg, def, fields);
+	if (i == -1)
+		return luaL_argerror(L, narg,
+			lua_pushfstring(L, "invalid option " LUA_QS, lua_tostring(L, narg)));
+	return i;
 }
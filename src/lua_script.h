@@ -41,6 +41,7 @@ extern INT32 lua_lumploading; // is LUA_LoadLump being called?
 
 int LUA_GetErrorMessage(lua_State *L);
 void LUA_LoadLump(UINT16 wad, UINT16 lump, boolean noresults);
+boolean LUA_IsLoaded(void);
 #ifdef LUA_ALLOW_BYTECODE
 void LUA_DumpFile(const char *filename);
 #endif
@@ -58,10 +59,17 @@ int LUA_PushGlobals(lua_State *L, const char *word);
 int LUA_CheckGlobals(lua_State *L, const char *word);
 void Got_Luacmd(UINT8 **cp, INT32 playernum); // lua_consolelib.c
 void LUA_CVarChanged(const char *name); // lua_consolelib.c
-int Lua_optoption(lua_State *L, int narg,
-	const char *def, const char *const lst[]);
+int Lua_CreateFieldTable(lua_State *L, const char *const lst[]);
+int Lua_optoption(lua_State *L, int narg, int def, int fields);
+int Lua_checkoption(lua_State *L, int narg, int def, int fields);
 void LUAh_NetArchiveHook(lua_CFunction archFunc);
 
+// Hook profiling, lua_hooklib.c
+typedef struct hookprof_s hookprof_t;
+hookprof_t *LUA_NewHookProfile(lua_State *L, int idx, const char *kind);
+precise_t LUA_HookProfileStart(void);
+void LUA_HookProfileEnd(hookprof_t *prof, precise_t start);
+
 // Console wrapper
 void COM_Lua_f(void);
 
@@ -561,21 +561,12 @@ void Command_Teleport_f(void)
 		else // scan the thinkers to find starposts...
 		{
 			mobj_t *mo2 = NULL;
-			thinker_t *th;
 
 			INT32 starpostmax = 0;
 			intz = starpostpath; // variable reuse - counting down for selection purposes
 
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType(MT_STARPOST); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				mo2 = (mobj_t *)th;
-
-				if (mo2->type != MT_STARPOST)
-					continue;
-
 				if (mo2->health != starpostnum)
 				{
 					if (mo2->health > starpostmax)
@@ -589,7 +580,7 @@ void Command_Teleport_f(void)
 				break;
 			}
 
-			if (th == &thlist[THINK_MOBJ])
+			if (!mo2)
 			{
 				if (intz == starpostpath)
 					CONS_Alert(CONS_NOTICE, M_GetText("No starpost of position %d found (%d max).\n"), starpostnum, starpostmax);
@@ -1452,6 +1443,7 @@ void Command_ObjectPlace_f(void)
 		if (!objectplacing)
 		{
 			objectplacing = true;
+			P_PromoteAllCollectibles(); // objectplace works on mapthings' mobjs
 
 			if (players[0].powers[pw_carry] == CR_NIGHTSMODE)
 				return;
@@ -10877,10 +10877,18 @@ static void M_HandleServerPage(INT32 choice)
 
 static void M_Connect(INT32 choice)
 {
+	SINT8 node = SL_MakeServerNode(choice-FIRSTSERVERLINE + serverlistpage * SERVERS_PER_PAGE);
+
+	if (node < 0)
+	{
+		M_StartMessage(M_GetText("There are no free nodes\nto contact this server with.\n\nPress ESC\n"), NULL, MM_NOTHING);
+		return;
+	}
+
 	// do not call menuexitfunc
 	M_ClearMenus(false);
 
-	COM_BufAddText(va("connect node %d\n", serverlist[choice-FIRSTSERVERLINE + serverlistpage * SERVERS_PER_PAGE].node));
+	COM_BufAddText(va("connect node %d\n", node));
 }
 
 static void M_Refresh(INT32 choice)
@@ -11102,30 +11110,36 @@ static int ServerListEntryComparator_modified(const void *entry1, const void *en
 }
 #endif
 
-void M_SortServerList(void)
+int M_ServerListCompare(const void *entry1, const void *entry2)
 {
 #ifndef NONET
 	switch(cv_serversort.value)
 	{
 	case 0:		// Ping.
-		qsort(serverlist, serverlistcount, sizeof(serverelem_t), ServerListEntryComparator_time);
-		break;
+		return ServerListEntryComparator_time(entry1, entry2);
 	case 1:		// Modified state.
-		qsort(serverlist, serverlistcount, sizeof(serverelem_t), ServerListEntryComparator_modified);
-		break;
+		return ServerListEntryComparator_modified(entry1, entry2);
 	case 2:		// Most players.
-		qsort(serverlist, serverlistcount, sizeof(serverelem_t), ServerListEntryComparator_numberofplayer_reverse);
-		break;
+		return ServerListEntryComparator_numberofplayer_reverse(entry1, entry2);
 	case 3:		// Least players.
-		qsort(serverlist, serverlistcount, sizeof(serverelem_t), ServerListEntryComparator_numberofplayer);
-		break;
+		return ServerListEntryComparator_numberofplayer(entry1, entry2);
 	case 4:		// Max players.
-		qsort(serverlist, serverlistcount, sizeof(serverelem_t), ServerListEntryComparator_maxplayer_reverse);
-		break;
+		return ServerListEntryComparator_maxplayer_reverse(entry1, entry2);
 	case 5:		// Gametype.
-		qsort(serverlist, serverlistcount, sizeof(serverelem_t), ServerListEntryComparator_gametypename);
-		break;
+		return ServerListEntryComparator_gametypename(entry1, entry2);
 	}
+#else
+	(void)entry1;
+	(void)entry2;
+#endif
+	return 0;
+}
+
+void M_SortServerList(void)
+{
+#ifndef NONET
+	// Servers are kept in order as they reply, this is for when the order changes
+	qsort(serverlist, serverlistcount, sizeof(serverelem_t), M_ServerListCompare);
 #endif
 }
 
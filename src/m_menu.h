@@ -213,6 +213,9 @@ void M_EndModeAttackRun(void);
 // Called on new server add, or other reasons
 void M_SortServerList(void);
 
+// Orders two serverelem_t the way cv_serversort asks for
+int M_ServerListCompare(const void *entry1, const void *entry2);
+
 // Draws a box with a texture inside as background for messages
 void M_DrawTextBox(INT32 x, INT32 y, INT32 width, INT32 boxlines);
 
@@ -115,22 +115,17 @@ static void WarnGUI (void)
 #endif
 }
 
-#define NUM_LIST_SERVER MAXSERVERLIST
 msg_server_t *GetShortServersList(INT32 room, int id)
 {
 	msg_server_t *server_list;
 
-	// +1 for easy test
-	server_list = malloc(( NUM_LIST_SERVER + 1 ) * sizeof *server_list);
+	// Sized to fit, terminated by an empty entry
+	server_list = HMS_fetch_servers(room, id);
 
-	if (HMS_fetch_servers(server_list, room, id))
-		return server_list;
-	else
-	{
-		free(server_list);
+	if (!server_list)
 		WarnGUI();
-		return NULL;
-	}
+
+	return server_list;
 }
 
 INT32 GetRoomsList(boolean hosting, int id)
@@ -105,7 +105,7 @@ int  HMS_register (void);
 int  HMS_unlist (void);
 int  HMS_update (void);
 void HMS_list_servers (void);
-msg_server_t * HMS_fetch_servers (msg_server_t *list, int room, int id);
+msg_server_t * HMS_fetch_servers (int room, int id);
 int  HMS_compare_mod_version (char *buffer, size_t size_of_buffer);
 
 #endif
@@ -404,7 +404,7 @@ INT32 EV_DoCeiling(line_t *line, ceiling_e type)
 
 		// new door thinker
 		rtn = 1;
-		ceiling = Z_Calloc(sizeof (*ceiling), PU_LEVSPEC, NULL);
+		ceiling = P_AllocThinker(sizeof (*ceiling));
 		P_AddThinker(THINK_MAIN, &ceiling->thinker);
 		sec->ceilingdata = ceiling;
 		ceiling->thinker.function.acp1 = (actionf_p1)T_MoveCeiling;
@@ -624,7 +624,7 @@ INT32 EV_DoCrush(line_t *line, ceiling_e type)
 
 		// new door thinker
 		rtn = 1;
-		ceiling = Z_Calloc(sizeof (*ceiling), PU_LEVSPEC, NULL);
+		ceiling = P_AllocThinker(sizeof (*ceiling));
 		P_AddThinker(THINK_MAIN, &ceiling->thinker);
 		sec->ceilingdata = ceiling;
 		ceiling->thinker.function.acp1 = (actionf_p1)T_CrushCeiling;
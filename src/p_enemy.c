@@ -785,7 +785,7 @@ boolean P_LookForPlayers(mobj_t *actor, boolean allaround, boolean tracer, fixed
   * \return True if a player with ring shield is found, otherwise false.
   * \sa A_AttractChase
   */
-static boolean P_LookForShield(mobj_t *actor)
+boolean P_LookForShield(mobj_t *actor)
 {
 	INT32 c = 0, stop;
 	player_t *player;
@@ -4120,16 +4120,8 @@ bossjustdie:
 
 			// Flee! Flee! Find a point to escape to! If none, just shoot upward!
 			// scan the thinkers to find the runaway point
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType(MT_BOSSFLYPOINT); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				mo2 = (mobj_t *)th;
-
-				if (mo2->type != MT_BOSSFLYPOINT)
-					continue;
-
 				if (mo2->spawnpoint && mo2->spawnpoint->extrainfo != extrainfo)
 					continue;
 
@@ -6449,7 +6441,8 @@ void A_CrawlaCommanderThink(mobj_t *actor)
 void A_RingExplode(mobj_t *actor)
 {
 	mobj_t *mo2;
-	thinker_t *th;
+	thinglist_t hit = {NULL, 0, 0};
+	size_t i;
 	angle_t d;
 
 	if (LUA_CallAction("A_RingExplode", actor))
@@ -6460,12 +6453,14 @@ void A_RingExplode(mobj_t *actor)
 
 	S_StartSound(actor, sfx_prloop);
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	P_QueryThingsInRadius(&hit, actor->x, actor->y, FixedMul(actor->info->painchance, actor->scale), 0, MT_NULL, 0);
+
+	for (i = 0; i < hit.numresults; i++)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
+		mo2 = hit.results[i].mobj;
 
-		mo2 = (mobj_t *)th;
+		if (P_MobjWasRemoved(mo2))
+			continue;
 
 		if (mo2 == actor) // Don't explode yourself! Endless loop!
 			continue;
@@ -6480,7 +6475,8 @@ void A_RingExplode(mobj_t *actor)
 			continue;
 		}
 	}
-	return;
+
+	P_ClearThingList(&hit);
 }
 
 // Function: A_OldRingExplode
@@ -8114,7 +8110,6 @@ void A_Boss3Path(mobj_t *actor)
 
 		if (!(actor->flags2 & MF2_STRONGBOX))
 		{
-			thinker_t *th;
 			mobj_t *mo2;
 
 			P_SetTarget(&actor->target, NULL);
@@ -8122,14 +8117,8 @@ void A_Boss3Path(mobj_t *actor)
 			// scan the thinkers
 			// to find a point that matches
 			// the number
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType(MT_BOSS3WAYPOINT); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				mo2 = (mobj_t *)th;
-				if (mo2->type != MT_BOSS3WAYPOINT)
-					continue;
 				if (!mo2->spawnpoint)
 					continue;
 				if (mo2->spawnpoint->angle != actor->threshold)
@@ -8622,7 +8611,6 @@ void A_FindTarget(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist1 = 0, dist2 = 0;
 
@@ -8632,33 +8620,25 @@ void A_FindTarget(mobj_t *actor)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTarget called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType((mobjtype_t)locvar1); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -8686,7 +8666,6 @@ void A_FindTracer(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist1 = 0, dist2 = 0;
 
@@ -8696,33 +8675,25 @@ void A_FindTracer(mobj_t *actor)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTracer called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType((mobjtype_t)locvar1); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -9293,34 +9264,25 @@ void A_RemoteAction(mobj_t *actor)
 	{
 		///* DO A_FINDTARGET STUFF *///
 		mobj_t *targetedmobj = NULL;
-		thinker_t *th;
 		mobj_t *mo2;
 		fixed_t dist1 = 0, dist2 = 0;
 
 		// scan the thinkers
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType((mobjtype_t)locvar1); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == (mobjtype_t)locvar1)
+			if (targetedmobj == NULL)
 			{
-				if (targetedmobj == NULL)
+				targetedmobj = mo2;
+				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+			}
+			else
+			{
+				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+				if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
 				{
 					targetedmobj = mo2;
-					dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-				}
-				else
-				{
-					dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-					if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
-					{
-						targetedmobj = mo2;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -9550,33 +9512,26 @@ void A_SetObjectTypeState(mobj_t *actor)
 	const UINT16 loc2lw = (UINT16)(locvar2 & 65535);
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 
 	if (LUA_CallAction("A_SetObjectTypeState", actor))
 		return;
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType((mobjtype_t)loc2lw); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+		if (P_MobjWasRemoved(mo2))
 			continue;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)loc2lw)
+		if (mo2->health > 0)
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (mo2->health > 0)
+			if (loc2up == 0)
+				P_SetMobjState(mo2, locvar1);
+			else
 			{
-				if (loc2up == 0)
+				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 					P_SetMobjState(mo2, locvar1);
-				else
-				{
-					if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-						P_SetMobjState(mo2, locvar1);
-				}
 			}
 		}
 	}
@@ -10174,31 +10129,22 @@ void A_CheckThingCount(mobj_t *actor)
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
 	INT32 count = 0;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 
 	if (LUA_CallAction("A_CheckThingCount", actor))
 		return;
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType((mobjtype_t)loc1up); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		if (mo2->type == (mobjtype_t)loc1up)
+		if (loc2up == 0)
+			count++;
+		else
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (loc2up == 0)
+			if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 				count++;
-			else
-			{
-				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-					count++;
-			}
 		}
 	}
 
@@ -12640,21 +12586,12 @@ void A_Boss5FindWaypoint(mobj_t *actor)
 
 	if (locvar1 == 2) // look for the boss waypoint
 	{
-		thinker_t *th;
 		mobj_t *mo2;
 		P_SetTarget(&actor->tracer, NULL);
 		// Flee! Flee! Find a point to escape to! If none, just shoot upward!
 		// scan the thinkers to find the runaway point
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType(MT_BOSSFLYPOINT); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_BOSSFLYPOINT)
-				continue;
-
 			if (mo2->spawnpoint && mo2->spawnpoint->extrainfo != extrainfo)
 				continue;
 
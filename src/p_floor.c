@@ -1084,7 +1084,7 @@ static mobj_t *SearchMarioNode(msecnode_t *node)
 void T_MarioBlockChecker(mariocheck_t *block)
 {
 	line_t *masterline = block->sourceline;
-	if (SearchMarioNode(block->sector->touching_thinglist))
+	if (SearchMarioNode(block->sector->touching_thinglist) || block->sector->collectiblelist)
 	{
 		sides[masterline->sidenum[0]].midtexture = sides[masterline->sidenum[0]].bottomtexture; // Update textures
 		if (masterline->backsector)
@@ -1819,7 +1819,7 @@ void EV_DoFloor(line_t *line, floor_e floortype)
 			continue; // then don't add another one
 
 		// new floor thinker
-		dofloor = Z_Calloc(sizeof (*dofloor), PU_LEVSPEC, NULL);
+		dofloor = P_AllocThinker(sizeof (*dofloor));
 		P_AddThinker(THINK_MAIN, &dofloor->thinker);
 
 		// make sure another floor thinker won't get started over this one
@@ -2036,7 +2036,7 @@ void EV_DoElevator(line_t *line, elevator_e elevtype, boolean customspeed)
 			continue;
 
 		// create and initialize new elevator thinker
-		elevator = Z_Calloc(sizeof (*elevator), PU_LEVSPEC, NULL);
+		elevator = P_AllocThinker(sizeof (*elevator));
 		P_AddThinker(THINK_MAIN, &elevator->thinker);
 		sec->floordata = elevator;
 		sec->ceilingdata = elevator;
@@ -2277,7 +2277,7 @@ void EV_BounceSector(sector_t *sec, fixed_t momz, line_t *sourceline)
 	if (sec->ceilingdata) // One at a time, ma'am.
 		return;
 
-	bouncer = Z_Calloc(sizeof (*bouncer), PU_LEVSPEC, NULL);
+	bouncer = P_AllocThinker(sizeof (*bouncer));
 	P_AddThinker(THINK_MAIN, &bouncer->thinker);
 	sec->ceilingdata = bouncer;
 	bouncer->thinker.function.acp1 = (actionf_p1)T_BounceCheese;
@@ -2300,7 +2300,7 @@ void EV_DoContinuousFall(sector_t *sec, sector_t *backsector, fixed_t spd, boole
 		backsector = sec;
 
 	// create and initialize new thinker
-	faller = Z_Calloc(sizeof (*faller), PU_LEVSPEC, NULL);
+	faller = P_AllocThinker(sizeof (*faller));
 	P_AddThinker(THINK_MAIN, &faller->thinker);
 	faller->thinker.function.acp1 = (actionf_p1)T_ContinuousFalling;
 
@@ -2331,7 +2331,7 @@ INT32 EV_StartCrumble(sector_t *sec, ffloor_t *rover, boolean floating,
 		return 0;
 
 	// create and initialize new crumble thinker
-	crumble = Z_Calloc(sizeof (*crumble), PU_LEVSPEC, NULL);
+	crumble = P_AllocThinker(sizeof (*crumble));
 	P_AddThinker(THINK_MAIN, &crumble->thinker);
 	crumble->thinker.function.acp1 = (actionf_p1)T_StartCrumble;
 
@@ -2392,6 +2392,7 @@ void EV_MarioBlock(ffloor_t *rover, sector_t *sector, mobj_t *puncher)
 		rover->flags |= (FF_SOLID|FF_RENDERALL|FF_CUTLEVEL);
 
 	// Find an item to pop out!
+	P_PromoteSectorCollectibles(roversec);
 	thing = SearchMarioNode(roversec->touching_thinglist);
 
 	if (!thing)
@@ -2401,7 +2402,7 @@ void EV_MarioBlock(ffloor_t *rover, sector_t *sector, mobj_t *puncher)
 		const boolean itsamonitor = (thing->flags & MF_MONITOR) == MF_MONITOR;
 		// create and initialize new elevator thinker
 
-		block = Z_Calloc(sizeof (*block), PU_LEVSPEC, NULL);
+		block = P_AllocThinker(sizeof (*block));
 		P_AddThinker(THINK_MAIN, &block->thinker);
 		roversec->floordata = block;
 		roversec->ceilingdata = block;
@@ -94,20 +94,13 @@ void P_RampConstant(const BasicFF_t *FFInfo, INT32 Start, INT32 End)
   */
 void P_ClearStarPost(INT32 postnum)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
 	// scan the thinkers
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_STARPOST); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+		if (P_MobjWasRemoved(mo2))
 			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_STARPOST)
-			continue;
-
 		if (mo2->health > postnum)
 			continue;
 
@@ -124,19 +117,12 @@ void P_ClearStarPost(INT32 postnum)
 void P_ResetStarposts(void)
 {
 	// Search through all the thinkers.
-	thinker_t *th;
 	mobj_t *post;
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (post = P_FirstMobjOfType(MT_STARPOST); post; post = post->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		post = (mobj_t *)th;
-
-		if (post->type != MT_STARPOST)
+		if (P_MobjWasRemoved(post))
 			continue;
-
 		P_SetMobjState(post, post->info->spawnstate);
 	}
 }
@@ -872,21 +858,12 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 						mobj_t *orbittarget = special->target ? special->target : special;
 						mobj_t *hnext = orbittarget->hnext, *anchorpoint = NULL, *anchorpoint2 = NULL;
 						mobj_t *mo2;
-						thinker_t *th;
 
 						// The player might have two Ideyas: toucher->tracer and toucher->tracer->hnext
 						// so handle their anchorpoints accordingly.
 						// scan the thinkers to find the corresponding anchorpoint
-						for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+						for (mo2 = P_FirstMobjOfType(MT_IDEYAANCHOR); mo2; mo2 = mo2->typenext)
 						{
-							if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-								continue;
-
-							mo2 = (mobj_t *)th;
-
-							if (mo2->type != MT_IDEYAANCHOR)
-								continue;
-
 							if (mo2->health == toucher->tracer->health) // do ideya numberes match?
 								anchorpoint = mo2;
 							else if (toucher->tracer->hnext && mo2->health == toucher->tracer->hnext->health)
@@ -1021,6 +998,7 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 
 				// Now we RE-scan all the thinkers to find close objects to pull
 				// in from the paraloop. Isn't this just so efficient?
+				P_PromoteCollectiblesInRange(x, y, gatherradius);
 				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 				{
 					if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
@@ -1382,7 +1360,6 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 		case MT_AXE:
 			{
 				line_t junk;
-				thinker_t  *th;
 				mobj_t *mo2;
 
 				if (player->bot)
@@ -1392,16 +1369,8 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher, boolean heightcheck)
 				EV_DoElevator(&junk, bridgeFall, false);
 
 				// scan the remaining thinkers to find koopa
-				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+				for (mo2 = P_FirstMobjOfType(MT_KOOPA); mo2; mo2 = mo2->typenext)
 				{
-					if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-						continue;
-
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type != MT_KOOPA)
-						continue;
-
 					mo2->momz = 5*FRACUNIT;
 					break;
 				}
@@ -1883,17 +1852,11 @@ void P_TouchStarPost(mobj_t *post, player_t *player, boolean snaptopost)
 	// Find all starposts in the level with this value - INCLUDING this one!
 	if (!(netgame && circuitmap && player != &players[consoleplayer]))
 	{
-		thinker_t *th;
 		mobj_t *mo2;
 
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType(MT_STARPOST); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_STARPOST)
+			if (P_MobjWasRemoved(mo2))
 				continue;
 			if (mo2->health != post->health)
 				continue;
@@ -2724,17 +2687,12 @@ void P_KillMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8 damaget
 		case MT_EGGMOBILE3:
 			{
 				mobj_t *mo2;
-				thinker_t *th;
 				UINT32 i = 0; // to check how many clones we've removed
 
 				// scan the thinkers to make sure all the old pinch dummies are gone on death
-				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+				for (mo = P_FirstMobjOfType((mobjtype_t)target->info->mass); mo; mo = mo->typenext)
 				{
-					if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-						continue;
-
-					mo = (mobj_t *)th;
-					if (mo->type != (mobjtype_t)target->info->mass)
+					if (P_MobjWasRemoved(mo))
 						continue;
 					if (mo->tracer != target)
 						continue;
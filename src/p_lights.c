@@ -74,7 +74,7 @@ fireflicker_t *P_SpawnAdjustableFireFlicker(sector_t *minsector, sector_t *maxse
 	fireflicker_t *flick;
 
 	P_RemoveLighting(maxsector); // out with the old, in with the new
-	flick = Z_Calloc(sizeof (*flick), PU_LEVSPEC, NULL);
+	flick = P_AllocThinker(sizeof (*flick));
 
 	P_AddThinker(THINK_MAIN, &flick->thinker);
 
@@ -153,7 +153,7 @@ void P_SpawnLightningFlash(sector_t *sector)
 
 	sector->lightingdata = NULL;
 
-	flash = Z_Calloc(sizeof (*flash), PU_LEVSPEC, NULL);
+	flash = P_AllocThinker(sizeof (*flash));
 
 	P_AddThinker(THINK_MAIN, &flash->thinker);
 
@@ -212,7 +212,7 @@ strobe_t *P_SpawnAdjustableStrobeFlash(sector_t *minsector, sector_t *maxsector,
 	strobe_t *flash;
 
 	P_RemoveLighting(maxsector); // out with the old, in with the new
-	flash = Z_Calloc(sizeof (*flash), PU_LEVSPEC, NULL);
+	flash = P_AllocThinker(sizeof (*flash));
 
 	P_AddThinker(THINK_MAIN, &flash->thinker);
 
@@ -287,7 +287,7 @@ glow_t *P_SpawnAdjustableGlowingLight(sector_t *minsector, sector_t *maxsector,
 	glow_t *g;
 
 	P_RemoveLighting(maxsector); // out with the old, in with the new
-	g = Z_Calloc(sizeof (*g), PU_LEVSPEC, NULL);
+	g = P_AllocThinker(sizeof (*g));
 
 	P_AddThinker(THINK_MAIN, &g->thinker);
 
@@ -345,7 +345,7 @@ void P_FadeLightBySector(sector_t *sector, INT32 destvalue, INT32 speed, boolean
 		return;
 	}
 
-	ll = Z_Calloc(sizeof (*ll), PU_LEVSPEC, NULL);
+	ll = P_AllocThinker(sizeof (*ll));
 	ll->thinker.function.acp1 = (actionf_p1)T_LightFade;
 	sector->lightingdata = ll; // set it to the lightlevel_t
 
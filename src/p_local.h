@@ -20,6 +20,7 @@
 #include "m_fixed.h"
 #include "m_bbox.h"
 #include "p_tick.h"
+#include "z_zone.h"
 #include "r_defs.h"
 #include "p_maputl.h"
 
@@ -72,7 +73,12 @@ typedef enum
 } thinklistnum_t; /**< Thinker lists. */
 extern thinker_t thlist[];
 
+extern zpool_t *mobjpool;
+extern zpool_t *precipmobjpool;
+extern zpool_t *collectiblepool;
+
 void P_InitThinkers(void);
+void *P_AllocThinker(size_t size);
 void P_AddThinker(const thinklistnum_t n, thinker_t *thinker);
 void P_RemoveThinker(thinker_t *thinker);
 
@@ -285,7 +291,27 @@ void P_PrecipitationEffects(void);
 
 void P_RemoveMobj(mobj_t *th);
 boolean P_MobjWasRemoved(mobj_t *th);
+
+void P_ClearMobjTypeLists(void);
+void P_LinkMobjType(mobj_t *mobj);
+void P_UnlinkMobjType(mobj_t *mobj);
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type);
+mobj_t *P_FirstMobjOfType(mobjtype_t type);
+size_t P_CountMobjsOfType(mobjtype_t type);
 void P_RemoveSavegameMobj(mobj_t *th);
+
+extern collectible_t *storedcollectibles;
+extern size_t numstoredcollectibles;
+
+void P_ClearCollectibles(void);
+void P_StoreParkedCollectibles(void);
+collectible_t *P_AddCollectible(const mobj_t *mobj);
+void P_CollectibleToMobj(mobj_t *mobj, const collectible_t *rec);
+void P_PromoteCollectiblesInBlocks(INT32 xl, INT32 xh, INT32 yl, INT32 yh);
+void P_PromoteCollectiblesInRange(fixed_t x, fixed_t y, fixed_t range);
+void P_PromoteTouchableCollectibles(mobj_t *thing, fixed_t x, fixed_t y);
+void P_PromoteSectorCollectibles(sector_t *sector);
+void P_PromoteAllCollectibles(void);
 boolean P_SetPlayerMobjState(mobj_t *mobj, statenum_t state);
 boolean P_SetMobjState(mobj_t *mobj, statenum_t state);
 void P_RunShields(void);
@@ -369,6 +395,7 @@ boolean P_CheckMissileRange(mobj_t *actor);
 
 void P_NewChaseDir(mobj_t *actor);
 boolean P_LookForPlayers(mobj_t *actor, boolean allaround, boolean tracer, fixed_t dist);
+boolean P_LookForShield(mobj_t *actor);
 
 mobj_t *P_InternalFlickySpawn(mobj_t *actor, mobjtype_t flickytype, fixed_t momz, boolean lookforplayers, SINT8 moveforward);
 void P_InternalFlickySetColor(mobj_t *actor, UINT8 extrainfo);
@@ -408,6 +435,7 @@ void P_SetThingPosition(mobj_t *thing);
 void P_SetUnderlayPosition(mobj_t *thing);
 
 boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y);
+void Command_Checkposbench_f(void);
 boolean P_CheckCameraPosition(fixed_t x, fixed_t y, camera_t *thiscam);
 boolean P_TryMove(mobj_t *thing, fixed_t x, fixed_t y, boolean allowdropoff);
 boolean P_Move(mobj_t *actor, fixed_t speed);
@@ -420,6 +448,7 @@ void P_CheckHoopPosition(mobj_t *hoopthing, fixed_t x, fixed_t y, fixed_t z, fix
 boolean P_CheckSector(sector_t *sector, boolean crunch);
 
 void P_DelSeclist(msecnode_t *node);
+msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode);
 void P_DelPrecipSeclist(mprecipsecnode_t *node);
 
 void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y);
@@ -443,6 +472,7 @@ extern INT32 bmapheight; // in mapblocks
 extern fixed_t bmaporgx;
 extern fixed_t bmaporgy; // origin of block map
 extern mobj_t **blocklinks; // for thing chains
+extern collectible_t **collectibleblocklinks; // for stored collectible chains
 
 //
 // P_INTER
@@ -15,6 +15,7 @@
 
 #include "doomdef.h"
 #include "g_game.h"
+#include "i_system.h" // I_GetPreciseTime
 #include "m_bbox.h"
 #include "m_random.h"
 #include "p_local.h"
@@ -2025,6 +2026,9 @@ boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y)
 		I_Error("Previously-removed Thing of type %u crashes P_CheckPosition!", thing->type);
 #endif
 
+	if (thing->player)
+		P_PromoteTouchableCollectibles(thing, x, y);
+
 	P_SetTarget(&tmthing, thing);
 	tmflags = thing->flags;
 
@@ -2269,6 +2273,105 @@ boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y)
 	return blockval;
 }
 
+//
+// Command_Checkposbench_f
+//
+// Times P_CheckPosition against the current level, with an inert probe
+// standing in for each object in turn, so that changes to mobj_t and to
+// the blockmap code can be compared on a dense map.
+//
+void Command_Checkposbench_f(void)
+{
+	INT32 rounds = 16, r;
+	size_t i, count = 0;
+	mobj_t **list;
+	mobj_t *probe;
+	thinker_t *th;
+	UINT32 blocked = 0;
+	precise_t start, time;
+	UINT64 checks, micros;
+
+	if (gamestate != GS_LEVEL)
+	{
+		CONS_Printf(M_GetText("You must be in a level to use this.\n"));
+		return;
+	}
+
+	if (netgame || multiplayer)
+	{
+		CONS_Printf(M_GetText("This only works in single player.\n"));
+		return;
+	}
+
+	if (COM_Argc() >= 2)
+	{
+		rounds = atoi(COM_Argv(1));
+		if (rounds <= 0)
+		{
+			CONS_Printf(M_GetText("checkposbench [<rounds>]: Time P_CheckPosition on every object in the level\n"));
+			return;
+		}
+	}
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
+			count++;
+
+	if (!count)
+	{
+		CONS_Printf(M_GetText("There are no objects in the level.\n"));
+		return;
+	}
+
+	// Note the objects down first, the probe joins the same list
+	list = Z_Malloc(count * sizeof (*list), PU_STATIC, NULL);
+	count = 0;
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
+			list[count++] = (mobj_t *)th;
+
+	// Solid, but not a player, missile, pusher or anything else that
+	// would act on what it touches; and kept out of the blockmap so
+	// that nothing else ever runs into it. Scripts don't get to see it,
+	// as hooks for every type would otherwise run on it and skew the times.
+	LUAh_SuspendMobjHooks(true);
+	probe = P_SpawnMobj(list[0]->x, list[0]->y, list[0]->z, MT_NULL);
+	probe->flags = MF_NOBLOCKMAP|MF_NOSECTOR|MF_NOGRAVITY|MF_SOLID;
+
+	start = I_GetPreciseTime();
+	for (r = 0; r < rounds; r++)
+	{
+		for (i = 0; i < count; i++)
+		{
+			mobj_t *mo = list[i];
+
+			probe->x = mo->x;
+			probe->y = mo->y;
+			probe->z = mo->z;
+			probe->radius = mo->radius;
+			probe->height = mo->height;
+			probe->scale = mo->scale;
+			probe->eflags = mo->eflags & MFE_VERTICALFLIP;
+
+			if (!P_CheckPosition(probe, mo->x, mo->y))
+				blocked++;
+		}
+	}
+	time = I_GetPreciseTime() - start;
+
+	P_SetTarget(&tmthing, NULL);
+	P_RemoveMobj(probe);
+	LUAh_SuspendMobjHooks(false);
+	Z_Free(list);
+
+	checks = (UINT64)count * rounds;
+	micros = time * 1000000 / I_GetPrecisePrecision();
+	CONS_Printf(M_GetText("%u checks of %u objects in %u ms: %u checks/s, %u ns per check, %u blocked\n"),
+		(UINT32)checks, (UINT32)count, (UINT32)(micros / 1000),
+		(UINT32)(micros ? checks * 1000000 / micros : 0),
+		(UINT32)(micros * 1000 / checks), blocked);
+}
+
 static const fixed_t hoopblockdist = 16*FRACUNIT + 8*FRACUNIT;
 static const fixed_t hoophalfheight = (56*FRACUNIT)/2;
 
@@ -4258,6 +4361,25 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 	nofit = false;
 	crushchange = crunch;
 
+	// Stored collectibles have to be mobjs again to be moved or crushed
+	if (numstoredcollectibles)
+	{
+		P_PromoteSectorCollectibles(sector);
+
+		for (i = 0; i < sector->numattached; i++)
+			if (sector->attachedsolid[i])
+				P_PromoteSectorCollectibles(&sectors[sector->attached[i]]);
+
+		for (i = 0; i < sector->linecount; i++)
+		{
+			polyobj_t *po = sector->lines[i]->polyobj;
+
+			if (po && (po->flags & POF_SOLID) && po->lines[0]->backsector == sector)
+				P_PromoteCollectiblesInBlocks(po->blockbox[BOXLEFT], po->blockbox[BOXRIGHT],
+					po->blockbox[BOXBOTTOM], po->blockbox[BOXTOP]);
+		}
+	}
+
 	// killough 4/4/98: scan list front-to-back until empty or exhausted,
 	// restarting from beginning after each thing is processed. Avoids
 	// crashes, and is sure to examine all things in the sector, and only
@@ -4545,7 +4667,7 @@ static inline void P_PutPrecipSecnode(mprecipsecnode_t *node)
 // sectors this object appears in. This is called when creating a list of
 // nodes that will get linked in later. Returns a pointer to the new node.
 
-static msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode)
+msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode)
 {
 	msecnode_t *node;
 
@@ -4796,8 +4918,40 @@ static inline boolean PIT_GetPrecipSectors(line_t *ld)
 	return true;
 }
 
+// P_NoLinesInBlocks
+// Returns true if no line goes through any of the given blockmap blocks.
+// Polyobject lines don't count, since no one collecting sectors wants them.
+
+static boolean P_NoLinesInBlocks(INT32 xl, INT32 xh, INT32 yl, INT32 yh)
+{
+	INT32 bx, by;
+
+	if (xl < 0)
+		xl = 0;
+	if (yl < 0)
+		yl = 0;
+	if (xh >= bmapwidth)
+		xh = bmapwidth - 1;
+	if (yh >= bmapheight)
+		yh = bmapheight - 1;
+
+	for (by = yl; by <= yh; by++)
+		for (bx = xl; bx <= xh; bx++)
+		{
+			// First index is really empty, so +1 it.
+			if (blockmaplump[blockmap[by*bmapwidth + bx] + 1] != -1)
+				return false;
+		}
+
+	return true;
+}
+
 // P_CreateSecNodeList alters/creates the sector_list that shows what sectors
 // the object resides in.
+//
+// When no line comes near the object's box, the only sector it can touch
+// is the one at its (x, y) point, so the line pass is skipped; and if that
+// sector was all it touched already, there's nothing left to do.
 
 void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 {
@@ -4805,6 +4959,40 @@ void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 	msecnode_t *node = sector_list;
 	mobj_t *saved_tmthing = tmthing; /* cph - see comment at func end */
 	fixed_t saved_tmx = tmx, saved_tmy = tmy; /* ditto */
+	boolean nolines;
+
+	xl = (unsigned)(x - thing->radius - bmaporgx)>>MAPBLOCKSHIFT;
+	xh = (unsigned)(x + thing->radius - bmaporgx)>>MAPBLOCKSHIFT;
+	yl = (unsigned)(y - thing->radius - bmaporgy)>>MAPBLOCKSHIFT;
+	yh = (unsigned)(y + thing->radius - bmaporgy)>>MAPBLOCKSHIFT;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	nolines = P_NoLinesInBlocks(xl, xh, yl, yh);
+
+	if (nolines && node && !node->m_sectorlist_next
+		&& node->m_sector == thing->subsector->sector)
+	{
+		node->m_thing = thing;
+
+		// Leave the globals the way the full pass would have.
+		tmflags = thing->flags;
+		if (tmthing)
+		{
+			tmbbox[BOXTOP]  = tmy + tmthing->radius;
+			tmbbox[BOXBOTTOM] = tmy - tmthing->radius;
+			tmbbox[BOXRIGHT]  = tmx + tmthing->radius;
+			tmbbox[BOXLEFT]   = tmx - tmthing->radius;
+		}
+		else
+		{
+			tmbbox[BOXTOP] = y + thing->radius;
+			tmbbox[BOXBOTTOM] = y - thing->radius;
+			tmbbox[BOXRIGHT] = x + thing->radius;
+			tmbbox[BOXLEFT] = x - thing->radius;
+		}
+		return;
+	}
 
 	// First, clear out the existing m_thing fields. As each node is
 	// added or verified as needed, m_thing will be set properly. When
@@ -4828,18 +5016,14 @@ void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 	tmbbox[BOXRIGHT] = x + tmthing->radius;
 	tmbbox[BOXLEFT] = x - tmthing->radius;
 
-	validcount++; // used to make sure we only process a line once
-
-	xl = (unsigned)(tmbbox[BOXLEFT] - bmaporgx)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(tmbbox[BOXRIGHT] - bmaporgx)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(tmbbox[BOXBOTTOM] - bmaporgy)>>MAPBLOCKSHIFT;
-	yh = (unsigned)(tmbbox[BOXTOP] - bmaporgy)>>MAPBLOCKSHIFT;
-
-	BMBOUNDFIX(xl, xh, yl, yh);
+	if (!nolines)
+	{
+		validcount++; // used to make sure we only process a line once
 
-	for (bx = xl; bx <= xh; bx++)
-		for (by = yl; by <= yh; by++)
-			P_BlockLinesIterator(bx, by, PIT_GetSectors);
+		for (bx = xl; bx <= xh; bx++)
+			for (by = yl; by <= yh; by++)
+				P_BlockLinesIterator(bx, by, PIT_GetSectors);
+	}
 
 	// Add the sector of the (x, y) point to sector_list.
 	sector_list = P_AddSecnode(thing->subsector->sector, thing, sector_list);
@@ -4888,6 +5072,29 @@ void P_CreatePrecipSecNodeList(precipmobj_t *thing,fixed_t x,fixed_t y)
 	INT32 xl, xh, yl, yh, bx, by;
 	mprecipsecnode_t *node = precipsector_list;
 	precipmobj_t *saved_tmthing = tmprecipthing; /* cph - see comment at func end */
+	boolean nolines;
+
+	xl = (unsigned)(x - 2*FRACUNIT - bmaporgx)>>MAPBLOCKSHIFT;
+	xh = (unsigned)(x + 2*FRACUNIT - bmaporgx)>>MAPBLOCKSHIFT;
+	yl = (unsigned)(y - 2*FRACUNIT - bmaporgy)>>MAPBLOCKSHIFT;
+	yh = (unsigned)(y + 2*FRACUNIT - bmaporgy)>>MAPBLOCKSHIFT;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	// Same shortcuts as P_CreateSecNodeList.
+	nolines = P_NoLinesInBlocks(xl, xh, yl, yh);
+
+	if (nolines && node && !node->m_sectorlist_next
+		&& node->m_sector == thing->subsector->sector)
+	{
+		node->m_thing = thing;
+
+		preciptmbbox[BOXTOP] = y + 2*FRACUNIT;
+		preciptmbbox[BOXBOTTOM] = y - 2*FRACUNIT;
+		preciptmbbox[BOXRIGHT] = x + 2*FRACUNIT;
+		preciptmbbox[BOXLEFT] = x - 2*FRACUNIT;
+		return;
+	}
 
 	// First, clear out the existing m_thing fields. As each node is
 	// added or verified as needed, m_thing will be set properly. When
@@ -4907,18 +5114,14 @@ void P_CreatePrecipSecNodeList(precipmobj_t *thing,fixed_t x,fixed_t y)
 	preciptmbbox[BOXRIGHT] = x + 2*FRACUNIT;
 	preciptmbbox[BOXLEFT] = x - 2*FRACUNIT;
 
-	validcount++; // used to make sure we only process a line once
-
-	xl = (unsigned)(preciptmbbox[BOXLEFT] - bmaporgx)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(preciptmbbox[BOXRIGHT] - bmaporgx)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(preciptmbbox[BOXBOTTOM] - bmaporgy)>>MAPBLOCKSHIFT;
-	yh = (unsigned)(preciptmbbox[BOXTOP] - bmaporgy)>>MAPBLOCKSHIFT;
-
-	BMBOUNDFIX(xl, xh, yl, yh);
+	if (!nolines)
+	{
+		validcount++; // used to make sure we only process a line once
 
-	for (bx = xl; bx <= xh; bx++)
-		for (by = yl; by <= yh; by++)
-			P_BlockLinesIterator(bx, by, PIT_GetPrecipSectors);
+		for (bx = xl; bx <= xh; bx++)
+			for (by = yl; by <= yh; by++)
+				P_BlockLinesIterator(bx, by, PIT_GetPrecipSectors);
+	}
 
 	// Add the sector of the (x, y) point to sector_list.
 	precipsector_list = P_AddPrecipSecnode(thing->subsector->sector, thing, precipsector_list);
@@ -697,6 +697,8 @@ void P_UnsetThingPosition(mobj_t *thing)
 	I_Assert(thing != NULL);
 	I_Assert(!P_MobjWasRemoved(thing));
 
+	thing->eflags &= ~MFE_PARKED; // it is being moved, see P_ParkCollectible
+
 	if (!(thing->flags & MF_NOSECTOR))
 	{
 		/* invisible things don't need to be in sector list
@@ -900,6 +902,80 @@ void P_SetPrecipitationThingPosition(precipmobj_t *thing)
 	precipsector_list = NULL; // clear for next time
 }
 
+//
+// P_SetCollectiblePosition
+// Links a stored collectible into its sector and block.
+// Only collectibles that touch no other sector are stored,
+// so unlike P_SetThingPosition there's no node list to build.
+//
+void P_SetCollectiblePosition(collectible_t *rec)
+{
+	collectible_t **link = &rec->subsector->sector->collectiblelist;
+	const INT32 blockx = (unsigned)(rec->x - bmaporgx)>>MAPBLOCKSHIFT;
+	const INT32 blocky = (unsigned)(rec->y - bmaporgy)>>MAPBLOCKSHIFT;
+
+	if ((rec->snext = *link) != NULL)
+		rec->snext->sprev = &rec->snext;
+	rec->sprev = link;
+	*link = rec;
+
+	if (blockx >= 0 && blockx < bmapwidth
+		&& blocky >= 0 && blocky < bmapheight)
+	{
+		link = &collectibleblocklinks[blocky*bmapwidth + blockx];
+		if ((rec->bnext = *link) != NULL)
+			rec->bnext->bprev = &rec->bnext;
+		rec->bprev = link;
+		*link = rec;
+	}
+	else // off the map
+		rec->bnext = NULL, rec->bprev = NULL;
+}
+
+void P_UnsetCollectiblePosition(collectible_t *rec)
+{
+	if ((*rec->sprev = rec->snext) != NULL)
+		rec->snext->sprev = rec->sprev;
+
+	if (rec->bprev && (*rec->bprev = rec->bnext) != NULL)
+		rec->bnext->bprev = rec->bprev;
+}
+
+//
+// P_SetPromotedThingPosition
+// Links a collectible that was just turned back into a mobj.
+// Its subsector is already set and it touches only that sector.
+// Unlike P_SetThingPosition, this leaves sector_list and the
+// tm* globals alone, so it is safe to call in the middle of
+// P_CheckPosition and the blockmap iterators.
+//
+void P_SetPromotedThingPosition(mobj_t *thing)
+{
+	sector_t *sec = thing->subsector->sector;
+	const INT32 blockx = (unsigned)(thing->x - bmaporgx)>>MAPBLOCKSHIFT;
+	const INT32 blocky = (unsigned)(thing->y - bmaporgy)>>MAPBLOCKSHIFT;
+	mobj_t **link = &sec->thinglist;
+
+	if ((thing->snext = *link) != NULL)
+		thing->snext->sprev = &thing->snext;
+	thing->sprev = link;
+	*link = thing;
+
+	thing->touching_sectorlist = P_AddSecnode(sec, thing, NULL);
+
+	if (blockx >= 0 && blockx < bmapwidth
+		&& blocky >= 0 && blocky < bmapheight)
+	{
+		link = &blocklinks[blocky*bmapwidth + blockx];
+		if ((thing->bnext = *link) != NULL)
+			thing->bnext->bprev = &thing->bnext;
+		thing->bprev = link;
+		*link = thing;
+	}
+	else // thing is off the map
+		thing->bnext = NULL, thing->bprev = NULL;
+}
+
 //
 // BLOCK MAP ITERATORS
 // For each line/thing in the given mapblock,
@@ -1001,6 +1077,167 @@ boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
 	return true;
 }
 
+//
+// THING QUERIES
+//
+// Collects the mobjs whose centre lies inside a box or circle, straight
+// from the blockmap, into a list the caller owns and can reuse between
+// calls. Nothing is called back, so the caller can do whatever it likes
+// with the results, and no global state (tmthing and friends) is touched.
+//
+// Results come out in thinker order, the same order a scan of
+// thlist[THINK_MOBJ] would find them in, so swapping such a scan for a
+// query doesn't change which mobj wins a tie. QT_SORTDIST sorts them
+// nearest first instead (ties still go by thinker order).
+//
+// Mobjs that aren't in the blockmap (MF_NOBLOCKMAP, or off the map) are
+// never found. Neither are MF_NOTHINK mobjs, unless QT_NOTHINK is given.
+//
+
+static int P_CompareThingOrder(const void *p1, const void *p2)
+{
+	const mobj_t *mo1 = ((const thingresult_t *)p1)->mobj;
+	const mobj_t *mo2 = ((const thingresult_t *)p2)->mobj;
+
+	if (mo1->typeseq != mo2->typeseq)
+		return (mo1->typeseq < mo2->typeseq) ? -1 : 1;
+
+	// Only MF_NOTHINK mobjs share a sequence number (0),
+	// so order those by position instead. Never by address!
+	if (mo1->x != mo2->x)
+		return (mo1->x < mo2->x) ? -1 : 1;
+	if (mo1->y != mo2->y)
+		return (mo1->y < mo2->y) ? -1 : 1;
+	return (mo1->z < mo2->z) ? -1 : (mo1->z > mo2->z);
+}
+
+static int P_CompareThingDist(const void *p1, const void *p2)
+{
+	const fixed_t dist1 = ((const thingresult_t *)p1)->dist;
+	const fixed_t dist2 = ((const thingresult_t *)p2)->dist;
+
+	if (dist1 != dist2)
+		return (dist1 < dist2) ? -1 : 1;
+
+	return P_CompareThingOrder(p1, p2);
+}
+
+static size_t P_QueryThings(thinglist_t *list, fixed_t x, fixed_t y, fixed_t radius, fixed_t *bbox,
+	mobjflag_t flags, mobjtype_t type, UINT8 qflags)
+{
+	INT32 xl, xh, yl, yh, bx, by;
+	mobj_t *mo;
+	fixed_t dx, dy, dist;
+
+	list->numresults = 0;
+
+	if (!blocklinks)
+		return 0;
+
+	if (bbox[BOXRIGHT] < bmaporgx || bbox[BOXTOP] < bmaporgy)
+		return 0;
+
+	// The box may hang off the edge of the map
+	xl = (bbox[BOXLEFT] <= bmaporgx) ? 0 : (INT32)(((INT64)bbox[BOXLEFT] - bmaporgx)>>MAPBLOCKSHIFT);
+	yl = (bbox[BOXBOTTOM] <= bmaporgy) ? 0 : (INT32)(((INT64)bbox[BOXBOTTOM] - bmaporgy)>>MAPBLOCKSHIFT);
+	xh = (INT32)min(((INT64)bbox[BOXRIGHT] - bmaporgx)>>MAPBLOCKSHIFT, bmapwidth - 1);
+	yh = (INT32)min(((INT64)bbox[BOXTOP] - bmaporgy)>>MAPBLOCKSHIFT, bmapheight - 1);
+
+	for (by = yl; by <= yh; by++)
+		for (bx = xl; bx <= xh; bx++)
+			for (mo = blocklinks[by*bmapwidth + bx]; mo; mo = mo->bnext)
+			{
+				if (mo->x < bbox[BOXLEFT] || mo->x > bbox[BOXRIGHT]
+				|| mo->y < bbox[BOXBOTTOM] || mo->y > bbox[BOXTOP])
+					continue;
+
+				if (flags && !(mo->flags & flags))
+					continue;
+
+				if (type != MT_NULL && mo->type != type)
+					continue;
+
+				if (!mo->typeseq && !(qflags & QT_NOTHINK))
+					continue; // Not on the thinker list (or already removed)
+
+				dx = mo->x - x;
+				dy = mo->y - y;
+				dist = P_AproxDistance(dx, dy);
+
+				if (radius && dist > radius)
+					continue;
+
+				if (list->numresults == list->maxresults)
+				{
+					list->maxresults = list->maxresults ? list->maxresults*2 : 64;
+					list->results = Z_Realloc(list->results, list->maxresults * sizeof (*list->results), PU_STATIC, NULL);
+				}
+
+				list->results[list->numresults].mobj = mo;
+				list->results[list->numresults].dist = dist;
+				list->numresults++;
+			}
+
+	if (list->numresults > 1)
+		qsort(list->results, list->numresults, sizeof (*list->results),
+			(qflags & QT_SORTDIST) ? P_CompareThingDist : P_CompareThingOrder);
+
+	return list->numresults;
+}
+
+//
+// P_QueryThingsInBox
+//
+// Finds every mobj whose centre is inside bbox.
+// Filters: flags, if non-zero, requires any one of the given flags;
+// type, if not MT_NULL, requires that type.
+// Distances are measured from the middle of the box.
+//
+size_t P_QueryThingsInBox(thinglist_t *list, fixed_t *bbox, mobjflag_t flags, mobjtype_t type, UINT8 qflags)
+{
+	return P_QueryThings(list,
+		bbox[BOXLEFT]/2 + bbox[BOXRIGHT]/2, bbox[BOXBOTTOM]/2 + bbox[BOXTOP]/2, 0, bbox,
+		flags, type, qflags);
+}
+
+//
+// P_QueryThingsInRadius
+//
+// Finds every mobj whose centre is within radius of (x, y),
+// going by P_AproxDistance. Filters as for P_QueryThingsInBox.
+//
+size_t P_QueryThingsInRadius(thinglist_t *list, fixed_t x, fixed_t y, fixed_t radius, mobjflag_t flags, mobjtype_t type, UINT8 qflags)
+{
+	fixed_t bbox[4];
+
+	if (radius <= 0)
+	{
+		list->numresults = 0;
+		return 0;
+	}
+
+	// Clamp the box rather than let it wrap around
+	bbox[BOXLEFT] = (x < INT32_MIN + radius) ? INT32_MIN : x - radius;
+	bbox[BOXBOTTOM] = (y < INT32_MIN + radius) ? INT32_MIN : y - radius;
+	bbox[BOXRIGHT] = (x > INT32_MAX - radius) ? INT32_MAX : x + radius;
+	bbox[BOXTOP] = (y > INT32_MAX - radius) ? INT32_MAX : y + radius;
+
+	return P_QueryThings(list, x, y, radius, bbox, flags, type, qflags);
+}
+
+//
+// P_ClearThingList
+//
+// Frees the memory held by a thing list.
+//
+void P_ClearThingList(thinglist_t *list)
+{
+	if (list->results)
+		Z_Free(list->results);
+	list->results = NULL;
+	list->numresults = list->maxresults = 0;
+}
+
 //
 // INTERCEPT ROUTINES
 //
@@ -1144,38 +1381,87 @@ static boolean PIT_AddThingIntercepts(mobj_t *thing)
 }
 
 //
-// P_TraverseIntercepts
-// Returns true if the traverser function returns true
-// for all lines.
+// P_SortIntercepts
+// Stable sort of the intercepts by frac, so that ones at the same
+// distance keep the order they were found in. Short lists get an insertion
+// sort, long ones a byte-at-a-time radix sort through a scratch buffer.
 //
-static boolean P_TraverseIntercepts(traverser_t func, fixed_t maxfrac)
+#define INTERCEPTS_INSERTIONSORT 64
+
+static void P_SortIntercepts(intercept_t *list, size_t count)
 {
-	size_t count;
-	fixed_t dist;
-	intercept_t *scan, *in = NULL;
+	static intercept_t *scratch = NULL;
+	static size_t max_scratch = 0;
+	intercept_t *src = list, *dst, *swap;
+	size_t counts[256];
+	size_t i, j, pos;
+	INT32 shift;
+
+	if (count <= INTERCEPTS_INSERTIONSORT)
+	{
+		for (i = 1; i < count; i++)
+		{
+			intercept_t in = list[i];
+
+			for (j = i; j > 0 && list[j-1].frac > in.frac; j--)
+				list[j] = list[j-1];
+			list[j] = in;
+		}
+		return;
+	}
 
-	count = intercept_p - intercepts;
+	if (max_scratch < count)
+	{
+		max_scratch = count;
+		scratch = Z_Realloc(scratch, sizeof (*scratch) * max_scratch, PU_STATIC, NULL);
+	}
+	dst = scratch;
 
-	while (count--)
+	// Four passes, so the sorted list ends up back where it started.
+	for (shift = 0; shift < 32; shift += 8)
 	{
-		dist = INT32_MAX;
-		for (scan = intercepts; scan < intercept_p; scan++)
+		memset(counts, 0, sizeof (counts));
+		for (i = 0; i < count; i++)
+			counts[((UINT32)src[i].frac ^ 0x80000000u) >> shift & 0xFF]++;
+
+		for (i = pos = 0; i < 256; i++)
 		{
-			if (scan->frac < dist)
-			{
-				dist = scan->frac;
-				in = scan;
-			}
+			size_t n = counts[i];
+			counts[i] = pos;
+			pos += n;
 		}
 
-		if (dist > maxfrac)
-			return true; // Checked everything in range.
+		for (i = 0; i < count; i++)
+			dst[counts[((UINT32)src[i].frac ^ 0x80000000u) >> shift & 0xFF]++] = src[i];
 
-		if (!func(in))
-			return false; // Don't bother going farther.
-
-		in->frac = INT32_MAX;
+		swap = src;
+		src = dst;
+		dst = swap;
 	}
+}
+
+//
+// P_TraverseIntercepts
+// Returns true if the traverser function returns true
+// for all lines.
+//
+// Intercepts past maxfrac are dropped, the rest are sorted once and
+// visited nearest first. Ties go in the order the intercepts were found,
+// the same as picking the nearest one over and over would give.
+//
+static boolean P_TraverseIntercepts(traverser_t func, fixed_t maxfrac)
+{
+	intercept_t *scan, *in = intercepts;
+
+	for (scan = intercepts; scan < intercept_p; scan++)
+		if (scan->frac <= maxfrac)
+			*in++ = *scan;
+
+	P_SortIntercepts(intercepts, in - intercepts);
+
+	for (scan = intercepts; scan < in; scan++)
+		if (!func(scan))
+			return false; // Don't bother going farther.
 
 	return true; // Everything was traversed.
 }
@@ -52,6 +52,9 @@ INT32 P_BoxOnLineSide(fixed_t *tmbox, line_t *ld);
 void P_UnsetPrecipThingPosition(precipmobj_t *thing);
 void P_SetPrecipitationThingPosition(precipmobj_t *thing);
 void P_CreatePrecipSecNodeList(precipmobj_t *thing, fixed_t x,fixed_t y);
+void P_SetCollectiblePosition(collectible_t *rec);
+void P_UnsetCollectiblePosition(collectible_t *rec);
+void P_SetPromotedThingPosition(mobj_t *thing);
 boolean P_SceneryTryMove(mobj_t *thing, fixed_t x, fixed_t y);
 
 extern fixed_t opentop, openbottom, openrange, lowfloor, highceiling;
@@ -63,6 +66,27 @@ void P_LineOpening(line_t *plinedef, mobj_t *mobj);
 boolean P_BlockLinesIterator(INT32 x, INT32 y, boolean(*func)(line_t *));
 boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean(*func)(mobj_t *));
 
+typedef struct
+{
+	mobj_t *mobj;
+	fixed_t dist; // P_AproxDistance from the middle of the query, in 2D
+} thingresult_t;
+
+// Reusable result buffer for thing queries; zero it before first use
+typedef struct
+{
+	thingresult_t *results;
+	size_t numresults;
+	size_t maxresults;
+} thinglist_t;
+
+#define QT_SORTDIST     1 // nearest first, instead of thinker order
+#define QT_NOTHINK      2 // also find MF_NOTHINK mobjs
+
+size_t P_QueryThingsInBox(thinglist_t *list, fixed_t *bbox, mobjflag_t flags, mobjtype_t type, UINT8 qflags);
+size_t P_QueryThingsInRadius(thinglist_t *list, fixed_t x, fixed_t y, fixed_t radius, mobjflag_t flags, mobjtype_t type, UINT8 qflags);
+void P_ClearThingList(thinglist_t *list);
+
 #define PT_ADDLINES     1
 #define PT_ADDTHINGS    2
 #define PT_EARLYOUT     4
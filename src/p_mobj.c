@@ -35,6 +35,9 @@
 #include "f_finale.h"
 #include "m_cond.h"
 
+boolean LUA_HasAction(const char *action);
+boolean LUA_IsLoaded(void);
+
 static CV_PossibleValue_t CV_BobSpeed[] = {{0, "MIN"}, {4*FRACUNIT, "MAX"}, {0, NULL}};
 consvar_t cv_movebob = {"movebob", "1.0", CV_FLOAT|CV_SAVE, CV_BobSpeed, NULL, 0, NULL, NULL, 0, 0, NULL};
 
@@ -696,7 +699,6 @@ boolean P_WeaponOrPanel(mobjtype_t type)
 //
 void P_EmeraldManager(void)
 {
-	thinker_t *think;
 	mobj_t *mo;
 	INT32 i,j;
 	INT32 numtospawn;
@@ -715,28 +717,21 @@ void P_EmeraldManager(void)
 		spawnpoints[i] = NULL;
 	}
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	for (mo = P_FirstMobjOfType(MT_EMERALDSPAWN); mo; mo = mo->typenext)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo = (mobj_t *)think;
-
-		if (mo->type == MT_EMERALDSPAWN)
-		{
-			if (mo->threshold || mo->target) // Either has the emerald spawned or is spawning
-			{
-				numwithemerald++;
-				emeraldsspawned |= mobjinfo[mo->reactiontime].speed;
-			}
-			else if (numspawnpoints < MAXHUNTEMERALDS)
-				spawnpoints[numspawnpoints++] = mo; // empty spawn points
-		}
-		else if (mo->type == MT_FLINGEMERALD)
+		if (mo->threshold || mo->target) // Either has the emerald spawned or is spawning
 		{
 			numwithemerald++;
-			emeraldsspawned |= mo->threshold;
+			emeraldsspawned |= mobjinfo[mo->reactiontime].speed;
 		}
+		else if (numspawnpoints < MAXHUNTEMERALDS)
+			spawnpoints[numspawnpoints++] = mo; // empty spawn points
+	}
+
+	for (mo = P_FirstMobjOfType(MT_FLINGEMERALD); mo; mo = mo->typenext)
+	{
+		numwithemerald++;
+		emeraldsspawned |= mo->threshold;
 	}
 
 	if (numspawnpoints == 0)
@@ -4125,6 +4120,191 @@ static void P_RingThinker(mobj_t *mobj)
 	P_CycleMobjState(mobj);
 }
 
+//
+// Parked collectibles
+//
+// Rings, coins, spheres, chips and stars mostly just spin in place, yet
+// their full thinker still looks for lava and Lua overrides on every
+// tic. Once it finds one with nothing to do, the object is parked
+// (MFE_PARKED) and P_MobjThinker only steps its state animation and
+// looks for attraction shields, after checking that nothing has
+// disturbed it. Moving it, or writing to it from Lua, wakes it up
+// directly.
+//
+// The flag lives in eflags, so it is archived with the mobj and every
+// client parks and wakes the same objects on the same tics.
+//
+// A parked object far from every player is then stored as a compact
+// collectible_t and taken out of the thinker list altogether, see
+// P_StoreCollectible.
+//
+
+// How close a player with an attraction shield has to be for
+// collectibles to stay awake, leaving room for their movement this tic.
+static fixed_t P_CollectibleWakeDist(mobj_t *mo)
+{
+	INT64 dist = 2*(INT64)FixedMul(RING_DIST, mo->scale) + 2*(INT64)P_AproxDistance(mo->momx, mo->momy);
+	return (fixed_t)min(dist, INT32_MAX);
+}
+
+// Everything the full thinker would have reacted to, that can change
+// without waking the object up
+static inline boolean P_CollectibleStaysParked(mobj_t *mobj)
+{
+	return !(mobj->momx | mobj->momy | mobj->momz)
+		&& mobj->tics == -1 && mobj->health > 0 && !mobj->fuse
+		&& mobj->scale == mobj->destscale
+		&& !(mobj->flags & (MF_PUSHABLE|MF_BOSS|MF_SCENERY))
+		&& !(mobj->flags2 & (MF2_NIGHTSPULL|MF2_DONTDRAW))
+		&& !(mobj->eflags & (MFE_PUSHED|MFE_SPRUNG|MFE_TRACERANGLE))
+		&& !mobj->target && !mobj->tracer && !mobj->hnext && !mobj->hprev
+		&& GETSECSPECIAL(mobj->subsector->sector->special, 2) != 8;
+}
+
+//
+// P_ParkCollectible
+//
+// Parks a collectible that has just run its full thinker, if it can be.
+//
+static void P_ParkCollectible(mobj_t *mobj)
+{
+	msecnode_t *node;
+	ffloor_t *rover;
+
+	if (!P_CollectibleStaysParked(mobj))
+		return;
+
+	// Moving lava could reach it, see P_KillRingsInLava
+	for (node = mobj->touching_sectorlist; node; node = node->m_sectorlist_next)
+		for (rover = node->m_sector->ffloors; rover; rover = rover->next)
+			if (rover->flags & FF_SWIMMABLE)
+				return;
+
+	if (LUAh_MobjThinkerHooked(mobj->type) || LUA_HasAction("A_ATTRACTCHASE"))
+		return;
+
+	mobj->eflags |= MFE_PARKED;
+}
+
+// Parked collectibles that P_StoreParkedCollectibles will look at
+// once this tic's thinkers are done
+static mobj_t **parkedqueue = NULL;
+static size_t numparkedqueue = 0, maxparkedqueue = 0;
+
+static void P_QueueParkedCollectible(mobj_t *mobj)
+{
+	// Lua can hold on to any mobj, and objectplace needs them all
+	if (LUA_IsLoaded() || objectplacing)
+		return;
+
+	if (numparkedqueue >= maxparkedqueue)
+	{
+		maxparkedqueue = maxparkedqueue ? maxparkedqueue*2 : 128;
+		parkedqueue = Z_Realloc(parkedqueue, maxparkedqueue * sizeof (*parkedqueue), PU_STATIC, NULL);
+	}
+
+	parkedqueue[numparkedqueue] = NULL;
+	P_SetTarget(&parkedqueue[numparkedqueue++], mobj);
+}
+
+//
+// P_PromoteCollectiblesNearShield
+//
+// Brings back the stored collectibles that a player with an attraction
+// shield could pull in this tic, so that P_LookForShield sees them.
+//
+void P_PromoteCollectiblesNearShield(mobj_t *mo)
+{
+	if (numstoredcollectibles)
+		P_PromoteCollectiblesInRange(mo->x, mo->y, P_CollectibleWakeDist(mo));
+}
+
+//
+// P_PromoteAttractedCollectibles
+//
+// Does the above for every player with an attraction shield.
+// Called before the thinkers run.
+//
+void P_PromoteAttractedCollectibles(void)
+{
+	INT32 i;
+
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		mobj_t *mo = players[i].mo;
+
+		if (!playeringame[i] || !mo || P_MobjWasRemoved(mo)
+			|| !(players[i].powers[pw_shield] & SH_PROTECTELECTRIC))
+			continue;
+
+		P_PromoteCollectiblesNearShield(mo);
+	}
+}
+
+//
+// P_WakeParkedCollectibles
+//
+// Wakes every parked collectible in the level, for when Lua takes over
+// some of their thinking.
+//
+void P_WakeParkedCollectibles(void)
+{
+	thinker_t *th;
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	{
+		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+			continue;
+
+		((mobj_t *)th)->eflags &= ~MFE_PARKED;
+	}
+}
+
+//
+// P_WakeDormantMobjs
+//
+// MF_DORMANT mobjs only think while a player is within dormancydist of
+// them, or while an awake mobj has them as its target or tracer.
+// Everything near a player is found through the blockmap here, before
+// the thinkers run, and is marked MFE_STAYAWAKE; a dormant mobj that
+// comes to think without that mark falls asleep (see P_MobjThinker).
+// Only game state is looked at, so every node agrees on who sleeps.
+//
+void P_WakeDormantMobjs(void)
+{
+	static thinglist_t nearby;
+	size_t i, j;
+
+	if (!cv_dormancy.value)
+		return;
+
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		mobj_t *mo = players[i].mo;
+
+		if (!playeringame[i] || !mo || P_MobjWasRemoved(mo))
+			continue;
+
+		P_QueryThingsInRadius(&nearby, mo->x, mo->y, cv_dormancydist.value*FRACUNIT, MF_DORMANT, MT_NULL, 0);
+		for (j = 0; j < nearby.numresults; j++)
+		{
+			mobj_t *thing = nearby.results[j].mobj;
+			thing->eflags = (thing->eflags & ~MFE_DORMANT)|MFE_STAYAWAKE;
+		}
+	}
+}
+
+//
+// P_KeepAwake
+//
+// Keeps a dormant mobj that something is going after from falling asleep.
+//
+static inline void P_KeepAwake(mobj_t *mobj)
+{
+	if (mobj && (mobj->flags & MF_DORMANT))
+		mobj->eflags = (mobj->eflags & ~MFE_DORMANT)|MFE_STAYAWAKE;
+}
+
 //
 // P_BossTargetPlayer
 // If closest is true, find the closest player.
@@ -4390,7 +4570,6 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 		if (!mobj->reactiontime && mobj->health <= mobj->info->damage)
 		{ // Spawn pinch dummies from the center when we're leaving it.
-			thinker_t *th;
 			mobj_t *mo2;
 			mobj_t *dummy;
 			SINT8 way0 = mobj->threshold; // 0 through 4.
@@ -4400,13 +4579,9 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 			// scan the thinkers to make sure all the old pinch dummies are gone before making new ones
 			// this can happen if the boss was hurt earlier than expected
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType((mobjtype_t)mobj->info->mass); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				mo2 = (mobj_t *)th;
-				if (mo2->type != (mobjtype_t)mobj->info->mass)
+				if (P_MobjWasRemoved(mo2))
 					continue;
 				if (mo2->tracer != mobj)
 					continue;
@@ -4499,7 +4674,6 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 		if (!(mobj->flags2 & MF2_STRONGBOX))
 		{
-			thinker_t *th;
 			mobj_t *mo2;
 
 			P_SetTarget(&mobj->tracer, NULL);
@@ -4507,14 +4681,8 @@ static void P_Boss3Thinker(mobj_t *mobj)
 			// scan the thinkers
 			// to find a point that matches
 			// the number
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType(MT_BOSS3WAYPOINT); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				mo2 = (mobj_t *)th;
-				if (mo2->type != MT_BOSS3WAYPOINT)
-					continue;
 				if (!mo2->spawnpoint)
 					continue;
 				if (mo2->spawnpoint->angle != mobj->threshold)
@@ -5264,7 +5432,6 @@ static void P_Boss7Thinker(mobj_t *mobj)
 		fixed_t vertical, horizontal;
 		fixed_t airtime = 5*TICRATE;
 		INT32 waypointNum = 0;
-		thinker_t *th;
 		INT32 i;
 		boolean foundgoop = false;
 		INT32 closestNum;
@@ -5288,14 +5455,8 @@ static void P_Boss7Thinker(mobj_t *mobj)
 				closestdist = INT32_MAX; // Just in case...
 
 				// Find waypoint he is closest to
-				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+				for (mo2 = P_FirstMobjOfType(MT_BOSS3WAYPOINT); mo2; mo2 = mo2->typenext)
 				{
-					if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-						continue;
-
-					mo2 = (mobj_t *)th;
-					if (mo2->type != MT_BOSS3WAYPOINT)
-						continue;
 					if (!mo2->spawnpoint)
 						continue;
 					if (mo2->spawnpoint->extrainfo != extrainfo)
@@ -5343,14 +5504,8 @@ static void P_Boss7Thinker(mobj_t *mobj)
 
 		// scan the thinkers to find
 		// the waypoint to use
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType(MT_BOSS3WAYPOINT); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type != MT_BOSS3WAYPOINT)
-				continue;
 			if (!mo2->spawnpoint)
 				continue;
 			if ((mo2->spawnpoint->options & 7) != waypointNum)
@@ -5469,7 +5624,6 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 	if (!mobj->tracer)
 	{
-		thinker_t *th;
 		mobj_t *mo2;
 		mobj_t *last=NULL;
 
@@ -5482,21 +5636,14 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 		// Run through the thinkers ONCE and find all of the MT_BOSS9GATHERPOINT in the map.
 		// Build a hoop linked list of 'em!
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType(MT_BOSS9GATHERPOINT); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS9GATHERPOINT)
-			{
-				if (last)
-					P_SetTarget(&last->hnext, mo2);
-				else
-					P_SetTarget(&mobj->hnext, mo2);
-				P_SetTarget(&mo2->hprev, last);
-				last = mo2;
-			}
+			if (last)
+				P_SetTarget(&last->hnext, mo2);
+			else
+				P_SetTarget(&mobj->hnext, mo2);
+			P_SetTarget(&mo2->hprev, last);
+			last = mo2;
 		}
 	}
 
@@ -6144,35 +6291,26 @@ nodanger:
 // Finds the CLOSEST axis to the source mobj
 mobj_t *P_GetClosestAxis(mobj_t *source)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	fixed_t dist1, dist2 = 0;
 
 	// scan the thinkers to find the closest axis point
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_AXIS); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (closestaxis == NULL)
 		{
-			if (closestaxis == NULL)
+			closestaxis = mo2;
+			dist2 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
+		}
+		else
+		{
+			dist1 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
+
+			if (dist1 < dist2)
 			{
 				closestaxis = mo2;
-				dist2 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
-			}
-			else
-			{
-				dist1 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
-
-				if (dist1 < dist2)
-				{
-					closestaxis = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -9572,6 +9710,8 @@ static boolean P_MobjRegularThink(mobj_t *mobj)
 			P_NightsItemChase(mobj);
 		else
 			A_AttractChase(mobj);
+		if (!P_MobjWasRemoved(mobj))
+			P_ParkCollectible(mobj);
 		return false;
 		// Flung items
 	case MT_FLINGRING:
@@ -10026,6 +10166,35 @@ void P_MobjThinker(mobj_t *mobj)
 	if (mobj->flags & MF_NOTHINK)
 		return;
 
+	if (mobj->eflags & MFE_PARKED)
+	{
+		// On a match, A_AttractChase finds the same player again
+		if (P_CollectibleStaysParked(mobj) && !P_LookForShield(mobj))
+		{
+			tmfloorthing = tmhitthing = NULL;
+			P_CycleStateAnimation(mobj);
+			P_QueueParkedCollectible(mobj);
+			return;
+		}
+		mobj->eflags &= ~MFE_PARKED;
+	}
+
+	// Dormant mobjs sleep when no player is near, unless they aren't in the
+	// blockmap, where P_WakeDormantMobjs could never find them again.
+	if ((mobj->flags & (MF_DORMANT|MF_NOBLOCKMAP)) == MF_DORMANT && cv_dormancy.value)
+	{
+		if (mobj->eflags & MFE_DORMANT)
+			return;
+		if (!(mobj->eflags & MFE_STAYAWAKE))
+		{
+			mobj->eflags |= MFE_DORMANT;
+			return;
+		}
+		mobj->eflags &= ~MFE_STAYAWAKE;
+	}
+	else
+		mobj->eflags &= ~(MFE_DORMANT|MFE_STAYAWAKE);
+
 	if ((mobj->flags & MF_BOSS) && mobj->spawnpoint && (bossdisabled & (1<<mobj->spawnpoint->extrainfo)))
 		return;
 
@@ -10039,6 +10208,10 @@ void P_MobjThinker(mobj_t *mobj)
 	if (mobj->hprev && P_MobjWasRemoved(mobj->hprev))
 		P_SetTarget(&mobj->hprev, NULL);
 
+	// Whatever we're after has to keep moving too.
+	P_KeepAwake(mobj->target);
+	P_KeepAwake(mobj->tracer);
+
 	mobj->eflags &= ~(MFE_PUSHED|MFE_SPRUNG);
 
 	tmfloorthing = tmhitthing = NULL;
@@ -10451,6 +10624,600 @@ static fixed_t P_DefaultMobjShadowScale (mobj_t *thing)
 	}
 }
 
+//
+// Stored collectibles
+//
+// A parked collectible that is nowhere near a player is turned into a
+// collectible_t, keeping only what P_CollectibleToMobj can't work out
+// from its type, its state and the tic it was stored on, and is linked
+// into its sector and block instead of the thinker list. Anything that
+// could touch one brings it back as a real mobj first: a player moving
+// close by, an attraction shield, a moving sector or polyobject, a map
+// reload, objectplace or Lua. Nothing else about the game changes.
+//
+// While stored, they keep looking for attraction shields the way parked
+// ones do, see P_StepCollectibleLook.
+//
+
+collectible_t *storedcollectibles = NULL;
+size_t numstoredcollectibles = 0;
+
+static size_t storedcount[NUMMOBJTYPES];
+
+// Counts up once per tic, right after the thinkers run
+static tic_t collectibletics;
+
+// What each stored lastlook has become since it was stored
+static UINT8 collectiblelook[MAXPLAYERS];
+static boolean collectiblelookmoved;
+
+//
+// P_ClearCollectibles
+//
+// Forgets every stored collectible. Called when the level's memory is freed.
+//
+void P_ClearCollectibles(void)
+{
+	INT32 i;
+
+	storedcollectibles = NULL;
+	numstoredcollectibles = 0;
+	memset(storedcount, 0, sizeof (storedcount));
+	collectibletics = 0;
+
+	for (i = 0; i < MAXPLAYERS; i++)
+		collectiblelook[i] = (UINT8)i;
+	collectiblelookmoved = false;
+
+	numparkedqueue = 0; // their mobjs are gone already
+}
+
+//
+// P_StepCollectibleLook
+//
+// Moves every stored lastlook on by one tic of P_LookForShield finding
+// nobody. No player with an attraction shield is ever near a stored
+// collectible, so where it stops only depends on who is in the game.
+//
+static void P_StepCollectibleLook(void)
+{
+	UINT8 next[MAXPLAYERS];
+	INT32 i, j, c;
+
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		const INT32 stop = (i - 1) & PLAYERSMASK;
+
+		for (j = i, c = 0; j != stop; j = (j + 1) & PLAYERSMASK)
+			if (playeringame[j] && c++ == 2)
+				break;
+
+		next[i] = (UINT8)j;
+	}
+
+	for (i = 0; i < MAXPLAYERS; i++)
+		collectiblelook[i] = next[collectiblelook[i]];
+	collectiblelookmoved = true;
+}
+
+// Writes collectiblelook into the stored collectibles, so new ones
+// can be stored with their lastlook as it is.
+static void P_FlattenCollectibleLook(void)
+{
+	collectible_t *rec;
+	INT32 i;
+
+	if (!collectiblelookmoved)
+		return;
+
+	for (rec = storedcollectibles; rec; rec = rec->next)
+		rec->lastlook = collectiblelook[rec->lastlook];
+
+	for (i = 0; i < MAXPLAYERS; i++)
+		collectiblelook[i] = (UINT8)i;
+	collectiblelookmoved = false;
+}
+
+//
+// P_AdvanceCollectibleAnimation
+//
+// Does what that many calls to P_CycleStateAnimation would have done.
+// P_CollectibleStorable makes sure the animation is one this works for.
+//
+static void P_AdvanceCollectibleAnimation(mobj_t *mobj, tic_t tics)
+{
+	const UINT32 period = (UINT32)mobj->state->var2;
+	const UINT32 length = ((UINT32)mobj->state->var1 + 1) * period;
+	const UINT32 base = mobj->state->frame & FF_FRAMEMASK;
+	UINT32 phase;
+
+	if (!tics || !(mobj->frame & FF_ANIMATE))
+		return;
+
+	phase = ((mobj->frame & FF_FRAMEMASK) - base) * period + (period - mobj->anim_duration);
+	phase = (phase + tics % length) % length;
+
+	mobj->frame = (mobj->frame & ~FF_FRAMEMASK) | (base + phase / period);
+	mobj->anim_duration = (UINT16)(period - phase % period);
+}
+
+static void P_FillCollectible(collectible_t *rec, const mobj_t *mobj)
+{
+	P_FlattenCollectibleLook();
+
+	rec->subsector = mobj->subsector;
+	rec->floorrover = mobj->floorrover;
+	rec->ceilingrover = mobj->ceilingrover;
+	rec->spawnpoint = mobj->spawnpoint;
+
+	rec->x = mobj->x;
+	rec->y = mobj->y;
+	rec->z = mobj->z;
+	rec->radius = mobj->radius;
+	rec->height = mobj->height;
+	rec->floorz = mobj->floorz;
+	rec->ceilingz = mobj->ceilingz;
+	rec->scale = mobj->scale;
+	rec->angle = mobj->angle;
+	rec->flags = mobj->flags;
+	rec->flags2 = mobj->flags2;
+	rec->frame = mobj->frame;
+	rec->stamp = collectibletics;
+
+	rec->type = (UINT16)mobj->type;
+	rec->state = (UINT16)(mobj->state - states);
+	rec->eflags = mobj->eflags;
+	rec->color = mobj->color;
+	rec->anim_duration = mobj->anim_duration;
+	rec->lastlook = (UINT8)mobj->lastlook;
+	rec->ownsspawnpoint = (mobj->spawnpoint && mobj->spawnpoint->mobj == mobj);
+}
+
+//
+// P_CollectibleToMobj
+//
+// Fills in a mobj the way the stored collectible would be now,
+// without linking it anywhere.
+//
+void P_CollectibleToMobj(mobj_t *mobj, const collectible_t *rec)
+{
+	memset(mobj, 0, sizeof (*mobj));
+
+	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
+
+	mobj->x = rec->x;
+	mobj->y = rec->y;
+	mobj->z = rec->z;
+	mobj->radius = rec->radius;
+	mobj->height = rec->height;
+	mobj->flags = rec->flags;
+	mobj->floorz = rec->floorz;
+	mobj->ceilingz = rec->ceilingz;
+	mobj->subsector = rec->subsector;
+
+	mobj->state = &states[rec->state];
+	mobj->tics = -1;
+	mobj->angle = rec->angle;
+	mobj->sprite = mobj->state->sprite;
+	mobj->frame = rec->frame;
+	mobj->anim_duration = rec->anim_duration;
+	P_AdvanceCollectibleAnimation(mobj, collectibletics - rec->stamp);
+	mobj->floorrover = rec->floorrover;
+	mobj->ceilingrover = rec->ceilingrover;
+
+	mobj->info = &mobjinfo[rec->type];
+	mobj->type = rec->type;
+	mobj->flags2 = rec->flags2;
+	mobj->eflags = rec->eflags;
+	mobj->health = (mobj->info->spawnhealth ? mobj->info->spawnhealth : 1);
+	mobj->scale = rec->scale;
+	mobj->friction = ORIG_FRICTION;
+	mobj->movefactor = FRACUNIT;
+	mobj->color = rec->color;
+	mobj->shadowscale = P_DefaultMobjShadowScale(mobj);
+
+	mobj->reactiontime = mobj->info->reactiontime;
+	mobj->lastlook = collectiblelook[rec->lastlook];
+	mobj->spawnpoint = rec->spawnpoint;
+	mobj->watertop = INT32_MAX;
+	mobj->destscale = rec->scale;
+	mobj->scalespeed = FRACUNIT/12;
+}
+
+//
+// P_CollectibleStorable
+//
+// Checks that a parked collectible can be stored, and brought back
+// later without anything about it having changed.
+//
+static boolean P_CollectibleStorable(mobj_t *mobj)
+{
+	static mobj_t check;
+	collectible_t rec;
+	const state_t *st = mobj->state;
+	const msecnode_t *node = mobj->touching_sectorlist;
+	const sector_t *sec = mobj->subsector->sector;
+	INT32 i;
+
+	if (!(mobj->eflags & MFE_PARKED) || !P_CollectibleStaysParked(mobj)
+		|| mobj->thinker.references || !mobj->bprev
+		|| mobj->player || mobj->skin || mobj->sprite == SPR_PLAY
+		|| (mobj->flags & (MF_NOGRAVITY|MF_NOBLOCKMAP|MF_NOSECTOR)) != MF_NOGRAVITY
+		|| (mobj->flags2 & MF2_INVERTAIMABLE)
+		|| mobj->lastlook < 0 || mobj->lastlook >= MAXPLAYERS)
+		return false;
+
+	// Only in one sector, and not one that is moving already
+	if (!node || node->m_sectorlist_next || node->m_sector != sec
+		|| sec->floordata || sec->ceilingdata)
+		return false;
+
+	if ((mobj->frame & FF_ANIMATE)
+		&& (st->var1 < 0 || st->var2 < 1 || st->var2 > UINT16_MAX
+		|| (st->frame & FF_FRAMEMASK) + (UINT32)st->var1 >= FF_FRAMEMASK
+		|| (mobj->frame & FF_FRAMEMASK) < (st->frame & FF_FRAMEMASK)
+		|| (mobj->frame & FF_FRAMEMASK) - (st->frame & FF_FRAMEMASK) > (UINT32)st->var1
+		|| !mobj->anim_duration || mobj->anim_duration > st->var2))
+		return false;
+
+	// Leave some room, or they would be stored and brought back all the time
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		mobj_t *mo = players[i].mo;
+
+		if (!playeringame[i] || !mo || P_MobjWasRemoved(mo))
+			continue;
+
+		if (P_AproxDistance(mobj->x - mo->x, mobj->y - mo->y) <= (INT64)P_CollectibleWakeDist(mo) + MAPBLOCKSIZE)
+			return false;
+	}
+
+	// Anything else that is different from how it would come back?
+	P_FillCollectible(&rec, mobj);
+	P_CollectibleToMobj(&check, &rec);
+
+	check.thinker = mobj->thinker;
+	check.snext = mobj->snext;
+	check.sprev = mobj->sprev;
+	check.touching_sectorlist = mobj->touching_sectorlist;
+	check.bnext = mobj->bnext;
+	check.bprev = mobj->bprev;
+	check.typenext = mobj->typenext;
+	check.typeprev = mobj->typeprev;
+	check.typeseq = mobj->typeseq;
+	check.mobjnum = mobj->mobjnum;
+
+	return !memcmp(&check, mobj, sizeof (check));
+}
+
+//
+// P_AddCollectible
+//
+// Stores a copy of a mobj, which is left alone.
+//
+collectible_t *P_AddCollectible(const mobj_t *mobj)
+{
+	collectible_t *rec = Z_PoolMalloc(collectiblepool, PU_LEVEL, NULL);
+
+	P_FillCollectible(rec, mobj);
+
+	if ((rec->next = storedcollectibles) != NULL)
+		rec->next->prev = &rec->next;
+	rec->prev = &storedcollectibles;
+	storedcollectibles = rec;
+
+	P_SetCollectiblePosition(rec);
+
+	numstoredcollectibles++;
+	storedcount[rec->type]++;
+	return rec;
+}
+
+static void P_RemoveCollectible(collectible_t *rec)
+{
+	if ((*rec->prev = rec->next) != NULL)
+		rec->next->prev = rec->prev;
+
+	P_UnsetCollectiblePosition(rec);
+
+	numstoredcollectibles--;
+	storedcount[rec->type]--;
+	Z_Free(rec);
+}
+
+//
+// P_StoreCollectible
+//
+// Replaces a mobj with a stored collectible.
+//
+static void P_StoreCollectible(mobj_t *mobj)
+{
+	if (P_AddCollectible(mobj)->ownsspawnpoint)
+		mobj->spawnpoint->mobj = NULL;
+
+	P_RemoveSavegameMobj(mobj);
+}
+
+//
+// P_PromoteCollectible
+//
+// Turns a stored collectible back into a mobj, which is added to the
+// end of the thinker list. Whatever is running at the time isn't
+// disturbed, see P_SetPromotedThingPosition.
+//
+static void P_PromoteCollectible(collectible_t *rec)
+{
+	mobj_t *mobj = Z_PoolMalloc(mobjpool, PU_LEVEL, NULL);
+
+	P_CollectibleToMobj(mobj, rec);
+	if (rec->ownsspawnpoint && !rec->spawnpoint->mobj)
+		rec->spawnpoint->mobj = mobj;
+	P_RemoveCollectible(rec);
+
+	P_SetPromotedThingPosition(mobj);
+	P_AddThinker(THINK_MOBJ, &mobj->thinker);
+	P_LinkMobjType(mobj);
+}
+
+//
+// P_StoreParkedCollectibles
+//
+// Called right after the thinkers run.
+//
+void P_StoreParkedCollectibles(void)
+{
+	size_t i;
+
+	// The stored ones looked for shields this tic too
+	if (numstoredcollectibles)
+		P_StepCollectibleLook();
+
+	collectibletics++;
+
+	for (i = 0; i < numparkedqueue; i++)
+	{
+		mobj_t *mobj = parkedqueue[i];
+
+		P_SetTarget(&parkedqueue[i], NULL);
+		if (!P_MobjWasRemoved(mobj) && P_CollectibleStorable(mobj))
+			P_StoreCollectible(mobj);
+	}
+
+	numparkedqueue = 0;
+}
+
+//
+// P_PromoteCollectiblesInBlocks
+//
+// Brings back every stored collectible in a range of blockmap cells.
+//
+void P_PromoteCollectiblesInBlocks(INT32 xl, INT32 xh, INT32 yl, INT32 yh)
+{
+	INT32 bx, by;
+
+	if (!numstoredcollectibles)
+		return;
+
+	xl = max(xl, 0);
+	yl = max(yl, 0);
+	xh = min(xh, bmapwidth - 1);
+	yh = min(yh, bmapheight - 1);
+
+	for (by = yl; by <= yh; by++)
+		for (bx = xl; bx <= xh; bx++)
+			while (collectibleblocklinks[by*bmapwidth + bx])
+				P_PromoteCollectible(collectibleblocklinks[by*bmapwidth + bx]);
+}
+
+//
+// P_PromoteCollectiblesInRange
+//
+// Brings back every stored collectible in the blockmap cells
+// within range of a point.
+//
+void P_PromoteCollectiblesInRange(fixed_t x, fixed_t y, fixed_t range)
+{
+	if (!numstoredcollectibles)
+		return;
+
+	P_PromoteCollectiblesInBlocks(
+		(INT32)(((INT64)x - range - bmaporgx) >> MAPBLOCKSHIFT),
+		(INT32)(((INT64)x + range - bmaporgx) >> MAPBLOCKSHIFT),
+		(INT32)(((INT64)y - range - bmaporgy) >> MAPBLOCKSHIFT),
+		(INT32)(((INT64)y + range - bmaporgy) >> MAPBLOCKSHIFT));
+}
+
+//
+// P_PromoteTouchableCollectibles
+//
+// Brings back whatever a player moving to x, y could touch or pull in.
+// Called by P_CheckPosition.
+//
+void P_PromoteTouchableCollectibles(mobj_t *thing, fixed_t x, fixed_t y)
+{
+	fixed_t range = thing->radius + MAXRADIUS;
+
+	if (!numstoredcollectibles)
+		return;
+
+	if (thing->player->powers[pw_shield] & SH_PROTECTELECTRIC)
+		range = max(range, P_CollectibleWakeDist(thing));
+
+	P_PromoteCollectiblesInRange(x, y, range);
+}
+
+//
+// P_PromoteSectorCollectibles
+//
+void P_PromoteSectorCollectibles(sector_t *sector)
+{
+	while (sector->collectiblelist)
+		P_PromoteCollectible(sector->collectiblelist);
+}
+
+//
+// P_PromoteAllCollectibles
+//
+void P_PromoteAllCollectibles(void)
+{
+	while (storedcollectibles)
+		P_PromoteCollectible(storedcollectibles);
+}
+
+//
+// Per-type mobj lists
+//
+// Every mobj in the THINK_MOBJ thinker list is also linked into a list of
+// all live mobjs of its type, in the same order as the thinker list, so
+// code looking for one kind of object doesn't have to walk every mobj in
+// the level. Removed mobjs are unlinked immediately, but keep their
+// typenext pointer so a loop that removes the mobj it's on can carry on.
+// That means a walk can still land on a mobj something else removed during
+// the walk, so loops that can kill or remove things must check
+// P_MobjWasRemoved. Changing a mobj's type (P_SetMobjType) while walking
+// its list is unsupported, as the walk would carry on in the new type's list.
+//
+typedef struct
+{
+	mobj_t *first, *last;
+	size_t count;
+} mobjtypelist_t;
+
+static mobjtypelist_t mobjtypelists[NUMMOBJTYPES];
+static UINT32 mobjtypeseq;
+
+void P_ClearMobjTypeLists(void)
+{
+	memset(mobjtypelists, 0, sizeof (mobjtypelists));
+	mobjtypeseq = 0;
+}
+
+// Inserts a mobj into its type's list, after every mobj that started thinking before it.
+static void P_InsertMobjType(mobj_t *mobj)
+{
+	mobjtypelist_t *list = &mobjtypelists[mobj->type];
+	mobj_t *prev = list->last;
+
+	while (prev && prev->typeseq > mobj->typeseq)
+		prev = prev->typeprev;
+
+	mobj->typeprev = prev;
+	if (prev)
+	{
+		mobj->typenext = prev->typenext;
+		prev->typenext = mobj;
+	}
+	else
+	{
+		mobj->typenext = list->first;
+		list->first = mobj;
+	}
+
+	if (mobj->typenext)
+		mobj->typenext->typeprev = mobj;
+	else
+		list->last = mobj;
+
+	list->count++;
+}
+
+// Takes a mobj out of its type's list, without forgetting where it was.
+static void P_RemoveMobjType(mobj_t *mobj)
+{
+	mobjtypelist_t *list = &mobjtypelists[mobj->type];
+
+	if (mobj->typeprev)
+		mobj->typeprev->typenext = mobj->typenext;
+	else
+		list->first = mobj->typenext;
+
+	if (mobj->typenext)
+		mobj->typenext->typeprev = mobj->typeprev;
+	else
+		list->last = mobj->typeprev;
+
+	list->count--;
+}
+
+//
+// P_LinkMobjType
+//
+// Call right after adding a mobj to the THINK_MOBJ thinker list.
+//
+void P_LinkMobjType(mobj_t *mobj)
+{
+	if (mobj->typeseq)
+		return;
+
+	mobj->typeseq = ++mobjtypeseq;
+	P_InsertMobjType(mobj);
+}
+
+//
+// P_UnlinkMobjType
+//
+void P_UnlinkMobjType(mobj_t *mobj)
+{
+	if (!mobj->typeseq)
+		return;
+
+	P_RemoveMobjType(mobj);
+	mobj->typeseq = 0;
+}
+
+//
+// P_SetMobjType
+//
+// Changes the type of a mobj, moving it into the list for its new type.
+//
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type)
+{
+	if (mobj->typeseq)
+		P_RemoveMobjType(mobj);
+
+	mobj->type = type;
+	mobj->info = &mobjinfo[type];
+
+	if (mobj->typeseq)
+		P_InsertMobjType(mobj);
+}
+
+//
+// P_FirstMobjOfType
+//
+// Returns the first live mobj of a type, or NULL if there are none.
+// Use mobj->typenext to get the rest, and don't retype mobjs mid-walk.
+//
+mobj_t *P_FirstMobjOfType(mobjtype_t type)
+{
+	if ((size_t)type >= NUMMOBJTYPES) // Bad var1 in an action?
+		return NULL;
+
+	if (storedcount[type])
+	{
+		collectible_t *rec, *next;
+
+		for (rec = storedcollectibles; rec; rec = next)
+		{
+			next = rec->next;
+			if (rec->type == type)
+				P_PromoteCollectible(rec);
+		}
+	}
+
+	return mobjtypelists[type].first;
+}
+
+//
+// P_CountMobjsOfType
+//
+size_t P_CountMobjsOfType(mobjtype_t type)
+{
+	if ((size_t)type >= NUMMOBJTYPES)
+		return 0;
+	return mobjtypelists[type].count + storedcount[type];
+}
+
 //
 // P_SpawnMobj
 //
@@ -10459,7 +11226,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	const mobjinfo_t *info = &mobjinfo[type];
 	SINT8 sc = -1;
 	state_t *st;
-	mobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	mobj_t *mobj = Z_PoolCalloc(mobjpool, PU_LEVEL, NULL);
 
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
@@ -10472,6 +11239,8 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	mobj->radius = info->radius;
 	mobj->height = info->height;
 	mobj->flags = info->flags;
+	if (mobj->flags & MF_DORMANT)
+		mobj->eflags = MFE_STAYAWAKE; // get one tic of thinking in before we can sleep
 
 	mobj->health = (info->spawnhealth ? info->spawnhealth : 1);
 
@@ -10802,7 +11571,10 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	}
 
 	if (!(mobj->flags & MF_NOTHINK))
+	{
 		P_AddThinker(THINK_MOBJ, &mobj->thinker);
+		P_LinkMobjType(mobj);
+	}
 
 	if (mobj->skin) // correct inadequecies above.
 	{
@@ -10843,7 +11615,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
 	state_t *st;
-	precipmobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	precipmobj_t *mobj = Z_PoolCalloc(precipmobjpool, PU_LEVEL, NULL);
 	fixed_t starting_floorz;
 
 	mobj->x = x;
@@ -10918,6 +11690,8 @@ void P_RemoveMobj(mobj_t *mobj)
 	if (P_MobjWasRemoved(mobj))
 		return; // something already removing this mobj.
 
+	P_UnlinkMobjType(mobj);
+
 	mobj->thinker.function.acp1 = (actionf_p1)P_RemoveThinkerDelayed; // shh. no recursing.
 	LUAh_MobjRemoved(mobj);
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker; // needed for P_UnsetThingPosition, etc. to work.
@@ -11029,6 +11803,8 @@ void P_RemovePrecipMobj(precipmobj_t *mobj)
 // Clearing out stuff for savegames
 void P_RemoveSavegameMobj(mobj_t *mobj)
 {
+	P_UnlinkMobjType(mobj);
+
 	// unlink from sector and block lists
 	P_UnsetThingPosition(mobj);
 
@@ -11051,6 +11827,9 @@ consvar_t cv_itemrespawntime = {"respawnitemtime", "30", CV_NETVAR|CV_CHEAT, res
 consvar_t cv_itemrespawn = {"respawnitem", "On", CV_NETVAR, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 static CV_PossibleValue_t flagtime_cons_t[] = {{0, "MIN"}, {300, "MAX"}, {0, NULL}};
 consvar_t cv_flagtime = {"flagtime", "30", CV_NETVAR|CV_CHEAT, flagtime_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+static CV_PossibleValue_t dormancydist_cons_t[] = {{256, "MIN"}, {16384, "MAX"}, {0, NULL}};
+consvar_t cv_dormancy = {"dormancy", "On", CV_NETVAR, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_dormancydist = {"dormancydist", "4096", CV_NETVAR, dormancydist_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 void P_SpawnPrecipitation(void)
 {
@@ -159,7 +159,9 @@ typedef enum
 	MF_GRENADEBOUNCE    = 1<<28,
 	// Run the action thinker on spawn.
 	MF_RUNSPAWNFUNC     = 1<<29,
-	// free: 1<<30 and 1<<31
+	// Thinker sleeps while no player is near. See P_WakeDormantMobjs.
+	MF_DORMANT          = 1<<30,
+	// free: 1<<31
 } mobjflag_t;
 
 typedef enum
@@ -244,6 +246,14 @@ typedef enum
 	// Compute and trigger on mobj angle relative to tracer
 	// See Linedef Exec 457 (Track mobj angle to point)
 	MFE_TRACERANGLE       = 1<<11,
+	// Idle collectible, only animated until something disturbs it
+	// See P_ParkCollectible
+	MFE_PARKED            = 1<<12,
+	// Thinker is asleep, a player is needed nearby to wake it
+	// See P_WakeDormantMobjs
+	MFE_DORMANT           = 1<<13,
+	// A player is near or something is chasing it, so stay awake this tic
+	MFE_STAYAWAKE         = 1<<14,
 	// free: to and including 1<<15
 } mobjeflag_t;
 
@@ -265,6 +275,14 @@ typedef enum {
 	PCF_THUNK = 32,
 } precipflag_t;
 // Map Object definition.
+//
+// The fields are grouped by how often they are touched, so that
+// P_CheckPosition and the blockmap/sector walks pull in as few cache
+// lines per object as possible: first what every collision test reads
+// (position, size, flags, momentum), then the links and floor/ceiling
+// info used by movement, then what the renderer and P_MobjThinker need,
+// and last the rarely read bookkeeping.
+// The block up to ceilingrover is shared with precipmobj_t below.
 typedef struct mobj_s
 {
 	// List: thinker links.
@@ -273,91 +291,105 @@ typedef struct mobj_s
 	// Info for drawing: position.
 	fixed_t x, y, z;
 
+	// For movement checking.
+	fixed_t radius;
+	fixed_t height;
+
+	UINT32 flags; // flags from mobjinfo tables
+
+	// Momentums, used to update position.
+	fixed_t momx, momy, momz;
+	fixed_t pmomz; // If you're on a moving floor, its "momz" would be here
+
+	// The closest interval over all contacted sectors (or things).
+	fixed_t floorz; // Nearest floor below.
+	fixed_t ceilingz; // Nearest ceiling above.
+
+	struct subsector_s *subsector; // Subsector the mobj resides in.
+
 	// More list: links in sector (if needed)
 	struct mobj_s *snext;
 	struct mobj_s **sprev; // killough 8/11/98: change to ptr-to-ptr
 
+	state_t *state;
+	struct msecnode_s *touching_sectorlist; // a linked list of sectors where this object appears
+	INT32 tics; // state tic counter
+
 	// More drawing info: to determine current sprite.
 	angle_t angle, pitch, roll; // orientation
 	angle_t rollangle;
 	spritenum_t sprite; // used to find patch_t and flip value
 	UINT32 frame; // frame number, plus bits see p_pspr.h
-	UINT8 sprite2; // player sprites
 	UINT16 anim_duration; // for FF_ANIMATE states
+	UINT8 sprite2; // player sprites
 
-	struct msecnode_s *touching_sectorlist; // a linked list of sectors where this object appears
-
-	struct subsector_s *subsector; // Subsector the mobj resides in.
-
-	// The closest interval over all contacted sectors (or things).
-	fixed_t floorz; // Nearest floor below.
-	fixed_t ceilingz; // Nearest ceiling above.
 	struct ffloor_s *floorrover; // FOF referred by floorz
 	struct ffloor_s *ceilingrover; // FOF referred by ceilingz
 
-	// For movement checking.
-	fixed_t radius;
-	fixed_t height;
+	// Interaction info, by BLOCKMAP.
+	// Links in blocks (if needed).
+	struct mobj_s *bnext;
+	struct mobj_s **bprev; // killough 8/11/98: change to ptr-to-ptr
 
-	// Momentums, used to update position.
-	fixed_t momx, momy, momz;
-	fixed_t pmomz; // If you're on a moving floor, its "momz" would be here
+	// Additional info record for player avatars only.
+	// Only valid if type == MT_PLAYER
+	struct player_s *player;
 
-	INT32 tics; // state tic counter
-	state_t *state;
-	UINT32 flags; // flags from mobjinfo tables
+	const mobjinfo_t *info; // &mobjinfo[mobj->type]
+
+	struct mobj_s *target; // Thing being chased/attacked (or NULL), and originator for missiles.
+	struct mobj_s *tracer; // Thing being chased/attacked for tracers.
+
+	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
+
+	mobjtype_t type;
 	UINT32 flags2; // MF2_ flags
 	UINT16 eflags; // extra flags
 
+	INT32 health; // for player this is rings + 1 -- no it isn't, not any more!!
+
+	fixed_t scale;
+	fixed_t friction;
+	fixed_t movefactor;
+
+	// Everything below is only read by specific objects and actions.
+
 	void *skin; // overrides 'sprite' when non-NULL (for player bodies to 'remember' the skin)
 	// Player and mobj sprites in multiplayer modes are modified
 	//  using an internal color lookup table for re-indexing.
 	UINT16 color; // This replaces MF_TRANSLATION. Use 0 for default (no translation).
 
-	// Interaction info, by BLOCKMAP.
-	// Links in blocks (if needed).
-	struct mobj_s *bnext;
-	struct mobj_s **bprev; // killough 8/11/98: change to ptr-to-ptr
+	boolean colorized; // Whether the mobj uses the rainbow colormap
+	boolean mirrored; // The object's rotations will be mirrored left to right, e.g., see frame AL from the right and AR from the left
+	fixed_t shadowscale; // If this object casts a shadow, and the size relative to radius
 
 	// Additional pointers for NiGHTS hoops
 	struct mobj_s *hnext;
 	struct mobj_s *hprev;
 
-	mobjtype_t type;
-	const mobjinfo_t *info; // &mobjinfo[mobj->type]
-
-	INT32 health; // for player this is rings + 1 -- no it isn't, not any more!!
+	// Links in the list of live mobjs of the same type (see P_FirstMobjOfType)
+	struct mobj_s *typenext;
+	struct mobj_s *typeprev;
+	UINT32 typeseq; // Order the mobj started thinking in, or 0 if not in a type list
 
 	// Movement direction, movement generation (zig-zagging).
 	angle_t movedir; // dirtype_t 0-7; also used by Deton for up/down angle
 	INT32 movecount; // when 0, select a new dir
 
-	struct mobj_s *target; // Thing being chased/attacked (or NULL), and originator for missiles.
-
 	INT32 reactiontime; // If not 0, don't attack yet.
 
 	INT32 threshold; // If >0, the target will be chased no matter what.
 
-	// Additional info record for player avatars only.
-	// Only valid if type == MT_PLAYER
-	struct player_s *player;
-
 	INT32 lastlook; // Player number last looked for.
 
 	mapthing_t *spawnpoint; // Used for CTF flags, objectplace, and a handful other applications.
 
-	struct mobj_s *tracer; // Thing being chased/attacked for tracers.
-
-	fixed_t friction;
-	fixed_t movefactor;
-
 	INT32 fuse; // Does something in P_MobjThinker on reaching 0.
 	fixed_t watertop; // top of the water FOF the mobj is in
 	fixed_t waterbottom; // bottom of the water FOF the mobj is in
 
 	UINT32 mobjnum; // A unique number for this mobj. Used for restoring pointers on save games.
 
-	fixed_t scale;
 	fixed_t destscale;
 	fixed_t scalespeed;
 
@@ -370,12 +402,6 @@ typedef struct mobj_s
 	INT32 cusval;
 	INT32 cvmem;
 
-	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
-
-	boolean colorized; // Whether the mobj uses the rainbow colormap
-	boolean mirrored; // The object's rotations will be mirrored left to right, e.g., see frame AL from the right and AR from the left
-	fixed_t shadowscale; // If this object casts a shadow, and the size relative to radius
-
 	// WARNING: New fields must be added separately to savegame and Lua.
 } mobj_t;
 
@@ -394,40 +420,78 @@ typedef struct precipmobj_s
 	// Info for drawing: position.
 	fixed_t x, y, z;
 
+	// For movement checking.
+	fixed_t radius; // Fixed at 2*FRACUNIT
+	fixed_t height; // Fixed at 4*FRACUNIT
+
+	INT32 flags; // flags from mobjinfo tables
+
+	// Momentums, used to update position.
+	fixed_t momx, momy, momz;
+	fixed_t precipflags; // fixed_t so it uses the same spot as "pmomz" even as we use precipflags_t for it
+
+	// The closest interval over all contacted sectors (or things).
+	fixed_t floorz; // Nearest floor below.
+	fixed_t ceilingz; // Nearest ceiling above.
+
+	struct subsector_s *subsector; // Subsector the mobj resides in.
+
 	// More list: links in sector (if needed)
 	struct precipmobj_s *snext;
 	struct precipmobj_s **sprev; // killough 8/11/98: change to ptr-to-ptr
 
+	state_t *state;
+	struct mprecipsecnode_s *touching_sectorlist; // a linked list of sectors where this object appears
+	INT32 tics; // state tic counter
+
 	// More drawing info: to determine current sprite.
 	angle_t angle, pitch, roll;  // orientation
 	angle_t rollangle;
 	spritenum_t sprite; // used to find patch_t and flip value
 	UINT32 frame; // frame number, plus bits see p_pspr.h
-	UINT8 sprite2; // player sprites
 	UINT16 anim_duration; // for FF_ANIMATE states
+	UINT8 sprite2; // player sprites
 
-	struct mprecipsecnode_s *touching_sectorlist; // a linked list of sectors where this object appears
-
-	struct subsector_s *subsector; // Subsector the mobj resides in.
-
-	// The closest interval over all contacted sectors (or things).
-	fixed_t floorz; // Nearest floor below.
-	fixed_t ceilingz; // Nearest ceiling above.
 	struct ffloor_s *floorrover; // FOF referred by floorz
 	struct ffloor_s *ceilingrover; // FOF referred by ceilingz
+} precipmobj_t;
 
-	// For movement checking.
-	fixed_t radius; // Fixed at 2*FRACUNIT
-	fixed_t height; // Fixed at 4*FRACUNIT
+// A parked collectible that has been taken out of the thinker list,
+// keeping only what isn't the same for every such object of its type.
+// See P_StoreCollectible
+typedef struct collectible_s
+{
+	// Links in the list of all stored collectibles, newest first
+	struct collectible_s *next;
+	struct collectible_s **prev;
 
-	// Momentums, used to update position.
-	fixed_t momx, momy, momz;
-	fixed_t precipflags; // fixed_t so it uses the same spot as "pmomz" even as we use precipflags_t for it
+	// Links in sector and block, newest first
+	struct collectible_s *snext;
+	struct collectible_s **sprev;
+	struct collectible_s *bnext;
+	struct collectible_s **bprev;
 
-	INT32 tics; // state tic counter
-	state_t *state;
-	INT32 flags; // flags from mobjinfo tables
-} precipmobj_t;
+	struct subsector_s *subsector;
+	struct ffloor_s *floorrover;
+	struct ffloor_s *ceilingrover;
+	mapthing_t *spawnpoint;
+
+	fixed_t x, y, z;
+	fixed_t radius, height;
+	fixed_t floorz, ceilingz;
+	fixed_t scale;
+	angle_t angle;
+	UINT32 flags, flags2;
+	UINT32 frame; // as of tic stamp
+	tic_t stamp; // collectibletics when the object was stored
+
+	UINT16 type, state;
+	UINT16 eflags;
+	UINT16 color;
+	UINT16 anim_duration; // as of tic stamp
+	UINT8 lastlook; // through collectiblelook, see P_StepCollectibleLook
+	boolean ownsspawnpoint; // spawnpoint->mobj pointed to it
+} collectible_t;
 
 typedef struct actioncache_s
 {
@@ -475,6 +539,10 @@ void P_RingXYMovement(mobj_t *mo);
 void P_SceneryXYMovement(mobj_t *mo);
 boolean P_ZMovement(mobj_t *mo);
 void P_RingZMovement(mobj_t *mo);
+void P_PromoteAttractedCollectibles(void);
+void P_PromoteCollectiblesNearShield(mobj_t *mo);
+void P_WakeParkedCollectibles(void);
+void P_WakeDormantMobjs(void);
 boolean P_SceneryZMovement(mobj_t *mo);
 void P_PlayerZMovement(mobj_t *mo);
 void P_EmeraldManager(void);
@@ -870,6 +870,10 @@ static void Polyobj_carryThings(polyobj_t *po, fixed_t dx, fixed_t dy)
 	if (!(po->flags & POF_SOLID))
 		return;
 
+	// lastlook is written to everything below, stored collectibles included
+	P_PromoteCollectiblesInBlocks(po->blockbox[BOXLEFT], po->blockbox[BOXRIGHT],
+		po->blockbox[BOXBOTTOM], po->blockbox[BOXTOP]);
+
 	for (y = po->blockbox[BOXBOTTOM]; y <= po->blockbox[BOXTOP]; ++y)
 	{
 		for (x = po->blockbox[BOXLEFT]; x <= po->blockbox[BOXRIGHT]; ++x)
@@ -1100,6 +1104,10 @@ static void Polyobj_rotateThings(polyobj_t *po, vector2_t origin, angle_t delta,
 	if (!(po->flags & POF_SOLID))
 		return;
 
+	// lastlook is written to everything below, stored collectibles included
+	P_PromoteCollectiblesInBlocks(po->blockbox[BOXLEFT], po->blockbox[BOXRIGHT],
+		po->blockbox[BOXBOTTOM], po->blockbox[BOXTOP]);
+
 	for (y = po->blockbox[BOXBOTTOM]; y <= po->blockbox[BOXTOP]; ++y)
 	{
 		for (x = po->blockbox[BOXLEFT]; x <= po->blockbox[BOXRIGHT]; ++x)
@@ -2017,7 +2025,7 @@ boolean EV_DoPolyObjRotate(polyrotdata_t *prdata)
 		return false;
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polyrotate_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polyrotate_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjRotate;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
@@ -2082,7 +2090,7 @@ boolean EV_DoPolyObjMove(polymovedata_t *pmdata)
 		return false;
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polymove_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polymove_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjMove;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
@@ -2139,7 +2147,7 @@ boolean EV_DoPolyObjWaypoint(polywaypointdata_t *pwdata)
 		return false;
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polywaypoint_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polywaypoint_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjWaypoint;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
@@ -2187,7 +2195,7 @@ static void Polyobj_doSlideDoor(polyobj_t *po, polydoordata_t *doordata)
 	INT32 start;
 
 	// allocate and add a new slide door thinker
-	th = Z_Malloc(sizeof(polyslidedoor_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polyslidedoor_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyDoorSlide;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 
@@ -2235,7 +2243,7 @@ static void Polyobj_doSwingDoor(polyobj_t *po, polydoordata_t *doordata)
 	INT32 start;
 
 	// allocate and add a new swing door thinker
-	th = Z_Malloc(sizeof(polyswingdoor_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polyswingdoor_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyDoorSwing;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 
@@ -2317,7 +2325,7 @@ boolean EV_DoPolyObjDisplace(polydisplacedata_t *prdata)
 		return false;
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polydisplace_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polydisplace_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjDisplace;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
@@ -2363,7 +2371,7 @@ boolean EV_DoPolyObjRotDisplace(polyrotdisplacedata_t *prdata)
 		return false;
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polyrotdisplace_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polyrotdisplace_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjRotDisplace;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
@@ -2464,7 +2472,7 @@ boolean EV_DoPolyObjFlag(polyflagdata_t *pfdata)
 	}
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polymove_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polymove_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjFlag;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
@@ -2614,7 +2622,7 @@ boolean EV_DoPolyObjFade(polyfadedata_t *pfdata)
 		P_RemoveThinker(po->thinker);
 
 	// create a new thinker
-	th = Z_Malloc(sizeof(polyfade_t), PU_LEVSPEC, NULL);
+	th = P_AllocThinker(sizeof(polyfade_t));
 	th->thinker.function.acp1 = (actionf_p1)T_PolyObjFade;
 	P_AddThinker(THINK_POLYOBJ, &th->thinker);
 	po->thinker = &th->thinker;
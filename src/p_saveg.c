@@ -38,6 +38,65 @@
 savedata_t savedata;
 UINT8 *save_p;
 
+static UINT8 *save_buffer = NULL;
+static size_t save_size = 0;
+static void (*save_flush)(UINT8 *data, size_t length) = NULL;
+
+// Start writing a netgame save into a new malloc'd buffer
+boolean P_SaveBufferAlloc(size_t size, void (*flush)(UINT8 *data, size_t length))
+{
+	I_Assert(size >= SAVEBLOCKSIZE);
+
+	save_p = save_buffer = malloc(size);
+	if (!save_buffer)
+		return false;
+	save_size = size;
+	save_flush = flush;
+	return true;
+}
+
+// Make sure there's room for length more bytes at save_p
+void P_SaveBufferReserve(size_t length)
+{
+	size_t used;
+
+	if (!save_buffer) // not a growable buffer, the caller sized it
+		return;
+
+	used = save_p - save_buffer;
+	if (used + length <= save_size)
+		return;
+
+	if (save_flush && used)
+	{
+		save_flush(save_buffer, used);
+		save_p = save_buffer;
+		used = 0;
+		if (length <= save_size)
+			return;
+	}
+
+	while (used + length > save_size)
+		save_size <<= 1;
+	save_buffer = realloc(save_buffer, save_size);
+	if (!save_buffer)
+		I_Error("No more free memory for savegame\n");
+	save_p = save_buffer + used;
+}
+
+// Stop writing; returns the buffer with whatever is left unflushed in it,
+// which the caller has to free
+UINT8 *P_SaveBufferRelease(size_t *length)
+{
+	UINT8 *buffer = save_buffer;
+
+	*length = save_p - save_buffer;
+	save_buffer = save_p = NULL;
+	save_size = 0;
+	save_flush = NULL;
+	return buffer;
+}
+
 // Block UINT32s to attempt to ensure that the correct data is
 // being sent and received
 #define ARCHIVEBLOCK_MISC     0x7FEEDEED
@@ -46,6 +105,7 @@ UINT8 *save_p;
 #define ARCHIVEBLOCK_POBJS    0x7F928546
 #define ARCHIVEBLOCK_THINKERS 0x7F37037C
 #define ARCHIVEBLOCK_SPECIALS 0x7F228378
+#define ARCHIVEBLOCK_COLLECTIBLES 0x7F5C011E
 
 // Note: This cannot be bigger
 // than an UINT16
@@ -101,6 +161,8 @@ static void P_NetArchivePlayers(void)
 		if (!playeringame[i])
 			continue;
 
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
+
 		flags = 0;
 
 		// no longer send ticcmds, player name, skin, or color
@@ -601,6 +663,7 @@ static void P_NetArchiveColormaps(void)
 		if (!exc)
 			exc = R_CreateDefaultColormap(false);
 
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
 		WRITEUINT8(save_p, exc->fadestart);
 		WRITEUINT8(save_p, exc->fadeend);
 		WRITEUINT8(save_p, exc->flags);
@@ -729,6 +792,7 @@ static void P_NetArchiveWaypoints(void)
 
 	for (i = 0; i < NUMWAYPOINTSEQUENCES; i++)
 	{
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
 		WRITEUINT16(save_p, numwaypoints[i]);
 		for (j = 0; j < numwaypoints[i]; j++)
 			WRITEUINT32(save_p, waypoints[i][j] ? waypoints[i][j]->mobjnum : 0);
@@ -920,6 +984,7 @@ static void ArchiveSectors(void)
 
 	for (i = 0; i < numsectors; i++, ss++, spawnss++)
 	{
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
 		diff = diff2 = diff3 = 0;
 		if (ss->floorheight != spawnss->floorheight)
 			diff |= SD_FLOORHT;
@@ -1107,6 +1172,7 @@ static void ArchiveLines(void)
 
 	for (i = 0; i < numlines; i++, spawnli++, li++)
 	{
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
 		diff = diff2 = 0;
 
 		if (li->special != spawnli->special)
@@ -2244,6 +2310,8 @@ static void P_NetArchiveThinkers(void)
 		// save off the current thinkers
 		for (th = thlist[i].next; th != &thlist[i]; th = th->next)
 		{
+			P_SaveBufferReserve(SAVEBLOCKSIZE);
+
 			if (!(th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed
 			 || th->function.acp1 == (actionf_p1)P_NullPrecipThinker))
 				numsaved++;
@@ -2468,6 +2536,40 @@ static void P_NetArchiveThinkers(void)
 	}
 }
 
+// Loaded mobjs indexed by their saved mobjnum, filled in while the thinkers
+// are unarchived so relinking pointers doesn't search the thinker list.
+// Only valid until P_LoadNetGame is done with it.
+#define MAXMOBJNUMTABLE (1<<22) // anything past this falls back to searching
+static mobj_t **mobjnumtable = NULL;
+static UINT32 mobjnumtablesize = 0;
+
+static void P_ClearMobjNumTable(void)
+{
+	if (mobjnumtable)
+		Z_Free(mobjnumtable);
+	mobjnumtable = NULL;
+	mobjnumtablesize = 0;
+}
+
+static void P_AddMobjNum(mobj_t *mobj)
+{
+	if (mobj->mobjnum >= MAXMOBJNUMTABLE)
+		return;
+
+	if (mobj->mobjnum >= mobjnumtablesize)
+	{
+		UINT32 newsize = mobjnumtablesize ? mobjnumtablesize : 1024;
+		while (newsize <= mobj->mobjnum)
+			newsize <<= 1;
+		mobjnumtable = Z_Realloc(mobjnumtable, newsize * sizeof (*mobjnumtable), PU_STATIC, NULL);
+		mobjnumtablesize = newsize;
+	}
+
+	// first one wins, like searching the list did
+	if (!mobjnumtable[mobj->mobjnum])
+		mobjnumtable[mobj->mobjnum] = mobj;
+}
+
 // Now save the pointers, tracer and target, but at load time we must
 // relink to this; the savegame contains the old position in the pointer
 // field copyed in the info field temporarily, but finally we just search
@@ -2477,6 +2579,19 @@ mobj_t *P_FindNewPosition(UINT32 oldposition)
 	thinker_t *th;
 	mobj_t *mobj;
 
+	if (oldposition < mobjnumtablesize)
+	{
+		mobj = mobjnumtable[oldposition];
+		if (!mobj)
+		{
+			CONS_Debug(DBG_GAMELOGIC, "mobj not found\n");
+			return NULL;
+		}
+		if (mobj->thinker.function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
+			return mobj;
+		// removed since it was loaded, search for another with the same number
+	}
+
 	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
@@ -2574,13 +2689,13 @@ static thinker_t* LoadMobjThinker(actionf_p1 thinker)
 			return NULL;
 		}
 
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		mobj = Z_PoolCalloc(mobjpool, PU_LEVEL, NULL);
 
 		mobj->spawnpoint = &mapthings[spawnpointnum];
 		mapthings[spawnpointnum].mobj = mobj;
 	}
 	else
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		mobj = Z_PoolCalloc(mobjpool, PU_LEVEL, NULL);
 
 	// declare this as a valid mobj as soon as possible.
 	mobj->thinker.function.acp1 = thinker;
@@ -2789,7 +2904,7 @@ static thinker_t* LoadMobjThinker(actionf_p1 thinker)
 
 static thinker_t* LoadNoEnemiesThinker(actionf_p1 thinker)
 {
-	noenemies_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	noenemies_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	return &ht->thinker;
@@ -2797,7 +2912,7 @@ static thinker_t* LoadNoEnemiesThinker(actionf_p1 thinker)
 
 static thinker_t* LoadBounceCheeseThinker(actionf_p1 thinker)
 {
-	bouncecheese_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	bouncecheese_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -2815,7 +2930,7 @@ static thinker_t* LoadBounceCheeseThinker(actionf_p1 thinker)
 
 static thinker_t* LoadContinuousFallThinker(actionf_p1 thinker)
 {
-	continuousfall_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	continuousfall_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->speed = READFIXED(save_p);
@@ -2835,7 +2950,7 @@ static thinker_t* LoadContinuousFallThinker(actionf_p1 thinker)
 
 static thinker_t* LoadMarioBlockThinker(actionf_p1 thinker)
 {
-	mariothink_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	mariothink_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->speed = READFIXED(save_p);
@@ -2855,7 +2970,7 @@ static thinker_t* LoadMarioBlockThinker(actionf_p1 thinker)
 
 static thinker_t* LoadMarioCheckThinker(actionf_p1 thinker)
 {
-	mariocheck_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	mariocheck_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -2864,7 +2979,7 @@ static thinker_t* LoadMarioCheckThinker(actionf_p1 thinker)
 
 static thinker_t* LoadThwompThinker(actionf_p1 thinker)
 {
-	thwomp_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	thwomp_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -2888,7 +3003,7 @@ static thinker_t* LoadThwompThinker(actionf_p1 thinker)
 
 static thinker_t* LoadFloatThinker(actionf_p1 thinker)
 {
-	floatthink_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	floatthink_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -2899,7 +3014,7 @@ static thinker_t* LoadFloatThinker(actionf_p1 thinker)
 static thinker_t* LoadEachTimeThinker(actionf_p1 thinker)
 {
 	size_t i;
-	eachtime_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	eachtime_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	for (i = 0; i < MAXPLAYERS; i++)
@@ -2913,7 +3028,7 @@ static thinker_t* LoadEachTimeThinker(actionf_p1 thinker)
 
 static thinker_t* LoadRaiseThinker(actionf_p1 thinker)
 {
-	raise_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	raise_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->tag = READINT16(save_p);
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -2928,7 +3043,7 @@ static thinker_t* LoadRaiseThinker(actionf_p1 thinker)
 
 static thinker_t* LoadCeilingThinker(actionf_p1 thinker)
 {
-	ceiling_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	ceiling_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->type = READUINT8(save_p);
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -2952,7 +3067,7 @@ static thinker_t* LoadCeilingThinker(actionf_p1 thinker)
 
 static thinker_t* LoadFloormoveThinker(actionf_p1 thinker)
 {
-	floormove_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	floormove_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->type = READUINT8(save_p);
 	ht->crush = READUINT8(save_p);
@@ -2971,7 +3086,7 @@ static thinker_t* LoadFloormoveThinker(actionf_p1 thinker)
 
 static thinker_t* LoadLightflashThinker(actionf_p1 thinker)
 {
-	lightflash_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	lightflash_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->maxlight = READINT32(save_p);
@@ -2983,7 +3098,7 @@ static thinker_t* LoadLightflashThinker(actionf_p1 thinker)
 
 static thinker_t* LoadStrobeThinker(actionf_p1 thinker)
 {
-	strobe_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	strobe_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->count = READINT32(save_p);
@@ -2998,7 +3113,7 @@ static thinker_t* LoadStrobeThinker(actionf_p1 thinker)
 
 static thinker_t* LoadGlowThinker(actionf_p1 thinker)
 {
-	glow_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	glow_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->minlight = READINT32(save_p);
@@ -3012,7 +3127,7 @@ static thinker_t* LoadGlowThinker(actionf_p1 thinker)
 
 static thinker_t* LoadFireflickerThinker(actionf_p1 thinker)
 {
-	fireflicker_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	fireflicker_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->count = READINT32(save_p);
@@ -3026,7 +3141,7 @@ static thinker_t* LoadFireflickerThinker(actionf_p1 thinker)
 
 static thinker_t* LoadElevatorThinker(actionf_p1 thinker, boolean setplanedata)
 {
-	elevator_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	elevator_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->type = READUINT8(save_p);
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -3056,7 +3171,7 @@ static thinker_t* LoadElevatorThinker(actionf_p1 thinker, boolean setplanedata)
 
 static thinker_t* LoadCrumbleThinker(actionf_p1 thinker)
 {
-	crumble_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	crumble_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sourceline = LoadLine(READUINT32(save_p));
 	ht->sector = LoadSector(READUINT32(save_p));
@@ -3078,7 +3193,7 @@ static thinker_t* LoadCrumbleThinker(actionf_p1 thinker)
 
 static thinker_t* LoadScrollThinker(actionf_p1 thinker)
 {
-	scroll_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	scroll_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->dx = READFIXED(save_p);
 	ht->dy = READFIXED(save_p);
@@ -3095,7 +3210,7 @@ static thinker_t* LoadScrollThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadFrictionThinker(actionf_p1 thinker)
 {
-	friction_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	friction_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->friction = READINT32(save_p);
 	ht->movefactor = READINT32(save_p);
@@ -3107,7 +3222,7 @@ static inline thinker_t* LoadFrictionThinker(actionf_p1 thinker)
 
 static thinker_t* LoadPusherThinker(actionf_p1 thinker)
 {
-	pusher_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	pusher_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->type = READUINT8(save_p);
 	ht->x_mag = READINT32(save_p);
@@ -3128,7 +3243,7 @@ static thinker_t* LoadPusherThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadLaserThinker(actionf_p1 thinker)
 {
-	laserthink_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	laserthink_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->tag = READINT16(save_p);
 	ht->sourceline = LoadLine(READUINT32(save_p));
@@ -3138,7 +3253,7 @@ static inline thinker_t* LoadLaserThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadLightlevelThinker(actionf_p1 thinker)
 {
-	lightlevel_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	lightlevel_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->sourcelevel = READINT16(save_p);
@@ -3153,7 +3268,7 @@ static inline thinker_t* LoadLightlevelThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadExecutorThinker(actionf_p1 thinker)
 {
-	executor_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	executor_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->line = LoadLine(READUINT32(save_p));
 	ht->caller = LoadMobj(READUINT32(save_p));
@@ -3164,7 +3279,7 @@ static inline thinker_t* LoadExecutorThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadDisappearThinker(actionf_p1 thinker)
 {
-	disappear_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	disappear_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->appeartime = READUINT32(save_p);
 	ht->disappeartime = READUINT32(save_p);
@@ -3179,7 +3294,7 @@ static inline thinker_t* LoadDisappearThinker(actionf_p1 thinker)
 static inline thinker_t* LoadFadeThinker(actionf_p1 thinker)
 {
 	sector_t *ss;
-	fade_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	fade_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->dest_exc = GetNetColormapFromList(READUINT32(save_p));
 	ht->sectornum = READUINT32(save_p);
@@ -3220,7 +3335,7 @@ static inline thinker_t* LoadFadeThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadFadeColormapThinker(actionf_p1 thinker)
 {
-	fadecolormap_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	fadecolormap_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->sector = LoadSector(READUINT32(save_p));
 	ht->source_exc = GetNetColormapFromList(READUINT32(save_p));
@@ -3235,7 +3350,7 @@ static inline thinker_t* LoadFadeColormapThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPlaneDisplaceThinker(actionf_p1 thinker)
 {
-	planedisplace_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	planedisplace_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 
 	ht->affectee = READINT32(save_p);
@@ -3248,7 +3363,7 @@ static inline thinker_t* LoadPlaneDisplaceThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadDynamicSlopeThinker(actionf_p1 thinker)
 {
-	dynplanethink_t* ht = Z_Malloc(sizeof(*ht), PU_LEVSPEC, NULL);
+	dynplanethink_t* ht = P_AllocThinker(sizeof(*ht));
 	ht->thinker.function.acp1 = thinker;
 
 	ht->type = READUINT8(save_p);
@@ -3262,7 +3377,7 @@ static inline thinker_t* LoadDynamicSlopeThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPolyrotatetThinker(actionf_p1 thinker)
 {
-	polyrotate_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polyrotate_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->speed = READINT32(save_p);
@@ -3273,7 +3388,7 @@ static inline thinker_t* LoadPolyrotatetThinker(actionf_p1 thinker)
 
 static thinker_t* LoadPolymoveThinker(actionf_p1 thinker)
 {
-	polymove_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polymove_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->speed = READINT32(save_p);
@@ -3286,7 +3401,7 @@ static thinker_t* LoadPolymoveThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPolywaypointThinker(actionf_p1 thinker)
 {
-	polywaypoint_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polywaypoint_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->speed = READINT32(save_p);
@@ -3301,7 +3416,7 @@ static inline thinker_t* LoadPolywaypointThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPolyslidedoorThinker(actionf_p1 thinker)
 {
-	polyslidedoor_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polyslidedoor_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->delay = READINT32(save_p);
@@ -3321,7 +3436,7 @@ static inline thinker_t* LoadPolyslidedoorThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPolyswingdoorThinker(actionf_p1 thinker)
 {
-	polyswingdoor_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polyswingdoor_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->delay = READINT32(save_p);
@@ -3336,7 +3451,7 @@ static inline thinker_t* LoadPolyswingdoorThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPolydisplaceThinker(actionf_p1 thinker)
 {
-	polydisplace_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polydisplace_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->controlSector = LoadSector(READUINT32(save_p));
@@ -3348,7 +3463,7 @@ static inline thinker_t* LoadPolydisplaceThinker(actionf_p1 thinker)
 
 static inline thinker_t* LoadPolyrotdisplaceThinker(actionf_p1 thinker)
 {
-	polyrotdisplace_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polyrotdisplace_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->controlSector = LoadSector(READUINT32(save_p));
@@ -3360,7 +3475,7 @@ static inline thinker_t* LoadPolyrotdisplaceThinker(actionf_p1 thinker)
 
 static thinker_t* LoadPolyfadeThinker(actionf_p1 thinker)
 {
-	polyfade_t *ht = Z_Malloc(sizeof (*ht), PU_LEVSPEC, NULL);
+	polyfade_t *ht = P_AllocThinker(sizeof (*ht));
 	ht->thinker.function.acp1 = thinker;
 	ht->polyObjNum = READINT32(save_p);
 	ht->sourcevalue = READINT32(save_p);
@@ -3385,6 +3500,9 @@ static void P_NetUnArchiveThinkers(void)
 	if (READUINT32(save_p) != ARCHIVEBLOCK_THINKERS)
 		I_Error("Bad $$$.sav at archive block Thinkers");
 
+	// stored collectibles left over from setting up the level go too
+	P_PromoteAllCollectibles();
+
 	// remove all the current thinkers
 	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
@@ -3403,6 +3521,7 @@ static void P_NetUnArchiveThinkers(void)
 	// we don't want the removed mobjs to come back
 	iquetail = iquehead = 0;
 	P_InitThinkers();
+	P_ClearMobjNumTable();
 
 	// clear sector thinker pointers so they don't point to non-existant thinkers for all of eternity
 	for (i = 0; i < numsectors; i++)
@@ -3592,7 +3711,14 @@ static void P_NetUnArchiveThinkers(void)
 					I_Error("P_UnarchiveSpecials: Unknown tclass %d in savegame", tclass);
 			}
 			if (th)
+			{
 				P_AddThinker(i, th);
+				if (i == THINK_MOBJ)
+				{
+					P_LinkMobjType((mobj_t *)th);
+					P_AddMobjNum((mobj_t *)th);
+				}
+			}
 		}
 
 		CONS_Debug(DBG_NETPLAY, "%u thinkers loaded in list %d\n", numloaded, i);
@@ -3688,7 +3814,10 @@ static inline void P_ArchivePolyObjects(void)
 	WRITEINT32(save_p, numPolyObjects);
 
 	for (i = 0; i < numPolyObjects; ++i)
+	{
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
 		P_ArchivePolyObj(&PolyObjects[i]);
+	}
 }
 
 static inline void P_UnArchivePolyObjects(void)
@@ -3819,6 +3948,7 @@ static inline void P_NetArchiveSpecials(void)
 {
 	size_t i, z;
 
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
 	WRITEUINT32(save_p, ARCHIVEBLOCK_SPECIALS);
 
 	// itemrespawn queue for deathmatch
@@ -3894,6 +4024,150 @@ static void P_NetUnArchiveSpecials(void)
 		G_LoadMetal(&save_p);
 }
 
+///
+/// Stored collectibles
+///
+
+#define CD_FLOORROVER   0x01
+#define CD_CEILINGROVER 0x02
+#define CD_SPAWNPOINT   0x04
+#define CD_OWNSPAWN     0x08
+
+//
+// P_NetArchiveCollectibles
+//
+// Writes them oldest first, so that loading them in order
+// links everything up the same way again.
+//
+static void P_NetArchiveCollectibles(void)
+{
+	static mobj_t mobj;
+	collectible_t **list = NULL;
+	collectible_t *rec;
+	size_t i;
+	UINT8 flags;
+
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
+	WRITEUINT32(save_p, ARCHIVEBLOCK_COLLECTIBLES);
+	WRITEUINT32(save_p, (UINT32)numstoredcollectibles);
+
+	if (!numstoredcollectibles)
+		return;
+
+	list = Z_Malloc(numstoredcollectibles * sizeof (*list), PU_STATIC, NULL);
+	for (i = numstoredcollectibles, rec = storedcollectibles; rec; rec = rec->next)
+		list[--i] = rec;
+
+	for (i = 0; i < numstoredcollectibles; i++)
+	{
+		rec = list[i];
+		P_CollectibleToMobj(&mobj, rec);
+
+		P_SaveBufferReserve(SAVEBLOCKSIZE);
+		WRITEUINT16(save_p, mobj.type);
+		WRITEUINT16(save_p, (UINT16)(mobj.state - states));
+		WRITEFIXED(save_p, mobj.x);
+		WRITEFIXED(save_p, mobj.y);
+		WRITEFIXED(save_p, mobj.z);
+		WRITEFIXED(save_p, mobj.radius);
+		WRITEFIXED(save_p, mobj.height);
+		WRITEFIXED(save_p, mobj.floorz);
+		WRITEFIXED(save_p, mobj.ceilingz);
+		WRITEFIXED(save_p, mobj.scale);
+		WRITEANGLE(save_p, mobj.angle);
+		WRITEUINT32(save_p, mobj.flags);
+		WRITEUINT32(save_p, mobj.flags2);
+		WRITEUINT16(save_p, mobj.eflags);
+		WRITEUINT16(save_p, mobj.color);
+		WRITEUINT32(save_p, mobj.frame);
+		WRITEUINT16(save_p, mobj.anim_duration);
+		WRITEUINT8(save_p, (UINT8)mobj.lastlook);
+
+		flags = 0;
+		if (mobj.floorrover)
+			flags |= CD_FLOORROVER;
+		if (mobj.ceilingrover)
+			flags |= CD_CEILINGROVER;
+		if (mobj.spawnpoint)
+			flags |= CD_SPAWNPOINT;
+		if (rec->ownsspawnpoint)
+			flags |= CD_OWNSPAWN;
+		WRITEUINT8(save_p, flags);
+
+		if (flags & CD_FLOORROVER)
+		{
+			WRITEUINT32(save_p, SaveSector(mobj.floorrover->target));
+			WRITEUINT16(save_p, P_GetFFloorID(mobj.floorrover));
+		}
+		if (flags & CD_CEILINGROVER)
+		{
+			WRITEUINT32(save_p, SaveSector(mobj.ceilingrover->target));
+			WRITEUINT16(save_p, P_GetFFloorID(mobj.ceilingrover));
+		}
+		if (flags & CD_SPAWNPOINT)
+			WRITEUINT16(save_p, (UINT16)(mobj.spawnpoint - mapthings));
+	}
+
+	Z_Free(list);
+}
+
+static void P_NetUnArchiveCollectibles(void)
+{
+	static mobj_t mobj;
+	collectible_t *rec;
+	UINT32 count;
+	UINT8 flags;
+
+	if (READUINT32(save_p) != ARCHIVEBLOCK_COLLECTIBLES)
+		I_Error("Bad $$$.sav at archive block Collectibles");
+
+	for (count = READUINT32(save_p); count; count--)
+	{
+		memset(&mobj, 0, sizeof (mobj));
+
+		mobj.type = READUINT16(save_p);
+		mobj.state = &states[READUINT16(save_p)];
+		mobj.x = READFIXED(save_p);
+		mobj.y = READFIXED(save_p);
+		mobj.z = READFIXED(save_p);
+		mobj.radius = READFIXED(save_p);
+		mobj.height = READFIXED(save_p);
+		mobj.floorz = READFIXED(save_p);
+		mobj.ceilingz = READFIXED(save_p);
+		mobj.scale = READFIXED(save_p);
+		mobj.angle = READANGLE(save_p);
+		mobj.flags = READUINT32(save_p);
+		mobj.flags2 = READUINT32(save_p);
+		mobj.eflags = READUINT16(save_p);
+		mobj.color = READUINT16(save_p);
+		mobj.frame = READUINT32(save_p);
+		mobj.anim_duration = READUINT16(save_p);
+		mobj.lastlook = READUINT8(save_p);
+		mobj.subsector = R_PointInSubsector(mobj.x, mobj.y);
+
+		flags = READUINT8(save_p);
+		if (flags & CD_FLOORROVER)
+		{
+			sector_t *sec = LoadSector(READUINT32(save_p));
+			UINT16 id = READUINT16(save_p);
+			mobj.floorrover = P_GetFFloorByID(sec, id);
+		}
+		if (flags & CD_CEILINGROVER)
+		{
+			sector_t *sec = LoadSector(READUINT32(save_p));
+			UINT16 id = READUINT16(save_p);
+			mobj.ceilingrover = P_GetFFloorByID(sec, id);
+		}
+		if (flags & CD_SPAWNPOINT)
+			mobj.spawnpoint = &mapthings[READUINT16(save_p)];
+
+		rec = P_AddCollectible(&mobj);
+		rec->ownsspawnpoint = !!(flags & CD_OWNSPAWN);
+		if (rec->ownsspawnpoint)
+			rec->spawnpoint->mobj = NULL;
+	}
+}
+
 // =======================================================================
 //          Misc
 // =======================================================================
@@ -3955,6 +4229,7 @@ static void P_NetArchiveMisc(void)
 {
 	INT32 i;
 
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
 	WRITEUINT32(save_p, ARCHIVEBLOCK_MISC);
 
 	WRITEINT16(save_p, gamemap);
@@ -4112,6 +4387,8 @@ static inline void P_ArchiveLuabanksAndConsistency(void)
 	while (banksinuse && !luabanks[banksinuse-1])
 		banksinuse--; // get the last used bank
 
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
+
 	if (banksinuse)
 	{
 		WRITEUINT8(save_p, 0xb7); // luabanks marker
@@ -4159,6 +4436,7 @@ void P_SaveNetGame(void)
 	mobj_t *mobj;
 	INT32 i = 1; // don't start from 0, it'd be confused with a blank pointer otherwise
 
+	P_SaveBufferReserve(SAVEBLOCKSIZE);
 	CV_SaveNetVars(&save_p);
 	P_NetArchiveMisc();
 
@@ -4183,6 +4461,7 @@ void P_SaveNetGame(void)
 		P_NetArchiveSpecials();
 		P_NetArchiveColormaps();
 		P_NetArchiveWaypoints();
+		P_NetArchiveCollectibles();
 	}
 	LUA_Archive();
 
@@ -4222,10 +4501,12 @@ boolean P_LoadNetGame(void)
 		P_NetUnArchiveSpecials();
 		P_NetUnArchiveColormaps();
 		P_NetUnArchiveWaypoints();
+		P_NetUnArchiveCollectibles();
 		P_RelinkPointers();
 		P_FinishMobjs();
 	}
 	LUA_UnArchive();
+	P_ClearMobjNumTable();
 
 	// This is stupid and hacky, but maybe it'll work!
 	P_SetRandSeed(P_GetInitSeed());
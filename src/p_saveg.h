@@ -42,4 +42,12 @@ typedef struct
 extern savedata_t savedata;
 extern UINT8 *save_p;
 
+// Growable buffer for P_SaveNetGame.
+// If given a flush function, whatever has been written so far is passed to
+// it whenever the buffer fills up, and writing starts over at the beginning.
+#define SAVEBLOCKSIZE (64*1024) // room reserved for each saved object
+boolean P_SaveBufferAlloc(size_t size, void (*flush)(UINT8 *data, size_t length));
+void P_SaveBufferReserve(size_t length);
+UINT8 *P_SaveBufferRelease(size_t *length);
+
 #endif
@@ -14,6 +14,7 @@
 #include "doomdef.h"
 #include "d_main.h"
 #include "byteptr.h"
+#include "d_netfil.h" // SV_PrepareNetCache
 #include "g_game.h"
 
 #include "p_local.h"
@@ -130,6 +131,8 @@ INT32 *blockmaplump; // Big blockmap
 fixed_t bmaporgx, bmaporgy;
 // for thing chains
 mobj_t **blocklinks;
+// for stored collectible chains
+collectible_t **collectibleblocklinks;
 
 // REJECT
 // For fast sight rejection.
@@ -690,6 +693,8 @@ void P_ReloadRings(void)
 	mapthing_t *hoopsToRespawn[4096];
 	mapthing_t *mt = mapthings;
 
+	P_PromoteAllCollectibles();
+
 	// scan the thinkers to find rings/spheres/hoops to unset
 	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
@@ -748,6 +753,8 @@ void P_SwitchSpheresBonusMode(boolean bonustime)
 	mobj_t *mo;
 	thinker_t *th;
 
+	P_PromoteAllCollectibles();
+
 	// scan the thinkers to find spheres to switch
 	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
@@ -1014,6 +1021,8 @@ static void P_InitializeSector(sector_t *ss)
 	ss->preciplist = NULL;
 	ss->touching_preciplist = NULL;
 
+	ss->collectiblelist = NULL;
+
 	ss->f_slope = NULL;
 	ss->c_slope = NULL;
 	ss->hasslope = false;
@@ -2537,6 +2546,8 @@ static boolean P_LoadBlockMap(UINT8 *data, size_t count)
 	// clear out mobj chains
 	count = sizeof (*blocklinks)* bmapwidth*bmapheight;
 	blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	count = sizeof (*collectibleblocklinks) * bmapwidth * bmapheight;
+	collectibleblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
 	blockmap = blockmaplump+4;
 
 	// haleyjd 2/22/06: setup polyobject blockmap
@@ -2790,6 +2801,8 @@ static void P_CreateBlockMap(void)
 		size_t count = sizeof (*blocklinks) * bmapwidth * bmapheight;
 		// clear out mobj chains (copied from from P_LoadBlockMap)
 		blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+		count = sizeof (*collectibleblocklinks) * bmapwidth * bmapheight;
+		collectibleblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
 		blockmap = blockmaplump + 4;
 
 		// haleyjd 2/22/06: setup polyobject blockmap
@@ -3422,6 +3435,8 @@ void P_RespawnThings(void)
 				centerid = i; // save id just in case
 		}
 
+	P_PromoteAllCollectibles();
+
 	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
 	{
 		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
@@ -4543,6 +4558,10 @@ boolean P_AddWadFile(const char *wadfilename)
 	if (cursaveslot > 0)
 		cursaveslot = 0;
 
+	// Get it ready for downloads
+	if (server && netgame)
+		SV_PrepareNetCache();
+
 	if (replacedcurrentmap && gamestate == GS_LEVEL && (netgame || multiplayer))
 	{
 		CONS_Printf(M_GetText("Current map %d replaced by added file, ending the level to ensure consistency.\n"), gamemap);
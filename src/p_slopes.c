@@ -152,7 +152,7 @@ void T_DynamicSlopeVert (dynplanethink_t* th)
 
 static inline void P_AddDynSlopeThinker (pslope_t* slope, dynplanetype_t type, line_t* sourceline, fixed_t extent, const INT16 tags[3], const vector3_t vx[3])
 {
-	dynplanethink_t* th = Z_Calloc(sizeof (*th), PU_LEVSPEC, NULL);
+	dynplanethink_t* th = P_AllocThinker(sizeof (*th));
 	switch (type)
 	{
 	case DP_VERTEX:
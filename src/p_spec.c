@@ -1552,7 +1552,7 @@ static void P_AddExecutorDelay(line_t *line, mobj_t *mobj, sector_t *sector)
 		delay = (line->backsector->ceilingheight >> FRACBITS) + (line->backsector->floorheight >> FRACBITS);
 	}
 
-	e = Z_Calloc(sizeof (*e), PU_LEVSPEC, NULL);
+	e = P_AllocThinker(sizeof (*e));
 
 	e->thinker.function.acp1 = (actionf_p1)T_ExecutorDelay;
 	e->line = line;
@@ -2340,8 +2340,11 @@ void P_SwitchWeather(INT32 weathernum)
 static mobj_t *P_GetObjectTypeInSectorNum(mobjtype_t type, size_t s)
 {
 	sector_t *sec = sectors + s;
-	mobj_t *thing = sec->thinglist;
+	mobj_t *thing;
+
+	P_PromoteSectorCollectibles(sec);
 
+	thing = sec->thinglist;
 	while (thing)
 	{
 		if (thing->type == type)
@@ -3254,6 +3257,7 @@ static void P_ProcessLineSpecial(line_t *line, mobj_t *mo, sector_t *callsec)
 			{
 				boolean tryagain;
 				sec = sectors + secnum;
+				P_PromoteSectorCollectibles(sec);
 				do {
 					tryagain = false;
 					for (thing = sec->thinglist; thing; thing = thing->snext)
@@ -3991,21 +3995,14 @@ static void P_ProcessLineSpecial(line_t *line, mobj_t *mo, sector_t *callsec)
 
 		case 464: // Trigger Egg Capsule
 			{
-				thinker_t *th;
 				mobj_t *mo2;
 
 				// Find the center of the Eggtrap and release all the pretty animals!
 				// The chimps are my friends.. heeheeheheehehee..... - LouisJM
-				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+				for (mo2 = P_FirstMobjOfType(MT_EGGTRAP); mo2; mo2 = mo2->typenext)
 				{
-					if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+					if (P_MobjWasRemoved(mo2))
 						continue;
-
-					mo2 = (mobj_t *)th;
-
-					if (mo2->type != MT_EGGTRAP)
-						continue;
-
 					if (!mo2->spawnpoint)
 						continue;
 
@@ -4092,7 +4089,6 @@ void P_SetupSignExit(player_t *player)
 {
 	mobj_t *thing;
 	msecnode_t *node = player->mo->subsector->sector->touching_thinglist; // things touching this sector
-	thinker_t *think;
 	INT32 numfound = 0;
 
 	for (; node; node = node->m_thinglist_next)
@@ -4123,15 +4119,10 @@ void P_SetupSignExit(player_t *player)
 
 	// didn't find any signposts in the exit sector.
 	// spin all signposts in the level then.
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	for (thing = P_FirstMobjOfType(MT_SIGN); thing; thing = thing->typenext)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		thing = (mobj_t *)think;
-		if (thing->type != MT_SIGN)
+		if (P_MobjWasRemoved(thing))
 			continue;
-
 		if (!numfound
 			&& !(player->mo->target && player->mo->target->type == MT_SIGN)
 			&& !((gametyperules & GTR_FRIENDLY) && (netgame || multiplayer) && cv_exitmove.value))
@@ -4157,20 +4148,11 @@ void P_SetupSignExit(player_t *player)
 //
 boolean P_IsFlagAtBase(mobjtype_t flag)
 {
-	thinker_t *think;
 	mobj_t *mo;
 	INT32 specialnum = (flag == MT_REDFLAG) ? 3 : 4;
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	for (mo = P_FirstMobjOfType(flag); mo; mo = mo->typenext)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo = (mobj_t *)think;
-
-		if (mo->type != flag)
-			continue;
-
 		if (GETSECSPECIAL(mo->subsector->sector->special, 4) == specialnum)
 			return true;
 		else if (mo->subsector->sector->ffloors) // Check the 3D floors
@@ -4542,7 +4524,6 @@ void P_ProcessSpecialSector(player_t *player, sector_t *sector, sector_t *rovers
 			break;
 		case 9: // Egg trap capsule
 		{
-			thinker_t *th;
 			mobj_t *mo2;
 			line_t junk;
 
@@ -4551,12 +4532,9 @@ void P_ProcessSpecialSector(player_t *player, sector_t *sector, sector_t *rovers
 
 			// Find the center of the Eggtrap and release all the pretty animals!
 			// The chimps are my friends.. heeheeheheehehee..... - LouisJM
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType(MT_EGGTRAP); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-				mo2 = (mobj_t *)th;
-				if (mo2->type != MT_EGGTRAP)
+				if (P_MobjWasRemoved(mo2))
 					continue;
 				P_KillMobj(mo2, NULL, player->mo, 0);
 			}
@@ -5820,7 +5798,7 @@ static void P_AddFloatThinker(sector_t *sec, UINT16 tag, line_t *sourceline)
 	floatthink_t *floater;
 
 	// create and initialize new thinker
-	floater = Z_Calloc(sizeof (*floater), PU_LEVSPEC, NULL);
+	floater = P_AllocThinker(sizeof (*floater));
 	P_AddThinker(THINK_MAIN, &floater->thinker);
 
 	floater->thinker.function.acp1 = (actionf_p1)T_FloatSector;
@@ -5847,7 +5825,7 @@ static void P_AddPlaneDisplaceThinker(INT32 type, fixed_t speed, INT32 control,
 	planedisplace_t *displace;
 
 	// create and initialize new displacement thinker
-	displace = Z_Calloc(sizeof (*displace), PU_LEVSPEC, NULL);
+	displace = P_AllocThinker(sizeof (*displace));
 	P_AddThinker(THINK_MAIN, &displace->thinker);
 
 	displace->thinker.function.acp1 = (actionf_p1)T_PlaneDisplace;
@@ -5874,7 +5852,7 @@ static void P_AddBlockThinker(sector_t *sec, line_t *sourceline)
 	mariocheck_t *block;
 
 	// create and initialize new elevator thinker
-	block = Z_Calloc(sizeof (*block), PU_LEVSPEC, NULL);
+	block = P_AllocThinker(sizeof (*block));
 	P_AddThinker(THINK_MAIN, &block->thinker);
 
 	block->thinker.function.acp1 = (actionf_p1)T_MarioBlockChecker;
@@ -5899,7 +5877,7 @@ static void P_AddRaiseThinker(sector_t *sec, INT16 tag, fixed_t speed, fixed_t c
 {
 	raise_t *raise;
 
-	raise = Z_Calloc(sizeof (*raise), PU_LEVSPEC, NULL);
+	raise = P_AllocThinker(sizeof (*raise));
 	P_AddThinker(THINK_MAIN, &raise->thinker);
 
 	raise->thinker.function.acp1 = (actionf_p1)T_RaiseSector;
@@ -5922,7 +5900,7 @@ static void P_AddAirbob(sector_t *sec, INT16 tag, fixed_t dist, boolean raise, b
 {
 	raise_t *airbob;
 
-	airbob = Z_Calloc(sizeof (*airbob), PU_LEVSPEC, NULL);
+	airbob = P_AllocThinker(sizeof (*airbob));
 	P_AddThinker(THINK_MAIN, &airbob->thinker);
 
 	airbob->thinker.function.acp1 = (actionf_p1)T_RaiseSector;
@@ -5960,7 +5938,7 @@ static inline void P_AddThwompThinker(sector_t *sec, INT16 tag, line_t *sourceli
 		return;
 
 	// create and initialize new elevator thinker
-	thwomp = Z_Calloc(sizeof (*thwomp), PU_LEVSPEC, NULL);
+	thwomp = P_AllocThinker(sizeof (*thwomp));
 	P_AddThinker(THINK_MAIN, &thwomp->thinker);
 
 	thwomp->thinker.function.acp1 = (actionf_p1)T_ThwompSector;
@@ -5995,7 +5973,7 @@ static inline void P_AddNoEnemiesThinker(line_t *sourceline)
 	noenemies_t *nobaddies;
 
 	// create and initialize new thinker
-	nobaddies = Z_Calloc(sizeof (*nobaddies), PU_LEVSPEC, NULL);
+	nobaddies = P_AllocThinker(sizeof (*nobaddies));
 	P_AddThinker(THINK_MAIN, &nobaddies->thinker);
 
 	nobaddies->thinker.function.acp1 = (actionf_p1)T_NoEnemiesSector;
@@ -6015,7 +5993,7 @@ static void P_AddEachTimeThinker(line_t *sourceline)
 	eachtime_t *eachtime;
 
 	// create and initialize new thinker
-	eachtime = Z_Calloc(sizeof (*eachtime), PU_LEVSPEC, NULL);
+	eachtime = P_AllocThinker(sizeof (*eachtime));
 	P_AddThinker(THINK_MAIN, &eachtime->thinker);
 
 	eachtime->thinker.function.acp1 = (actionf_p1)T_EachTimeThinker;
@@ -6039,7 +6017,7 @@ static inline void P_AddCameraScanner(sector_t *sourcesec, sector_t *actionsecto
 	CONS_Alert(CONS_WARNING, M_GetText("Detected a camera scanner effect (linedef type 5). This effect is deprecated and will be removed in the future!\n"));
 
 	// create and initialize new elevator thinker
-	elevator = Z_Calloc(sizeof (*elevator), PU_LEVSPEC, NULL);
+	elevator = P_AllocThinker(sizeof (*elevator));
 	P_AddThinker(THINK_MAIN, &elevator->thinker);
 
 	elevator->thinker.function.acp1 = (actionf_p1)T_CameraScanner;
@@ -6122,7 +6100,7 @@ void T_LaserFlash(laserthink_t *flash)
 
 static inline void P_AddLaserThinker(INT16 tag, line_t *line, boolean nobosses)
 {
-	laserthink_t *flash = Z_Calloc(sizeof (*flash), PU_LEVSPEC, NULL);
+	laserthink_t *flash = P_AllocThinker(sizeof (*flash));
 
 	P_AddThinker(THINK_MAIN, &flash->thinker);
 
@@ -7537,7 +7515,7 @@ void T_Scroll(scroll_t *s)
   */
 static void Add_Scroller(INT32 type, fixed_t dx, fixed_t dy, INT32 control, INT32 affectee, INT32 accel, INT32 exclusive)
 {
-	scroll_t *s = Z_Calloc(sizeof *s, PU_LEVSPEC, NULL);
+	scroll_t *s = P_AllocThinker(sizeof *s);
 	s->thinker.function.acp1 = (actionf_p1)T_Scroll;
 	s->type = type;
 	s->dx = dx;
@@ -7702,7 +7680,7 @@ static void P_SpawnScrollers(void)
   */
 static void Add_MasterDisappearer(tic_t appeartime, tic_t disappeartime, tic_t offset, INT32 line, INT32 sourceline)
 {
-	disappear_t *d = Z_Malloc(sizeof *d, PU_LEVSPEC, NULL);
+	disappear_t *d = P_AllocThinker(sizeof *d);
 
 	d->thinker.function.acp1 = (actionf_p1)T_Disappear;
 	d->appeartime = appeartime;
@@ -8096,7 +8074,7 @@ static void P_AddFakeFloorFader(ffloor_t *rover, size_t sectornum, size_t ffloor
 	if (rover->alpha == max(1, min(256, relative ? rover->alpha + destvalue : destvalue)))
 		return;
 
-	d = Z_Malloc(sizeof *d, PU_LEVSPEC, NULL);
+	d = P_AllocThinker(sizeof *d);
 
 	d->thinker.function.acp1 = (actionf_p1)T_Fade;
 	d->rover = rover;
@@ -8249,7 +8227,7 @@ static void Add_ColormapFader(sector_t *sector, extracolormap_t *source_exc, ext
 		return;
 	}
 
-	d = Z_Malloc(sizeof *d, PU_LEVSPEC, NULL);
+	d = P_AllocThinker(sizeof *d);
 	d->thinker.function.acp1 = (actionf_p1)T_FadeColormap;
 	d->sector = sector;
 	d->source_exc = source_exc;
@@ -8372,7 +8350,7 @@ void T_FadeColormap(fadecolormap_t *d)
   */
 static void Add_Friction(INT32 friction, INT32 movefactor, INT32 affectee, INT32 referrer)
 {
-	friction_t *f = Z_Calloc(sizeof *f, PU_LEVSPEC, NULL);
+	friction_t *f = P_AllocThinker(sizeof *f);
 
 	f->thinker.function.acp1 = (actionf_p1)T_Friction;
 	f->friction = friction;
@@ -8516,7 +8494,7 @@ static void P_SpawnFriction(void)
   */
 static void Add_Pusher(pushertype_e type, fixed_t x_mag, fixed_t y_mag, mobj_t *source, INT32 affectee, INT32 referrer, INT32 exclusive, INT32 slider)
 {
-	pusher_t *p = Z_Calloc(sizeof *p, PU_LEVSPEC, NULL);
+	pusher_t *p = P_AllocThinker(sizeof *p);
 
 	p->thinker.function.acp1 = (actionf_p1)T_Pusher;
 	p->source = source;
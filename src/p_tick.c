@@ -21,6 +21,10 @@
 #include "m_random.h"
 #include "lua_script.h"
 #include "lua_hook.h"
+#include "i_system.h" // I_GetPreciseTime
+#include "dehacked.h" // DEH_MobjTypeName
+#include "d_main.h" // srb2home
+#include "p_slopes.h"
 
 // Object place
 #include "m_cheat.h"
@@ -125,7 +129,6 @@ void Command_Numthinkers_f(void)
 
 void Command_CountMobjs_f(void)
 {
-	thinker_t *th;
 	mobjtype_t i;
 	INT32 count;
 
@@ -147,16 +150,7 @@ void Command_CountMobjs_f(void)
 				continue;
 			}
 
-			count = 0;
-
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
-			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				if (((mobj_t *)th)->type == i)
-					count++;
-			}
+			count = (INT32)P_CountMobjsOfType(i);
 
 			CONS_Printf(M_GetText("There are %d objects of type %d currently in the level.\n"), count, i);
 		}
@@ -167,22 +161,28 @@ void Command_CountMobjs_f(void)
 
 	for (i = 0; i < NUMMOBJTYPES; i++)
 	{
-		count = 0;
-
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
-		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			if (((mobj_t *)th)->type == i)
-				count++;
-		}
+		count = (INT32)P_CountMobjsOfType(i);
 
 		if (count > 0) // Don't bother displaying if there are none of this type!
 			CONS_Printf(" * %d: %d\n", i, count);
 	}
 }
 
+// Object pools for level thinkers, so spawning and removing them
+// doesn't go through malloc every time.
+zpool_t *mobjpool = NULL;
+zpool_t *precipmobjpool = NULL;
+zpool_t *collectiblepool = NULL;
+
+// Special thinkers come in many sizes, so they share a few size classes.
+#define THINKERPOOLSTEP 64
+#define NUMTHINKERPOOLS 8
+static zpool_t *thinkerpools[NUMTHINKERPOOLS];
+static const char *const thinkerpoolnames[NUMTHINKERPOOLS] = {
+	"Thinkers (64)", "Thinkers (128)", "Thinkers (192)", "Thinkers (256)",
+	"Thinkers (320)", "Thinkers (384)", "Thinkers (448)", "Thinkers (512)"
+};
+
 //
 // P_InitThinkers
 //
@@ -191,6 +191,34 @@ void P_InitThinkers(void)
 	UINT8 i;
 	for (i = 0; i < NUM_THINKERLISTS; i++)
 		thlist[i].prev = thlist[i].next = &thlist[i];
+
+	P_ClearMobjTypeLists();
+	P_ClearCollectibles();
+
+	if (!mobjpool)
+	{
+		mobjpool = Z_CreatePool("Objects", sizeof (mobj_t), 256);
+		precipmobjpool = Z_CreatePool("Precipitation", sizeof (precipmobj_t), 512);
+		collectiblepool = Z_CreatePool("Collectibles", sizeof (collectible_t), 256);
+		for (i = 0; i < NUMTHINKERPOOLS; i++)
+			thinkerpools[i] = Z_CreatePool(thinkerpoolnames[i], (i + 1) * THINKERPOOLSTEP, 64);
+	}
+}
+
+//
+// P_AllocThinker
+//
+// Allocates zeroed PU_LEVSPEC memory for a special thinker.
+// Thinkers too big for any size class get a zone block of their own.
+//
+void *P_AllocThinker(size_t size)
+{
+	const size_t i = (size - 1) / THINKERPOOLSTEP;
+
+	if (i >= NUMTHINKERPOOLS)
+		return Z_Calloc(size, PU_LEVSPEC, NULL);
+
+	return Z_PoolCalloc(thinkerpools[i], PU_LEVSPEC, NULL);
 }
 
 // Adds a new thinker at the end of the list.
@@ -294,6 +322,375 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 	return targ;
 }
 
+//
+// THINKER PROFILING
+//
+// With thinkerprofile on, P_RunThinkers times every thinker it runs and
+// charges the time to the thinker's function, and for mobjs, to their
+// type. Figures are gathered over a window of thinkerprofile_window tics;
+// the thinkerprof command shows the last complete window.
+//
+
+static void ThinkerProfile_OnChange(void);
+
+static CV_PossibleValue_t thinkerprofilewindow_cons_t[] = {{1, "MIN"}, {35*60, "MAX"}, {0, NULL}};
+consvar_t cv_thinkerprofile = {"thinkerprofile", "Off", CV_CALL, CV_OnOff, ThinkerProfile_OnChange, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_thinkerprofilewindow = {"thinkerprofile_window", "175", CV_CALL, thinkerprofilewindow_cons_t, ThinkerProfile_OnChange, 0, NULL, NULL, 0, 0, NULL};
+
+typedef struct
+{
+	precise_t time; // total time spent
+	precise_t peak; // longest single call
+	UINT32 calls;
+} thinkerstat_t;
+
+typedef struct
+{
+	actionf_p1 func;
+	thinkerstat_t stat, last;
+} thinkerfuncprof_t;
+
+#define PROFTHINKER(fn) {(actionf_p1)fn, #fn}
+static const struct
+{
+	actionf_p1 func;
+	const char *name;
+} thinkernames[] = {
+	PROFTHINKER(P_MobjThinker),
+	PROFTHINKER(P_NullPrecipThinker),
+	PROFTHINKER(P_RemoveThinkerDelayed),
+	PROFTHINKER(T_MoveCeiling),
+	PROFTHINKER(T_CrushCeiling),
+	PROFTHINKER(T_MoveFloor),
+	PROFTHINKER(T_LightningFlash),
+	PROFTHINKER(T_StrobeFlash),
+	PROFTHINKER(T_Glow),
+	PROFTHINKER(T_FireFlicker),
+	PROFTHINKER(T_MoveElevator),
+	PROFTHINKER(T_ContinuousFalling),
+	PROFTHINKER(T_ThwompSector),
+	PROFTHINKER(T_NoEnemiesSector),
+	PROFTHINKER(T_EachTimeThinker),
+	PROFTHINKER(T_RaiseSector),
+	PROFTHINKER(T_CameraScanner),
+	PROFTHINKER(T_Scroll),
+	PROFTHINKER(T_Friction),
+	PROFTHINKER(T_Pusher),
+	PROFTHINKER(T_BounceCheese),
+	PROFTHINKER(T_StartCrumble),
+	PROFTHINKER(T_MarioBlock),
+	PROFTHINKER(T_MarioBlockChecker),
+	PROFTHINKER(T_FloatSector),
+	PROFTHINKER(T_LaserFlash),
+	PROFTHINKER(T_LightFade),
+	PROFTHINKER(T_ExecutorDelay),
+	PROFTHINKER(T_Disappear),
+	PROFTHINKER(T_Fade),
+	PROFTHINKER(T_FadeColormap),
+	PROFTHINKER(T_PlaneDisplace),
+	PROFTHINKER(T_PolyObjRotate),
+	PROFTHINKER(T_PolyObjMove),
+	PROFTHINKER(T_PolyObjWaypoint),
+	PROFTHINKER(T_PolyDoorSlide),
+	PROFTHINKER(T_PolyDoorSwing),
+	PROFTHINKER(T_PolyObjFlag),
+	PROFTHINKER(T_PolyObjDisplace),
+	PROFTHINKER(T_PolyObjRotDisplace),
+	PROFTHINKER(T_PolyObjFade),
+	PROFTHINKER(T_DynamicSlopeLine),
+	PROFTHINKER(T_DynamicSlopeVert),
+};
+#undef PROFTHINKER
+
+#define MAXPROFTHINKERS 64
+
+static thinkerfuncprof_t thinkerfuncprof[MAXPROFTHINKERS];
+static size_t numthinkerfuncprof;
+static thinkerstat_t *mobjtypeprof, *lastmobjtypeprof; // [NUMMOBJTYPES]
+static thinkerstat_t tictimeprof, lasttictimeprof; // whole P_RunThinkers calls, one per tic
+static tic_t thinkerproftics, lastthinkerproftics;
+
+static void ThinkerProfile_Reset(void)
+{
+	memset(thinkerfuncprof, 0, sizeof (thinkerfuncprof));
+	numthinkerfuncprof = 0;
+	if (mobjtypeprof)
+	{
+		memset(mobjtypeprof, 0, NUMMOBJTYPES * sizeof (*mobjtypeprof));
+		memset(lastmobjtypeprof, 0, NUMMOBJTYPES * sizeof (*lastmobjtypeprof));
+	}
+	memset(&tictimeprof, 0, sizeof (tictimeprof));
+	memset(&lasttictimeprof, 0, sizeof (lasttictimeprof));
+	thinkerproftics = lastthinkerproftics = 0;
+}
+
+static void ThinkerProfile_OnChange(void)
+{
+	ThinkerProfile_Reset();
+	if (cv_thinkerprofile.value && !mobjtypeprof)
+	{
+		mobjtypeprof = Z_Calloc(NUMMOBJTYPES * sizeof (*mobjtypeprof), PU_STATIC, NULL);
+		lastmobjtypeprof = Z_Calloc(NUMMOBJTYPES * sizeof (*lastmobjtypeprof), PU_STATIC, NULL);
+	}
+}
+
+static inline void ThinkerProfile_Add(thinkerstat_t *stat, precise_t time)
+{
+	stat->time += time;
+	stat->calls++;
+	if (time > stat->peak)
+		stat->peak = time;
+}
+
+static thinkerfuncprof_t *ThinkerProfile_Func(actionf_p1 func)
+{
+	static thinkerfuncprof_t *lastprof = NULL;
+	size_t i;
+
+	// Thinkers of the same kind tend to come in runs
+	if (lastprof && lastprof->func == func)
+		return lastprof;
+
+	for (i = 0; i < numthinkerfuncprof; i++)
+		if (thinkerfuncprof[i].func == func)
+			return (lastprof = &thinkerfuncprof[i]);
+
+	if (numthinkerfuncprof == MAXPROFTHINKERS)
+		return (lastprof = NULL);
+
+	lastprof = &thinkerfuncprof[numthinkerfuncprof++];
+	lastprof->func = func;
+	return lastprof;
+}
+
+// Ends the current window once it's long enough
+static void ThinkerProfile_Tic(precise_t tictime)
+{
+	size_t i;
+
+	ThinkerProfile_Add(&tictimeprof, tictime);
+
+	if (++thinkerproftics < (tic_t)cv_thinkerprofilewindow.value)
+		return;
+
+	for (i = 0; i < numthinkerfuncprof; i++)
+	{
+		thinkerfuncprof[i].last = thinkerfuncprof[i].stat;
+		memset(&thinkerfuncprof[i].stat, 0, sizeof (thinkerfuncprof[i].stat));
+	}
+
+	memcpy(lastmobjtypeprof, mobjtypeprof, NUMMOBJTYPES * sizeof (*mobjtypeprof));
+	memset(mobjtypeprof, 0, NUMMOBJTYPES * sizeof (*mobjtypeprof));
+
+	lasttictimeprof = tictimeprof;
+	memset(&tictimeprof, 0, sizeof (tictimeprof));
+
+	lastthinkerproftics = thinkerproftics;
+	thinkerproftics = 0;
+}
+
+static const char *ThinkerProfile_FuncName(actionf_p1 func)
+{
+	size_t i;
+	for (i = 0; i < sizeof (thinkernames) / sizeof (*thinkernames); i++)
+		if (thinkernames[i].func == func)
+			return thinkernames[i].name;
+	return "(unknown)";
+}
+
+static const char *ThinkerProfile_TypeName(mobjtype_t type)
+{
+	const char *name = DEH_MobjTypeName(type);
+	return name ? va("MT_%s", name) : va("%d", type);
+}
+
+static UINT32 ThinkerProfile_Micros(precise_t time)
+{
+	return (UINT32)(time * 1000000 / I_GetPrecisePrecision());
+}
+
+static const thinkerstat_t *profsortstats;
+
+static int ThinkerProfile_Compare(const void *p1, const void *p2)
+{
+	const precise_t time1 = profsortstats[*(const INT32 *)p1].time;
+	const precise_t time2 = profsortstats[*(const INT32 *)p2].time;
+	if (time1 != time2)
+		return (time1 > time2) ? -1 : 1;
+	return *(const INT32 *)p1 - *(const INT32 *)p2;
+}
+
+// Lists the indices of stats with any calls, most expensive first
+static INT32 ThinkerProfile_Sort(const thinkerstat_t *stats, INT32 numstats, INT32 *order)
+{
+	INT32 i, count = 0;
+
+	for (i = 0; i < numstats; i++)
+		if (stats[i].calls)
+			order[count++] = i;
+
+	profsortstats = stats;
+	qsort(order, count, sizeof (*order), ThinkerProfile_Compare);
+	return count;
+}
+
+static void ThinkerProfile_PrintRow(const char *name, const thinkerstat_t *stat)
+{
+	CONS_Printf(" %-28s %8u %10u %8u %8u %5u%%\n", name,
+		stat->calls / lastthinkerproftics,
+		ThinkerProfile_Micros(stat->time) / lastthinkerproftics,
+		ThinkerProfile_Micros(stat->time) / stat->calls,
+		ThinkerProfile_Micros(stat->peak),
+		(UINT32)(lasttictimeprof.time ? stat->time * 100 / lasttictimeprof.time : 0));
+}
+
+static void ThinkerProfile_WriteCSV(const char *filename)
+{
+	thinkerstat_t funcstats[MAXPROFTHINKERS];
+	INT32 order[MAXPROFTHINKERS];
+	INT32 *typeorder;
+	INT32 i, count;
+	FILE *f;
+
+	f = fopen(va("%s"PATHSEP"%s", srb2home, filename), "w");
+	if (!f)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't open %s for writing\n"), filename);
+		return;
+	}
+
+	fprintf(f, "kind,name,calls,total_us,avg_us,peak_us,tics\n");
+
+	for (i = 0; i < (INT32)numthinkerfuncprof; i++)
+		funcstats[i] = thinkerfuncprof[i].last;
+	count = ThinkerProfile_Sort(funcstats, (INT32)numthinkerfuncprof, order);
+	for (i = 0; i < count; i++)
+	{
+		const thinkerstat_t *stat = &funcstats[order[i]];
+		fprintf(f, "function,%s,%u,%u,%u,%u,%u\n", ThinkerProfile_FuncName(thinkerfuncprof[order[i]].func),
+			stat->calls, ThinkerProfile_Micros(stat->time), ThinkerProfile_Micros(stat->time) / stat->calls,
+			ThinkerProfile_Micros(stat->peak), lastthinkerproftics);
+	}
+
+	typeorder = Z_Malloc(NUMMOBJTYPES * sizeof (*typeorder), PU_STATIC, NULL);
+	count = ThinkerProfile_Sort(lastmobjtypeprof, NUMMOBJTYPES, typeorder);
+	for (i = 0; i < count; i++)
+	{
+		const thinkerstat_t *stat = &lastmobjtypeprof[typeorder[i]];
+		fprintf(f, "mobjtype,%s,%u,%u,%u,%u,%u\n", ThinkerProfile_TypeName(typeorder[i]),
+			stat->calls, ThinkerProfile_Micros(stat->time), ThinkerProfile_Micros(stat->time) / stat->calls,
+			ThinkerProfile_Micros(stat->peak), lastthinkerproftics);
+	}
+	Z_Free(typeorder);
+
+	fprintf(f, "tic,P_RunThinkers,%u,%u,%u,%u,%u\n",
+		lasttictimeprof.calls, ThinkerProfile_Micros(lasttictimeprof.time),
+		lasttictimeprof.calls ? ThinkerProfile_Micros(lasttictimeprof.time) / lasttictimeprof.calls : 0,
+		ThinkerProfile_Micros(lasttictimeprof.peak), lastthinkerproftics);
+
+	fclose(f);
+	CONS_Printf(M_GetText("Thinker profile written to %s\n"), filename);
+}
+
+void Command_Thinkerprof_f(void)
+{
+	thinkerstat_t funcstats[MAXPROFTHINKERS];
+	INT32 order[MAXPROFTHINKERS];
+	INT32 *typeorder;
+	INT32 i, count, limit = 10;
+	const char *arg = COM_Argc() >= 2 ? COM_Argv(1) : "";
+
+	if (!cv_thinkerprofile.value)
+	{
+		CONS_Printf(M_GetText("Thinker profiling is off. Set \"thinkerprofile\" to \"On\" to start it.\n"));
+		return;
+	}
+
+	if (!stricmp(arg, "reset"))
+	{
+		ThinkerProfile_Reset();
+		return;
+	}
+
+	if (!lastthinkerproftics)
+	{
+		CONS_Printf(M_GetText("No thinker profile yet; wait %d tics.\n"), cv_thinkerprofilewindow.value - (INT32)thinkerproftics);
+		return;
+	}
+
+	if (!stricmp(arg, "csv"))
+	{
+		ThinkerProfile_WriteCSV(COM_Argc() >= 3 ? COM_Argv(2) : "thinkerprof.csv");
+		return;
+	}
+
+	if (*arg)
+	{
+		limit = atoi(arg);
+		if (limit <= 0)
+		{
+			CONS_Printf(M_GetText("thinkerprof [<count>]: Show the costliest thinkers of the last window\n"
+				"thinkerprof csv [<file>]: Write the last window out as CSV\n"
+				"thinkerprof reset: Start a new window\n"));
+			return;
+		}
+	}
+
+	CONS_Printf(M_GetText("Thinkers over the last %u tics: %u us/tic average, %u us worst tic\n"),
+		lastthinkerproftics, ThinkerProfile_Micros(lasttictimeprof.time) / lastthinkerproftics,
+		ThinkerProfile_Micros(lasttictimeprof.peak));
+	CONS_Printf(" %-28s %8s %10s %8s %8s %6s\n", "Function", "calls/t", "us/tic", "us/call", "peak", "share");
+
+	for (i = 0; i < (INT32)numthinkerfuncprof; i++)
+		funcstats[i] = thinkerfuncprof[i].last;
+	count = ThinkerProfile_Sort(funcstats, (INT32)numthinkerfuncprof, order);
+	for (i = 0; i < count && i < limit; i++)
+		ThinkerProfile_PrintRow(ThinkerProfile_FuncName(thinkerfuncprof[order[i]].func), &funcstats[order[i]]);
+
+	CONS_Printf(" %-28s %8s %10s %8s %8s %6s\n", "Object type", "calls/t", "us/tic", "us/call", "peak", "share");
+
+	typeorder = Z_Malloc(NUMMOBJTYPES * sizeof (*typeorder), PU_STATIC, NULL);
+	count = ThinkerProfile_Sort(lastmobjtypeprof, NUMMOBJTYPES, typeorder);
+	for (i = 0; i < count && i < limit; i++)
+		ThinkerProfile_PrintRow(ThinkerProfile_TypeName(typeorder[i]), &lastmobjtypeprof[typeorder[i]]);
+	Z_Free(typeorder);
+}
+
+// P_RunThinkers, with timing.
+static void P_RunThinkersProfiled(void)
+{
+	const precise_t ticstart = I_GetPreciseTime();
+	precise_t start, time;
+	thinkerfuncprof_t *prof;
+	actionf_p1 func;
+	mobjtype_t type;
+	size_t i;
+
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+	{
+		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = currentthinker->next)
+		{
+#ifdef PARANOIA
+			I_Assert(currentthinker->function.acp1 != NULL);
+#endif
+			// Note these down first, the thinker might not be there afterwards
+			func = currentthinker->function.acp1;
+			type = (func == (actionf_p1)P_MobjThinker) ? ((mobj_t *)currentthinker)->type : NUMMOBJTYPES;
+
+			start = I_GetPreciseTime();
+			func(currentthinker);
+			time = I_GetPreciseTime() - start;
+
+			if ((prof = ThinkerProfile_Func(func)) != NULL)
+				ThinkerProfile_Add(&prof->stat, time);
+			if (type < NUMMOBJTYPES)
+				ThinkerProfile_Add(&mobjtypeprof[type], time);
+		}
+	}
+
+	ThinkerProfile_Tic(I_GetPreciseTime() - ticstart);
+}
+
 //
 // P_RunThinkers
 //
@@ -319,6 +716,13 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 static inline void P_RunThinkers(void)
 {
 	size_t i;
+
+	if (cv_thinkerprofile.value)
+	{
+		P_RunThinkersProfiled();
+		return;
+	}
+
 	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
 		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = currentthinker->next)
@@ -660,7 +1064,10 @@ void P_Ticker(boolean run)
 
 	if (run)
 	{
+		P_PromoteAttractedCollectibles();
+		P_WakeDormantMobjs();
 		P_RunThinkers();
+		P_StoreParkedCollectibles();
 
 		// Run any "after all the other thinkers" stuff
 		for (i = 0; i < MAXPLAYERS; i++)
@@ -782,7 +1189,10 @@ void P_PreTicker(INT32 frames)
 				memcpy(&players[i].cmd, &temptic, sizeof(ticcmd_t));
 			}
 
+		P_PromoteAttractedCollectibles();
+		P_WakeDormantMobjs();
 		P_RunThinkers();
+		P_StoreParkedCollectibles();
 
 		// Run any "after all the other thinkers" stuff
 		for (i = 0; i < MAXPLAYERS; i++)
@@ -23,6 +23,9 @@ extern tic_t leveltime;
 // Called by G_Ticker. Carries out all thinking of enemies and players.
 void Command_Numthinkers_f(void);
 void Command_CountMobjs_f(void);
+void Command_Thinkerprof_f(void);
+
+extern consvar_t cv_thinkerprofile, cv_thinkerprofilewindow;
 
 void P_Ticker(boolean run);
 void P_PreTicker(INT32 frames);
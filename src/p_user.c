@@ -420,7 +420,6 @@ void P_ResetScore(player_t *player)
 //
 UINT8 P_FindLowestMare(void)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	UINT8 mare = UINT8_MAX;
 
@@ -429,15 +428,8 @@ UINT8 P_FindLowestMare(void)
 
 	// scan the thinkers
 	// to find the egg capsule with the lowest mare
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_EGGCAPSULE); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_EGGCAPSULE)
-			continue;
 		if (mo2->health <= 0)
 			continue;
 
@@ -464,7 +456,6 @@ UINT8 P_FindLowestMare(void)
 //
 boolean P_TransferToNextMare(player_t *player)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	INT32 lowestaxisnum = -1;
@@ -482,16 +473,8 @@ boolean P_TransferToNextMare(player_t *player)
 
 	// scan the thinkers
 	// to find the closest axis point
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_AXIS); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_AXIS)
-			continue;
-
 		if (mo2->threshold != mare)
 			continue;
 
@@ -597,7 +580,6 @@ static mobj_t *P_FindAxisTransfer(INT32 mare, INT32 axisnum, mobjtype_t type)
 // Finds the CLOSEST axis with the number specified.
 void P_TransferToAxis(player_t *player, INT32 axisnum)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis;
 	INT32 mare = player->mare;
@@ -609,15 +591,8 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 
 	// scan the thinkers
 	// to find the closest axis point
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_AXIS); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_AXIS)
-			continue;
 		if (mo2->health != axisnum)
 			continue;
 		if (mo2->threshold != mare)
@@ -1988,6 +1963,10 @@ void P_SwitchShield(player_t *player, UINT16 shieldtype)
 		player->powers[pw_shield] = shieldtype|(player->powers[pw_shield] & SH_STACK);
 		P_SpawnShieldOrb(player);
 
+		// Stored collectibles have to see it right away, see P_LookForShield
+		if (shieldtype & SH_PROTECTELECTRIC)
+			P_PromoteCollectiblesNearShield(player->mo);
+
 		if (shieldtype & SH_PROTECTWATER)
 		{
 			if (player->powers[pw_underwater] && player->powers[pw_underwater] <= 12*TICRATE + 1)
@@ -4945,6 +4924,9 @@ void P_TwinSpinRejuvenate(player_t *player, mobjtype_t type)
 	player->pflags &= ~PF_THOKKED;
 }
 
+// Scratch list for the searches below that don't call out to Lua mid-loop
+static thinglist_t nearbythings;
+
 //
 // P_Telekinesis
 //
@@ -4953,20 +4935,19 @@ void P_TwinSpinRejuvenate(player_t *player, mobjtype_t type)
 //
 void P_Telekinesis(player_t *player, fixed_t thrust, fixed_t range)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 	angle_t an;
+	size_t i;
 
 	if (player->powers[pw_super]) // increase range when super
 		range *= 2;
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
-	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
+	P_QueryThingsInRadius(&nearbythings, player->mo->x, player->mo->y, range, 0, MT_NULL, 0);
 
-		mo2 = (mobj_t *)th;
+	for (i = 0; i < nearbythings.numresults; i++)
+	{
+		mo2 = nearbythings.results[i].mobj;
 
 		if (mo2 == player->mo)
 			continue;
@@ -7024,7 +7005,6 @@ static void P_NiGHTSMovement(player_t *player)
 	boolean still = false, moved = false, backwardaxis = false, firstdrill;
 	INT16 newangle = 0;
 	fixed_t xspeed, yspeed;
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	fixed_t newx, newy, radius;
@@ -7112,15 +7092,8 @@ static void P_NiGHTSMovement(player_t *player)
 
 		// scan the thinkers
 		// to find the closest axis point
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType(MT_AXIS); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_AXIS)
-				continue;
 			if (mo2->threshold != player->mare)
 				continue;
 
@@ -8943,7 +8916,8 @@ void P_NukeEnemies(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 	const fixed_t ns = 60 << FRACBITS;
 	mobj_t *mo;
 	angle_t fa;
-	thinker_t *think;
+	thinglist_t nuked = {NULL, 0, 0}; // P_DamageMobj can call back into here through Lua
+	size_t j;
 	INT32 i;
 
 	for (i = 0; i < 16; i++)
@@ -8957,12 +8931,14 @@ void P_NukeEnemies(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 		}
 	}
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	P_QueryThingsInRadius(&nuked, inflictor->x, inflictor->y, radius, 0, MT_NULL, 0);
+
+	for (j = 0; j < nuked.numresults; j++)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
+		mo = nuked.results[j].mobj;
 
-		mo = (mobj_t *)think;
+		if (P_MobjWasRemoved(mo))
+			continue;
 
 		if (!(mo->flags & MF_SHOOTABLE) && !(mo->type == MT_EGGGUARD || mo->type == MT_MINUS))
 			continue;
@@ -8990,6 +8966,8 @@ void P_NukeEnemies(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 		else
 			P_DamageMobj(mo, inflictor, source, 1000, DMG_NUKE);
 	}
+
+	P_ClearThingList(&nuked);
 }
 
 //
@@ -9045,19 +9023,18 @@ void P_Earthquake(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 mobj_t *P_LookForFocusTarget(player_t *player, mobj_t *exclude, SINT8 direction, UINT8 lockonflags)
 {
 	mobj_t *mo;
-	thinker_t *think;
 	mobj_t *closestmo = NULL;
 	const fixed_t maxdist = 2560*player->mo->scale;
 	const angle_t span = ANGLE_45;
 	fixed_t dist, closestdist = 0;
 	angle_t dangle, closestdangle = 0;
+	size_t i;
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
-	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
+	P_QueryThingsInRadius(&nearbythings, player->mo->x, player->mo->y, maxdist, 0, MT_NULL, 0);
 
-		mo = (mobj_t *)think;
+	for (i = 0; i < nearbythings.numresults; i++)
+	{
+		mo = nearbythings.results[i].mobj;
 
 		if (mo->flags & MF_NOCLIPTHING)
 			continue;
@@ -9172,19 +9149,18 @@ mobj_t *P_LookForFocusTarget(player_t *player, mobj_t *exclude, SINT8 direction,
 mobj_t *P_LookForEnemies(player_t *player, boolean nonenemies, boolean bullet)
 {
 	mobj_t *mo;
-	thinker_t *think;
 	mobj_t *closestmo = NULL;
 	const fixed_t maxdist = FixedMul((bullet ? RING_DIST*2 : RING_DIST), player->mo->scale);
 	const angle_t span = (bullet ? ANG30 : ANGLE_90);
 	fixed_t dist, closestdist = 0;
 	const mobjflag_t nonenemiesdisregard = (bullet ? 0 : MF_MONITOR)|MF_SPRING;
+	size_t i;
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
-	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
+	P_QueryThingsInRadius(&nearbythings, player->mo->x, player->mo->y, maxdist, 0, MT_NULL, 0);
 
-		mo = (mobj_t *)think;
+	for (i = 0; i < nearbythings.numresults; i++)
+	{
+		mo = nearbythings.results[i].mobj;
 
 		if (mo->flags & MF_NOCLIPTHING)
 			continue;
@@ -9318,28 +9294,20 @@ boolean P_HomingAttack(mobj_t *source, mobj_t *enemy) // Home in on your target
 // Search for emeralds
 void P_FindEmerald(void)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
 	hunt1 = hunt2 = hunt3 = NULL;
 
 	// scan the remaining thinkers
 	// to find all emeralds
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_EMERHUNT); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-		if (mo2->type == MT_EMERHUNT)
-		{
-			if (!hunt1)
-				hunt1 = mo2;
-			else if (!hunt2)
-				hunt2 = mo2;
-			else if (!hunt3)
-				hunt3 = mo2;
-		}
+		if (!hunt1)
+			hunt1 = mo2;
+		else if (!hunt2)
+			hunt2 = mo2;
+		else if (!hunt3)
+			hunt3 = mo2;
 	}
 	return;
 }
@@ -11725,6 +11693,8 @@ void P_PlayerThink(player_t *player)
 		fixed_t y = player->mo->y;
 		fixed_t z = player->mo->z;
 
+		P_PromoteCollectiblesInRange(x, y, FixedMul(128*FRACUNIT, player->mo->scale));
+
 		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
@@ -1235,6 +1235,7 @@ void R_PrecacheLevel(void)
 	lumpnum_t lump;
 
 	thinker_t *th;
+	collectible_t *rec;
 	spriteframe_t *sf;
 
 	if (demoplayback)
@@ -1294,6 +1295,9 @@ void R_PrecacheLevel(void)
 		if (th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed)
 			spritepresent[((mobj_t *)th)->sprite] = 1;
 
+	for (rec = storedcollectibles; rec; rec = rec->next)
+		spritepresent[states[rec->state].sprite] = 1;
+
 	spritememory = 0;
 	for (i = 0; i < numsprites; i++)
 	{
@@ -581,6 +581,60 @@ void R_InitSprites(void)
 void R_ClearSprites(void)
 {
 	visspritecount = clippedvissprites = 0;
+	R_ClearCollectibleProxies();
+}
+
+//
+// Collectible proxies
+//
+// Stored collectibles aren't mobjs, so each one that gets drawn is given
+// a stand-in mobj, which lasts until the sprites are cleared again.
+//
+typedef struct
+{
+	mobj_t mobj;
+	msecnode_t node; // for R_GetShadowZ
+} collectibleproxy_t;
+
+static UINT32 collectibleproxycount;
+static collectibleproxy_t *collectibleproxychunks[MAXVISSPRITES >> VISSPRITECHUNKBITS] = {NULL};
+
+//
+// R_GetCollectibleProxy
+// Fills in the next free stand-in, or returns NULL if there are
+// none left. Call R_KeepCollectibleProxy if it gets used.
+//
+mobj_t *R_GetCollectibleProxy(collectible_t *rec)
+{
+	UINT32 chunk = collectibleproxycount >> VISSPRITECHUNKBITS;
+	collectibleproxy_t *proxy;
+
+	if (collectibleproxycount == MAXVISSPRITES)
+		return NULL;
+
+	// Allocate chunk if necessary
+	if (!collectibleproxychunks[chunk])
+		Z_Malloc(sizeof (collectibleproxy_t) * VISSPRITESPERCHUNK, PU_LEVEL, &collectibleproxychunks[chunk]);
+
+	proxy = collectibleproxychunks[chunk] + (collectibleproxycount & VISSPRITEINDEXMASK);
+
+	P_CollectibleToMobj(&proxy->mobj, rec);
+	memset(&proxy->node, 0, sizeof (proxy->node));
+	proxy->node.m_sector = rec->subsector->sector;
+	proxy->node.m_thing = &proxy->mobj;
+	proxy->mobj.touching_sectorlist = &proxy->node;
+
+	return &proxy->mobj;
+}
+
+void R_KeepCollectibleProxy(void)
+{
+	collectibleproxycount++;
+}
+
+void R_ClearCollectibleProxies(void)
+{
+	collectibleproxycount = 0;
 }
 
 //
@@ -2053,6 +2107,7 @@ weatherthink:
 void R_AddSprites(sector_t *sec, INT32 lightlevel)
 {
 	mobj_t *thing;
+	collectible_t *rec;
 	precipmobj_t *precipthing; // Tails 08-25-2002
 	INT32 lightnum;
 	fixed_t limit_dist, hoop_limit_dist;
@@ -2094,6 +2149,18 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 			R_ProjectSprite(thing);
 	}
 
+	for (rec = sec->collectiblelist; rec; rec = rec->snext)
+	{
+		if (!(thing = R_GetCollectibleProxy(rec)))
+			break;
+
+		if (R_ThingVisibleWithinDist(thing, limit_dist, hoop_limit_dist))
+		{
+			R_ProjectSprite(thing);
+			R_KeepCollectibleProxy();
+		}
+	}
+
 	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
 	if ((limit_dist = (fixed_t)cv_drawdist_precip.value << FRACBITS))
 	{
@@ -64,6 +64,9 @@ fixed_t R_GetShadowZ(mobj_t *thing, pslope_t **shadowslope);
 void R_AddSprites(sector_t *sec, INT32 lightlevel);
 void R_InitSprites(void);
 void R_ClearSprites(void);
+mobj_t *R_GetCollectibleProxy(collectible_t *rec);
+void R_KeepCollectibleProxy(void);
+void R_ClearCollectibleProxies(void);
 void R_ClipSprites(drawseg_t* dsstart, portal_t* portal);
 
 boolean R_ThingVisible (mobj_t *thing);
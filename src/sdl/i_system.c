@@ -243,6 +243,7 @@ SDL_bool consolevent = SDL_FALSE;
 SDL_bool framebuffer = SDL_FALSE;
 
 UINT8 keyboard_started = false;
+boolean quieterror = false;
 
 static void I_ReportSignal(int num, int coredumped)
 {
@@ -2152,6 +2153,16 @@ int I_GetTimeMicros(void)
 	return TimeFunction(1000000);
 }
 
+precise_t I_GetPreciseTime(void)
+{
+	return SDL_GetPerformanceCounter();
+}
+
+UINT64 I_GetPrecisePrecision(void)
+{
+	return SDL_GetPerformanceFrequency();
+}
+
 //
 //I_StartupTimer
 //
@@ -2367,6 +2378,11 @@ void I_Error(const char *error, ...)
 	va_list argptr;
 	char buffer[8192];
 
+#ifdef __linux__
+	if (quieterror)
+		_exit(-1);
+#endif
+
 	// recursive error detecting
 	if (shutdowning)
 	{
@@ -19,6 +19,7 @@
 #include "z_zone.h"
 #include "w_wad.h"
 #include "lua_script.h"
+#include "dehacked.h" // DEH_SfxRenamed
 
 //
 // Information about all the sfx
@@ -888,6 +889,7 @@ sfxenum_t S_AddSoundFx(const char *name, boolean singular, INT32 flags, boolean
 	if (i < NUMSFX)
 	{
 		strncpy(freeslotnames[i-sfx_freeslot0], name, 6);
+		DEH_SfxRenamed(i);
 		S_sfx[i].singularity = singular;
 		S_sfx[i].priority = 60;
 		S_sfx[i].pitch = flags;
@@ -2529,7 +2529,6 @@ static void ST_doHuntIconsAndSound(void)
 static void ST_doItemFinderIconsAndSound(void)
 {
 	INT32 emblems[16];
-	thinker_t *th;
 	mobj_t *mo2;
 
 	UINT8 stemblems = 0, stunfound = 0;
@@ -2555,16 +2554,8 @@ static void ST_doItemFinderIconsAndSound(void)
 		return;
 
 	// Scan thinkers to find emblem mobj with these ids
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(MT_EMBLEM); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_EMBLEM)
-			continue;
-
 		if (!(mo2->flags & MF_SPECIAL))
 			continue;
 
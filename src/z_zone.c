@@ -24,6 +24,12 @@
 ///        caught with this direct-malloc version. We also suspected that SRB2's
 ///        allocator was fragmenting badly. Finally, this version is a bit
 ///        simpler (about half the lines of code).
+///
+///        Every block keeps its bookkeeping inline, right in front of the
+///        memory handed out, and sits in a list of its own tag, so purging a
+///        tag only ever looks at the blocks that have it. Small PU_LEVEL and
+///        PU_CACHE blocks are bumped out of large arena chunks, which go back
+///        to the system as soon as everything in them has been freed.
 
 #include "doomdef.h"
 #include "doomstat.h"
@@ -51,6 +57,7 @@ static boolean Z_calloc = false;
 #endif
 
 struct memblock_s;
+struct zarenachunk_s;
 
 typedef struct
 {
@@ -61,12 +68,11 @@ typedef struct
 // Some code might want aligned memory. Assume it wants memory n bytes
 // aligned -- then we allocate n-1 extra bytes and return a pointer to
 // the first byte aligned as requested.
-// Thus, "real" is the pointer we get from malloc() and will free()
-// later, but "hdr" is where the memhdr_t starts.
-// For non-aligned allocations they will be the same.
+// The memblock_t lives at the very start of what we got from malloc() (or
+// from an arena or pool), and "hdr" is where the memhdr_t starts, right
+// before the memory given to the caller.
 typedef struct memblock_s
 {
-	void *real;
 	memhdr_t *hdr;
 
 	void **user;
@@ -75,6 +81,9 @@ typedef struct memblock_s
 	size_t size; // including the header and blocks
 	size_t realsize; // size of real data only
 
+	struct zpool_s *pool; // owning pool, or NULL if not from a pool
+	struct zarenachunk_s *chunk; // owning arena chunk, or NULL if not from an arena
+
 #ifdef ZDEBUG
 	const char *ownerfile;
 	INT32 ownerline;
@@ -83,13 +92,92 @@ typedef struct memblock_s
 	struct memblock_s *next, *prev;
 } ATTRPACK memblock_t;
 
-// both the head and tail of the zone memory block list
-static memblock_t head;
+// Blocks are kept in one list per tag. Tags past the last bucket
+// share it, so anything walking that bucket has to check the tag itself.
+#define NUMZONETAGS 128
+#define TAGBUCKET(tag) ((tag) <= 0 ? 0 : ((tag) >= NUMZONETAGS ? NUMZONETAGS - 1 : (tag)))
+
+typedef struct
+{
+	memblock_t head; // both the head and tail of the list
+	size_t bytes; // total size of all blocks, headers included
+	size_t realbytes; // total size requested by callers
+	size_t numblocks;
+} ztaglist_t;
+
+static ztaglist_t taglists[NUMZONETAGS];
+
+// Pool chunks are laid out as memblock_t, padding, memhdr_t, then the
+// object itself, so the object is always 16-byte aligned.
+#define POOLALIGN(x) (((x) + 15) & ~(size_t)15)
+#define POOLHDRSIZE POOLALIGN(sizeof (memblock_t) + sizeof (memhdr_t))
+
+typedef struct zpoolslab_s
+{
+	struct zpoolslab_s *next;
+} zpoolslab_t;
+
+struct zpool_s
+{
+	const char *name;
+	size_t size; // size of one object
+	size_t chunksize; // size of one object including its headers
+	size_t perslab; // objects per slab
+
+	zpoolslab_t *slabs;
+	size_t numslabs;
+	memblock_t *freelist; // linked through memblock_t next
+	size_t live; // objects currently allocated
+
+	struct zpool_s *next;
+};
+
+// all pools ever created
+static zpool_t *pools = NULL;
+
+// Arenas hand out blocks by bumping a pointer through big chunks. A block
+// freed from an arena only decrements its chunk's count; the chunk itself
+// is released (or rewound, if it's the one being bumped) once that hits 0.
+#define ARENACHUNKSIZE (256<<10)
+#define ARENAMAXBLOCK (ARENACHUNKSIZE>>4) // anything bigger is malloc'd on its own
+
+typedef struct zarenachunk_s
+{
+	struct zarena_s *arena;
+	struct zarenachunk_s *next, *prev;
+	size_t used; // bump offset from the start of the chunk
+	size_t live; // blocks still allocated from this chunk
+	size_t livebytes;
+} zarenachunk_t;
+
+#define ARENACHUNKHDR POOLALIGN(sizeof (zarenachunk_t))
+
+typedef struct zarena_s
+{
+	const char *name;
+	zarenachunk_t *current; // chunk being bumped, or NULL
+	zarenachunk_t *chunks; // all chunks, current included
+	size_t numchunks;
+} zarena_t;
+
+static zarena_t levelarena = {"Level", NULL, NULL, 0};
+static zarena_t cachearena = {"Locked cache", NULL, NULL, 0};
+
+static inline zarena_t *Z_ArenaForTag(INT32 tag)
+{
+	if (tag == PU_LEVEL)
+		return &levelarena;
+	if (tag == PU_CACHE)
+		return &cachearena;
+	return NULL;
+}
 
 //
 // Function prototypes
 //
 static void Command_Memfree_f(void);
+static void Command_Memstats_f(void);
+static void Z_ReleaseEmptyPools(void);
 #ifdef ZDEBUG
 static void Command_Memdump_f(void);
 #endif
@@ -106,16 +194,19 @@ static void Command_Memdump_f(void);
 void Z_Init(void)
 {
 	UINT32 total, memfree;
+	INT32 i;
 
-	memset(&head, 0x00, sizeof(head));
+	memset(taglists, 0x00, sizeof(taglists));
 
-	head.next = head.prev = &head;
+	for (i = 0; i < NUMZONETAGS; i++)
+		taglists[i].head.next = taglists[i].head.prev = &taglists[i].head;
 
 	memfree = I_GetFreeMem(&total)>>20;
 	CONS_Printf("System memory: %uMB - Free: %uMB\n", total>>20, memfree);
 
 	// Note: This allocates memory. Watch out.
 	COM_AddCommand("memfree", Command_Memfree_f);
+	COM_AddCommand("memstats", Command_Memstats_f);
 
 #ifdef ZDEBUG
 	COM_AddCommand("memdump", Command_Memdump_f);
@@ -127,6 +218,40 @@ void Z_Init(void)
 // Zone memory allocation
 // ----------------------
 
+/** Puts a block at the front of the list for its tag.
+  *
+  * \param block The block to link.
+  */
+static void Z_LinkBlock(memblock_t *block)
+{
+	ztaglist_t *list = &taglists[TAGBUCKET(block->tag)];
+
+	block->next = list->head.next;
+	block->prev = &list->head;
+	list->head.next = block;
+	block->next->prev = block;
+
+	list->bytes += block->size;
+	list->realbytes += block->realsize;
+	list->numblocks++;
+}
+
+/** Takes a block out of the list for its tag.
+  *
+  * \param block The block to unlink.
+  */
+static void Z_UnlinkBlock(memblock_t *block)
+{
+	ztaglist_t *list = &taglists[TAGBUCKET(block->tag)];
+
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+
+	list->bytes -= block->size;
+	list->realbytes -= block->realsize;
+	list->numblocks--;
+}
+
 /** Returns the corresponding memblock_t for a given memory block.
   *
   * \param ptr A pointer to allocated memory,
@@ -185,6 +310,38 @@ static memblock_t *Ptr2Memblock(void *ptr, const char* func)
 
 }
 
+/** Drops a block from the arena chunk it was bumped out of.
+  * Empty chunks are released, unless they're the chunk currently being
+  * bumped, in which case they're simply rewound.
+  *
+  * \param block The block being freed.
+  */
+static void Z_ArenaRelease(memblock_t *block)
+{
+	zarenachunk_t *chunk = block->chunk;
+	zarena_t *arena = chunk->arena;
+
+	chunk->livebytes -= block->size;
+	if (--chunk->live)
+		return;
+
+	if (chunk == arena->current)
+	{
+		chunk->used = ARENACHUNKHDR;
+		return;
+	}
+
+	if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	else
+		arena->chunks = chunk->next;
+	if (chunk->next)
+		chunk->next->prev = chunk->prev;
+
+	arena->numchunks--;
+	free(chunk);
+}
+
 /** Frees allocated memory.
   *
   * \param ptr A pointer to allocated memory,
@@ -229,13 +386,22 @@ void Z_Free(void *ptr)
 		*block->user = NULL;
 
 	// Free the memory and get rid of the block.
-	free(block->real);
 #ifdef VALGRIND_DESTROY_MEMPOOL
 	VALGRIND_DESTROY_MEMPOOL(block);
 #endif
-	block->prev->next = block->next;
-	block->next->prev = block->prev;
-	free(block);
+	Z_UnlinkBlock(block);
+
+	if (block->pool)
+	{
+		// Pool chunks just go back on their pool's free list.
+		block->next = block->pool->freelist;
+		block->pool->freelist = block;
+		block->pool->live--;
+	}
+	else if (block->chunk)
+		Z_ArenaRelease(block);
+	else
+		free(block);
 }
 
 /** malloc() that doesn't accept failure.
@@ -267,6 +433,47 @@ static void *xm(size_t size)
 	return p;
 }
 
+/** Bumps space for a block out of an arena, starting a new chunk if the
+  * current one is full.
+  *
+  * \param arena The arena to allocate from.
+  * \param size Amount of memory to be allocated, in bytes.
+  * \return A pointer to the allocated memory, and the chunk it came from.
+  */
+static void *Z_ArenaAlloc(zarena_t *arena, size_t size, zarenachunk_t **chunkp)
+{
+	zarenachunk_t *chunk = arena->current;
+	void *p;
+
+	size = POOLALIGN(size);
+
+	if (!chunk || chunk->used + size > ARENACHUNKSIZE)
+	{
+		// An empty current chunk is always rewound in Z_ArenaRelease,
+		// so the chunk we're moving on from is still in use.
+		chunk = xm(ARENACHUNKSIZE);
+		chunk->arena = arena;
+		chunk->used = ARENACHUNKHDR;
+		chunk->live = chunk->livebytes = 0;
+
+		chunk->prev = NULL;
+		chunk->next = arena->chunks;
+		if (arena->chunks)
+			arena->chunks->prev = chunk;
+		arena->chunks = chunk;
+		arena->numchunks++;
+
+		arena->current = chunk;
+	}
+
+	p = (UINT8 *)chunk + chunk->used;
+	chunk->used += size;
+	chunk->live++;
+
+	*chunkp = chunk;
+	return p;
+}
+
 /** The Z_MallocAlign function.
   * Allocates a block of memory, adds it to a linked list so we can keep track of it.
   *
@@ -289,10 +496,11 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	size_t extrabytes = (1<<alignbits) - 1;
 	size_t padsize = 0;
 	memblock_t *block;
-	void *ptr;
 	memhdr_t *hdr;
 	void *given;
-	size_t blocksize = extrabytes + sizeof *hdr + size;
+	zarena_t *arena = Z_ArenaForTag(tag);
+	zarenachunk_t *chunk = NULL;
+	size_t blocksize = sizeof *block + extrabytes + sizeof *hdr + size;
 
 #ifdef ZDEBUG2
 	CONS_Debug(DBG_MEMORY, "Z_Malloc %s:%d\n", file, line);
@@ -301,15 +509,19 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	if (blocksize < size)/* overflow check */
 		I_Error("You are allocating memory too large!");
 
-	block = xm(sizeof *block);
 #ifdef HAVE_VALGRIND
 	padsize += (1<<sizeof(size_t))*2;
+	arena = NULL; // keep every block separate so valgrind can see overruns
 #endif
-	ptr = xm(blocksize + padsize*2);
+
+	if (arena && blocksize <= ARENAMAXBLOCK)
+		block = Z_ArenaAlloc(arena, blocksize, &chunk);
+	else
+		block = xm(blocksize + padsize*2);
 
 	// This horrible calculation makes sure that "given" is aligned
 	// properly.
-	given = (void *)((size_t)((UINT8 *)ptr + extrabytes + sizeof *hdr + padsize/2)
+	given = (void *)((size_t)((UINT8 *)block + sizeof *block + extrabytes + sizeof *hdr + padsize/2)
 		& ~extrabytes);
 
 	// The mem header lives 'sizeof (memhdr_t)' bytes before given.
@@ -319,12 +531,6 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	Z_calloc = false;
 #endif
 
-	block->next = head.next;
-	block->prev = &head;
-	head.next = block;
-	block->next->prev = block;
-
-	block->real = ptr;
 	block->hdr = hdr;
 	block->tag = tag;
 	block->user = NULL;
@@ -332,8 +538,15 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	block->ownerline = line;
 	block->ownerfile = file;
 #endif
-	block->size = blocksize;
+	block->size = chunk ? POOLALIGN(blocksize) : blocksize;
 	block->realsize = size;
+	block->pool = NULL;
+	block->chunk = chunk;
+
+	if (chunk)
+		chunk->livebytes += block->size;
+
+	Z_LinkBlock(block);
 
 #ifdef VALGRIND_CREATE_MEMPOOL
 	VALGRIND_CREATE_MEMPOOL(block, padsize, Z_calloc);
@@ -390,6 +603,50 @@ void *Z_CallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 #endif
 }
 
+/** Tries to grow or shrink an arena block where it stands.
+  * That only works for the block most recently bumped out of its chunk,
+  * which is exactly the case for arrays that grow one element at a time.
+  *
+  * \param block The block to resize.
+  * \param ptr The memory given for the block.
+  * \param size New size of memory block, in bytes.
+  * \param tag New purge tag.
+  * \return true if the block was resized.
+  */
+static boolean Z_ArenaResize(memblock_t *block, void *ptr, size_t size, INT32 tag)
+{
+	zarenachunk_t *chunk = block->chunk;
+	size_t newsize;
+
+	if (!chunk || chunk != chunk->arena->current || Z_ArenaForTag(tag) != chunk->arena)
+		return false;
+
+	// Is it the last block bumped?
+	if ((UINT8 *)block + block->size != (UINT8 *)chunk + chunk->used)
+		return false;
+
+	newsize = POOLALIGN((size_t)((UINT8 *)ptr - (UINT8 *)block) + size);
+	if (newsize > ARENAMAXBLOCK || (size_t)((UINT8 *)block - (UINT8 *)chunk) + newsize > ARENACHUNKSIZE)
+		return false;
+
+	Z_UnlinkBlock(block);
+
+	chunk->used += newsize;
+	chunk->used -= block->size;
+	chunk->livebytes += newsize;
+	chunk->livebytes -= block->size;
+
+	if (size > block->realsize)
+		memset((UINT8 *)ptr + block->realsize, 0x00, size - block->realsize);
+
+	block->size = newsize;
+	block->realsize = size;
+	block->tag = tag;
+
+	Z_LinkBlock(block);
+	return true;
+}
+
 /** The Z_ReallocAlign function.
   * Reallocates a block of memory with a new size.
   *
@@ -444,6 +701,18 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 	if (block == NULL)
 		return NULL;
 
+	// Alignment only ever gets stricter by moving, so only try in place
+	// if the old block already satisfies it.
+	if (!((size_t)ptr & ((1<<alignbits) - 1)) && Z_ArenaResize(block, ptr, size, tag))
+	{
+		if (block->user && block->user != user)
+			*block->user = NULL;
+		block->user = (void **)user;
+		if (user)
+			*((void**)user) = ptr;
+		return ptr;
+	}
+
 #ifdef ZDEBUG
 	// Write every Z_Realloc call to a debug file.
 	DEBFILE(va("Z_Realloc at %s:%d\n", file, line));
@@ -476,7 +745,172 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 	return rez;
 }
 
+// -----------------------
+// Fixed-size object pools
+// -----------------------
+
+/** Creates a pool of fixed-size objects.
+  * The pool itself is never destroyed; only its slabs are.
+  *
+  * \param name Name of the pool, shown by the "memfree" command.
+  * \param size Size of each object, in bytes.
+  * \param perslab Number of objects to allocate at once when the pool runs dry.
+  * \return The new pool.
+  * \sa Z_PoolMalloc, Z_PoolCalloc
+  */
+zpool_t *Z_CreatePool(const char *name, size_t size, size_t perslab)
+{
+	zpool_t *pool = xm(sizeof *pool);
+
+	memset(pool, 0x00, sizeof *pool);
+
+	pool->name = name;
+	pool->size = size;
+	pool->chunksize = POOLHDRSIZE + POOLALIGN(size);
+	pool->perslab = max(perslab, 1);
+
+	pool->next = pools;
+	pools = pool;
+
+	return pool;
+}
+
+/** Allocates a new slab for a pool and puts all its chunks on the free list.
+  * Chunks are threaded in address order, so objects allocated in a row
+  * end up next to each other in memory.
+  *
+  * \param pool The pool to grow.
+  */
+static void Z_GrowPool(zpool_t *pool)
+{
+	const size_t slabhdr = POOLALIGN(sizeof (zpoolslab_t));
+	zpoolslab_t *slab;
+	UINT8 *chunk;
+	size_t i;
+
+	if ((SIZE_MAX - slabhdr) / pool->chunksize < pool->perslab) /* overflow check */
+		I_Error("You are allocating memory too large!");
+
+	slab = xm(slabhdr + pool->chunksize * pool->perslab);
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	pool->numslabs++;
+
+	chunk = (UINT8 *)slab + slabhdr + pool->chunksize * pool->perslab;
+	for (i = 0; i < pool->perslab; i++)
+	{
+		memblock_t *block;
+
+		chunk -= pool->chunksize;
+		block = (memblock_t *)chunk;
+		block->next = pool->freelist;
+		pool->freelist = block;
+	}
+}
+
+/** Allocates an object from a pool.
+  * The object is a regular zone block: it can be freed with Z_Free,
+  * retagged with Z_ChangeTag and purged with Z_FreeTags.
+  *
+  * \param pool The pool to allocate from.
+  * \param tag Purge tag.
+  * \param user The address of a pointer to the memory to be allocated.
+  * \return A pointer to the allocated object.
+  * \sa Z_PoolCalloc, Z_CreatePool
+  */
+void *Z_PoolMalloc(zpool_t *pool, INT32 tag, void *user)
+{
+	memblock_t *block;
+	memhdr_t *hdr;
+	void *given;
+
+	if (!pool->freelist)
+		Z_GrowPool(pool);
+
+	block = pool->freelist;
+	pool->freelist = block->next;
+	pool->live++;
+
+	given = (UINT8 *)block + POOLHDRSIZE;
+	hdr = (memhdr_t *)((UINT8 *)given - sizeof *hdr);
+
+	block->hdr = hdr;
+	block->tag = tag;
+	block->user = NULL;
+#ifdef ZDEBUG
+	block->ownerline = __LINE__;
+	block->ownerfile = __FILE__;
+#endif
+	block->size = pool->chunksize;
+	block->realsize = pool->size;
+	block->pool = pool;
+	block->chunk = NULL;
+
+	Z_LinkBlock(block);
+
+#ifdef VALGRIND_CREATE_MEMPOOL
+	VALGRIND_CREATE_MEMPOOL(block, 0, false);
+#endif
+
+	hdr->id = ZONEID;
+	hdr->block = block;
+
+#ifdef VALGRIND_MAKE_MEM_NOACCESS
+	VALGRIND_MAKE_MEM_NOACCESS(hdr, sizeof *hdr);
+#endif
+
+	if (user != NULL)
+	{
+		block->user = user;
+		*(void **)user = given;
+	}
+	else if (tag >= PU_PURGELEVEL)
+		I_Error("Z_PoolMalloc: attempted to allocate purgable block "
+			"(pool %s) with no user", pool->name);
+
+	return given;
+}
+
+/** Allocates an object from a pool, and initialises its bytes to zero.
+  *
+  * \param pool The pool to allocate from.
+  * \param tag Purge tag.
+  * \param user The address of a pointer to the memory to be allocated.
+  * \return A pointer to the allocated object.
+  * \sa Z_PoolMalloc, Z_CreatePool
+  */
+void *Z_PoolCalloc(zpool_t *pool, INT32 tag, void *user)
+{
+	return memset(Z_PoolMalloc(pool, tag, user), 0, pool->size);
+}
+
+/** Gives the slabs of every pool that has nothing allocated back to the system.
+  * Called after level purges, when pools for level objects are empty.
+  */
+static void Z_ReleaseEmptyPools(void)
+{
+	zpool_t *pool;
+	zpoolslab_t *slab, *next;
+
+	for (pool = pools; pool; pool = pool->next)
+	{
+		if (pool->live)
+			continue;
+
+		for (slab = pool->slabs; slab; slab = next)
+		{
+			next = slab->next;
+			free(slab);
+		}
+
+		pool->slabs = NULL;
+		pool->numslabs = 0;
+		pool->freelist = NULL;
+	}
+}
+
 /** Frees all memory for a given set of tags.
+  * Only the lists for those tags are walked.
   *
   * \param lowtag The lowest tag to consider.
   * \param hightag The highest tag to consider.
@@ -484,15 +918,25 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 void Z_FreeTags(INT32 lowtag, INT32 hightag)
 {
 	memblock_t *block, *next;
+	INT32 i;
 
 	Z_CheckHeap(420);
-	for (block = head.next; block != &head; block = next)
+	for (i = TAGBUCKET(lowtag); i <= TAGBUCKET(hightag); i++)
 	{
-		next = block->next; // get link before freeing
+		memblock_t *head = &taglists[i].head;
 
-		if (block->tag >= lowtag && block->tag <= hightag)
-			Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+		for (block = head->next; block != head; block = next)
+		{
+			next = block->next; // get link before freeing
+
+			if (block->tag >= lowtag && block->tag <= hightag)
+				Z_Free((UINT8 *)block->hdr + sizeof *block->hdr);
+		}
 	}
+
+	// Level objects are all gone, so their pools can let go of their slabs.
+	if (lowtag <= PU_LEVSPEC && hightag >= PU_LEVEL)
+		Z_ReleaseEmptyPools();
 }
 
 // -----------------
@@ -561,8 +1005,10 @@ void Z_CheckHeap(INT32 i)
 	memhdr_t *hdr;
 	UINT32 blocknumon = 0;
 	void *given;
+	INT32 bucket;
 
-	for (block = head.next; block != &head; block = block->next)
+	for (bucket = 0; bucket < NUMZONETAGS; bucket++)
+	for (block = taglists[bucket].head.next; block != &taglists[bucket].head; block = block->next)
 	{
 		blocknumon++;
 		hdr = block->hdr;
@@ -618,6 +1064,18 @@ void Z_CheckHeap(INT32 i)
 				" lacks proper forward link", i, blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
+#endif
+			       );
+		}
+		if (TAGBUCKET(block->tag) != bucket)
+		{
+			I_Error("Z_CheckHeap %d: block %u"
+#ifdef ZDEBUG
+				"(owned by %s:%d)"
+#endif
+				" is in the wrong tag list", i, blocknumon
+#ifdef ZDEBUG
+				, block->ownerfile, block->ownerline
 #endif
 			       );
 		}
@@ -708,7 +1166,11 @@ void Z_ChangeTag(void *ptr, INT32 tag)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
+	// Blocks from an arena stay where they are; their chunk can't be
+	// released before they're freed, whatever their tag is.
+	Z_UnlinkBlock(block);
 	block->tag = tag;
+	Z_LinkBlock(block);
 }
 
 /** Changes a memory block's user.
@@ -769,12 +1231,24 @@ size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 {
 	size_t cnt = 0;
 	memblock_t *rover;
+	INT32 i;
 
-	for (rover = head.next; rover != &head; rover = rover->next)
+	for (i = TAGBUCKET(lowtag); i <= TAGBUCKET(hightag); i++)
 	{
-		if (rover->tag < lowtag || rover->tag > hightag)
+		// The first and last buckets hold more than one tag, so those
+		// have to be checked block by block.
+		if (i > 0 && i < NUMZONETAGS - 1 && i >= lowtag && i <= hightag)
+		{
+			cnt += taglists[i].bytes;
 			continue;
-		cnt += rover->size + sizeof *rover;
+		}
+
+		for (rover = taglists[i].head.next; rover != &taglists[i].head; rover = rover->next)
+		{
+			if (rover->tag < lowtag || rover->tag > hightag)
+				continue;
+			cnt += rover->size;
+		}
 	}
 
 	return cnt;
@@ -803,6 +1277,17 @@ static void Command_Memfree_f(void)
 	CONS_Printf(M_GetText("All purgable      : %7s KB\n"),
 		sizeu1(Z_TagsUsage(PU_PURGELEVEL, INT32_MAX)>>10));
 
+	if (pools)
+	{
+		zpool_t *pool;
+
+		CONS_Printf("\x82%s", M_GetText("Object Pools\n"));
+		for (pool = pools; pool; pool = pool->next)
+			CONS_Printf(M_GetText("%-18s: %7s KB (%s/%s used)\n"), pool->name,
+				sizeu1((pool->numslabs * pool->perslab * pool->chunksize)>>10),
+				sizeu2(pool->live), sizeu3(pool->numslabs * pool->perslab));
+	}
+
 #ifdef HWRENDER
 	if (rendermode == render_opengl)
 	{
@@ -821,6 +1306,73 @@ static void Command_Memfree_f(void)
 	CONS_Printf(M_GetText("Available physical memory: %7u KB\n"), freebytes>>10);
 }
 
+/** Percentage of a capacity that isn't holding live data.
+  */
+static UINT32 Z_WastePercent(size_t live, size_t capacity)
+{
+	if (!capacity || live >= capacity)
+		return 0;
+	return (UINT32)(((capacity - live) * 100) / capacity);
+}
+
+/** The function called by the "memstats" console command.
+  * Prints the bytes and block count for every tag in use, and how much
+  * of each arena and pool is currently wasted.
+  */
+static void Command_Memstats_f(void)
+{
+	INT32 i;
+	size_t totalbytes = 0, totalreal = 0, totalblocks = 0;
+	zarena_t *arenas[2] = {&levelarena, &cachearena};
+	zpool_t *pool;
+
+	Z_CheckHeap(-1);
+	CONS_Printf("\x82%s", M_GetText("Memory by tag\n"));
+	CONS_Printf(M_GetText(" tag     blocks         KB    overhead KB\n"));
+	for (i = 0; i < NUMZONETAGS; i++)
+	{
+		const ztaglist_t *list = &taglists[i];
+
+		if (!list->numblocks)
+			continue;
+
+		CONS_Printf("%s%3d%s %10s %10s %10s\n", (i == NUMZONETAGS - 1) ? ">=" : "  ", i, "  ",
+			sizeu1(list->numblocks), sizeu2(list->bytes>>10), sizeu3((list->bytes - list->realbytes)>>10));
+
+		totalbytes += list->bytes;
+		totalreal += list->realbytes;
+		totalblocks += list->numblocks;
+	}
+	CONS_Printf(M_GetText("total   %10s %10s %10s\n"), sizeu1(totalblocks), sizeu2(totalbytes>>10), sizeu3((totalbytes - totalreal)>>10));
+
+	CONS_Printf("\x82%s", M_GetText("Arenas\n"));
+	for (i = 0; i < 2; i++)
+	{
+		zarenachunk_t *chunk;
+		size_t live = 0, capacity = arenas[i]->numchunks * ARENACHUNKSIZE;
+
+		for (chunk = arenas[i]->chunks; chunk; chunk = chunk->next)
+			live += chunk->livebytes;
+
+		CONS_Printf(M_GetText("%-18s: %s chunks, %s/%s KB live, %u%% fragmented\n"), arenas[i]->name,
+			sizeu1(arenas[i]->numchunks), sizeu2(live>>10), sizeu3(capacity>>10),
+			Z_WastePercent(live, capacity));
+	}
+
+	if (pools)
+	{
+		CONS_Printf("\x82%s", M_GetText("Object Pools\n"));
+		for (pool = pools; pool; pool = pool->next)
+		{
+			size_t capacity = pool->numslabs * pool->perslab;
+
+			CONS_Printf(M_GetText("%-18s: %s slabs, %s/%s objects, %u%% unused\n"), pool->name,
+				sizeu1(pool->numslabs), sizeu2(pool->live), sizeu3(capacity),
+				Z_WastePercent(pool->live, capacity));
+		}
+	}
+}
+
 #ifdef ZDEBUG
 /** The function called by the "memdump" console command.
   * Prints zone memory debugging information (i.e. tag, size, location in code allocated).
@@ -839,7 +1391,8 @@ static void Command_Memdump_f(void)
 	if ((i = COM_CheckParm("-max")))
 		maxtag = atoi(COM_Argv(i + 1));
 
-	for (block = head.next; block != &head; block = block->next)
+	for (i = TAGBUCKET(mintag); i <= TAGBUCKET(maxtag); i++)
+	for (block = taglists[i].head.next; block != &taglists[i].head; block = block->next)
 		if (block->tag >= mintag && block->tag <= maxtag)
 		{
 			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
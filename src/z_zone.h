@@ -101,6 +101,19 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 #define Z_Calloc(s,t,u)    Z_CallocAlign(s, t, u, 0)
 #define Z_Realloc(p,s,t,u) Z_ReallocAlign(p, s, t, u, 0)
 
+//
+// Fixed-size object pools
+//
+// Memory from a pool is carved out of large slabs instead of being malloc'd
+// per object. It behaves like any other zone block: free it with Z_Free, or
+// let Z_FreeTags purge it. Slabs are handed back to the system once every
+// object in the pool has been freed by a level purge.
+//
+typedef struct zpool_s zpool_t;
+zpool_t *Z_CreatePool(const char *name, size_t size, size_t perslab);
+void *Z_PoolMalloc(zpool_t *pool, INT32 tag, void *user);
+void *Z_PoolCalloc(zpool_t *pool, INT32 tag, void *user);
+
 // Free all memory by tag
 // these don't give line numbers for ZDEBUG currently though
 // (perhaps this should be changed in future?)